@@ -533,7 +533,7 @@ int target_exact_watchpoints = 0;
 
 struct breakpoint *breakpoint_chain;
 
-/* Array is sorted by bp_locations_compare - primarily by the ADDRESS.  */
+/* Array is sorted by bp_location_is_less_than - primarily by the ADDRESS.  */
 
 static struct bp_location **bp_locations;
 
@@ -618,20 +618,35 @@ set_breakpoint_count (int num)
    breakpoint count before "rbreak" creates any breakpoint.  */
 static int rbreak_start_breakpoint_count;
 
+/* True while an "rbreak" command is creating its breakpoints.
+   create_breakpoint then leaves updating the global location list to
+   the end of the command, so that the cost of creating N breakpoints
+   is not quadratic in N.  */
+static bool rbreak_in_progress;
+
+/* True if create_breakpoint skipped updating the global location
+   list because of RBREAK_IN_PROGRESS, and no update happened since.  */
+static bool global_location_list_update_deferred;
+
 /* Called at the start an "rbreak" command to record the first
    breakpoint made.  */
 
 scoped_rbreak_breakpoints::scoped_rbreak_breakpoints ()
 {
   rbreak_start_breakpoint_count = breakpoint_count;
+  rbreak_in_progress = true;
 }
 
 /* Called at the end of an "rbreak" command to record the last
-   breakpoint made.  */
+   breakpoint made, and to insert all the breakpoints made at
+   once.  */
 
 scoped_rbreak_breakpoints::~scoped_rbreak_breakpoints ()
 {
   prev_breakpoint_count = rbreak_start_breakpoint_count;
+  rbreak_in_progress = false;
+  if (global_location_list_update_deferred)
+    update_global_location_list_nothrow (UGLL_MAY_INSERT);
 }
 
 /* Used in run_command to zero the hit count when a new run starts.  */
@@ -787,7 +802,7 @@ show_condition_evaluation_mode (struct ui_file *file, int from_tty,
 
 /* A comparison function for bp_location AP and BP that is used by
    bsearch.  This comparison function only cares about addresses, unlike
-   the more general bp_locations_compare function.  */
+   the more general bp_location_is_less_than function.  */
 
 static int
 bp_locations_compare_addrs (const void *ap, const void *bp)
@@ -9411,7 +9426,10 @@ create_breakpoint (struct gdbarch *gdbarch,
   discard_cleanups (bkpt_chain);
 
   /* error call may happen here - have BKPT_CHAIN already discarded.  */
-  update_global_location_list (UGLL_MAY_INSERT);
+  if (rbreak_in_progress)
+    global_location_list_update_deferred = true;
+  else
+    update_global_location_list (UGLL_MAY_INSERT);
 
   return 1;
 }
@@ -11557,43 +11575,118 @@ breakpoint_auto_delete (bpstat bs)
   }
 }
 
-/* A comparison function for bp_location AP and BP being interfaced to
-   qsort.  Sort elements primarily by their ADDRESS (no matter what
-   does breakpoint_address_is_meaningful say for its OWNER),
-   secondarily by ordering first permanent elements and
-   terciarily just ensuring the array is sorted stable way despite
-   qsort being an unstable algorithm.  */
+/* A comparison function for bp_location A and B being interfaced to
+   std::sort and std::inplace_merge.  Sort elements primarily by their
+   ADDRESS (no matter what does breakpoint_address_is_meaningful say
+   for its OWNER), secondarily by ordering first permanent elements
+   and terciarily just ensuring the array is sorted in a way that is
+   stable across GDB runs.  */
 
-static int
-bp_locations_compare (const void *ap, const void *bp)
+static bool
+bp_location_is_less_than (const bp_location *a, const bp_location *b)
 {
-  const struct bp_location *a = *(const struct bp_location **) ap;
-  const struct bp_location *b = *(const struct bp_location **) bp;
-
   if (a->address != b->address)
-    return (a->address > b->address) - (a->address < b->address);
+    return a->address < b->address;
 
   /* Sort locations at the same address by their pspace number, keeping
      locations of the same inferior (in a multi-inferior environment)
      grouped.  */
 
   if (a->pspace->num != b->pspace->num)
-    return ((a->pspace->num > b->pspace->num)
-	    - (a->pspace->num < b->pspace->num));
+    return a->pspace->num < b->pspace->num;
 
   /* Sort permanent breakpoints first.  */
   if (a->permanent != b->permanent)
-    return (a->permanent < b->permanent) - (a->permanent > b->permanent);
+    return a->permanent > b->permanent;
 
   /* Make the internal GDB representation stable across GDB runs
      where A and B memory inside GDB can differ.  Breakpoint locations of
      the same type at the same address can be sorted in arbitrary order.  */
 
   if (a->owner->number != b->owner->number)
-    return ((a->owner->number > b->owner->number)
-	    - (a->owner->number < b->owner->number));
+    return a->owner->number < b->owner->number;
+
+  return a < b;
+}
+
+/* The last value used for bp_location::global_list_mark.  */
+
+static unsigned int bp_locations_last_mark;
+
+/* Set bp_locations and bp_locations_count to the sorted array of the
+   locations of all breakpoints.  OLD_LOCATIONS is the former, sorted,
+   content of bp_locations, of OLD_LOCATIONS_COUNT elements.
+
+   Most callers only added or removed a handful of locations since the
+   last call, so rather than sorting every location again, we keep
+   what is left of OLD_LOCATIONS, sort just the locations that are not
+   in it and merge both.  This makes the cost of each call linear in
+   the number of locations.  If some location kept from OLD_LOCATIONS
+   had its sort key changed in place, we fall back to sorting the
+   whole array.  */
+
+static void
+bp_locations_rebuild (struct bp_location **old_locations,
+		      unsigned old_locations_count)
+{
+  struct breakpoint *b;
+  struct bp_location *loc, **locp, **new_locp;
+  unsigned int chain_mark, old_mark;
+  unsigned count = 0;
+  bool old_sorted = true;
+
+  /* Start over once the marks wrap around, so that a location left
+     with a stale mark can never be mistaken for a marked one.  */
+  if (bp_locations_last_mark > UINT_MAX - 2)
+    {
+      ALL_BREAKPOINTS (b)
+	for (loc = b->loc; loc; loc = loc->next)
+	  loc->global_list_mark = 0;
+      bp_locations_last_mark = 0;
+    }
+  chain_mark = ++bp_locations_last_mark;
+  old_mark = ++bp_locations_last_mark;
 
-  return (a > b) - (a < b);
+  ALL_BREAKPOINTS (b)
+    for (loc = b->loc; loc; loc = loc->next)
+      {
+	loc->global_list_mark = chain_mark;
+	count++;
+      }
+
+  bp_locations = XNEWVEC (struct bp_location *, count);
+  bp_locations_count = count;
+
+  /* Keep the former locations still in the chain, in their order.  */
+  locp = bp_locations;
+  for (unsigned ix = 0; ix < old_locations_count; ix++)
+    {
+      loc = old_locations[ix];
+      if (loc->global_list_mark != chain_mark)
+	continue;
+
+      if (locp > bp_locations && !bp_location_is_less_than (locp[-1], loc))
+	old_sorted = false;
+      loc->global_list_mark = old_mark;
+      *locp++ = loc;
+    }
+
+  /* Append the new ones.  */
+  new_locp = locp;
+  ALL_BREAKPOINTS (b)
+    for (loc = b->loc; loc; loc = loc->next)
+      if (loc->global_list_mark != old_mark)
+	*locp++ = loc;
+  gdb_assert (locp == bp_locations + bp_locations_count);
+
+  if (old_sorted)
+    {
+      std::sort (new_locp, locp, bp_location_is_less_than);
+      std::inplace_merge (bp_locations, new_locp, locp,
+			  bp_location_is_less_than);
+    }
+  else
+    std::sort (bp_locations, locp, bp_location_is_less_than);
 }
 
 /* Set bp_locations_placed_address_before_address_max and
@@ -11798,18 +11891,9 @@ update_global_location_list (enum ugll_insert_mode insert_mode)
   old_locations_count = bp_locations_count;
   bp_locations = NULL;
   bp_locations_count = 0;
+  global_location_list_update_deferred = false;
 
-  ALL_BREAKPOINTS (b)
-    for (loc = b->loc; loc; loc = loc->next)
-      bp_locations_count++;
-
-  bp_locations = XNEWVEC (struct bp_location *, bp_locations_count);
-  locp = bp_locations;
-  ALL_BREAKPOINTS (b)
-    for (loc = b->loc; loc; loc = loc->next)
-      *locp++ = loc;
-  qsort (bp_locations, bp_locations_count, sizeof (*bp_locations),
-	 bp_locations_compare);
+  bp_locations_rebuild (old_locations.get (), old_locations_count);
 
   bp_locations_target_extensions_update ();
 
@@ -474,6 +474,11 @@ public:
      it becomes 0 this location is retired.  */
   int events_till_retirement = 0;
 
+  /* Scratch mark used by update_global_location_list to tell, without
+     searching, whether this location is in the breakpoint chain and
+     in the former bp_locations array.  */
+  unsigned int global_list_mark = 0;
+
   /* Line number which was used to place this location.
 
      Breakpoint placed into a comment keeps it's user specified line number
@@ -542,14 +542,15 @@ ftrace_new_gap (struct btrace_thread_info *btinfo, int errcode,
 }
 
 /* Update the current function segment at the end of the trace in BTINFO with
-   respect to the instruction at PC.  This may create new function segments.
-   Return the chronologically latest function segment, never NULL.  */
+   respect to the instruction at PC.  MFUN is the minimal symbol of PC, as
+   found by lookup_minimal_symbol_by_pc.  This may create new function
+   segments.  Return the chronologically latest function segment, never
+   NULL.  */
 
 static struct btrace_function *
-ftrace_update_function (struct btrace_thread_info *btinfo, CORE_ADDR pc)
+ftrace_update_function (struct btrace_thread_info *btinfo, CORE_ADDR pc,
+			struct minimal_symbol *mfun)
 {
-  struct bound_minimal_symbol bmfun;
-  struct minimal_symbol *mfun;
   struct symbol *fun;
   struct btrace_function *bfun;
 
@@ -557,8 +558,6 @@ ftrace_update_function (struct btrace_thread_info *btinfo, CORE_ADDR pc)
      to avoid surprises when we sometimes get a full symbol and sometimes
      only a minimal symbol.  */
   fun = find_pc_function (pc);
-  bmfun = lookup_minimal_symbol_by_pc (pc);
-  mfun = bmfun.minsym;
 
   if (fun == NULL && mfun == NULL)
     DEBUG_FTRACE ("no symbol at %s", core_addr_to_string_nz (pc));
@@ -1052,42 +1051,37 @@ btrace_compute_ftrace_bts (struct thread_info *tp,
   else
     level = -btinfo->level;
 
+  /* The instructions of the current block, and their minimal symbols.  */
+  std::vector<CORE_ADDR> pcs;
+  std::vector<int> sizes;
+  std::vector<bound_minimal_symbol> msyms;
+
   while (blk != 0)
     {
       btrace_block_s *block;
       CORE_ADDR pc;
+      bool overflow = false;
 
       blk -= 1;
 
       block = VEC_index (btrace_block_s, btrace->blocks, blk);
       pc = block->begin;
 
+      /* Find the instructions of the block first, so that we can look up
+	 their minimal symbols all at once.  */
+      pcs.clear ();
+      sizes.clear ();
       for (;;)
 	{
-	  struct btrace_function *bfun;
-	  struct btrace_insn insn;
 	  int size;
 
-	  /* We should hit the end of the block.  Warn if we went too far.  */
+	  /* We should hit the end of the block.  Note if we went too far.  */
 	  if (block->end < pc)
 	    {
-	      /* Indicate the gap in the trace.  */
-	      bfun = ftrace_new_gap (btinfo, BDE_BTS_OVERFLOW, gaps);
-
-	      warning (_("Recorded trace may be corrupted at instruction "
-			 "%u (pc = %s)."), bfun->insn_offset - 1,
-		       core_addr_to_string_nz (pc));
-
+	      overflow = true;
 	      break;
 	    }
 
-	  bfun = ftrace_update_function (btinfo, pc);
-
-	  /* Maintain the function level offset.
-	     For all but the last block, we do it here.  */
-	  if (blk != 0)
-	    level = std::min (level, bfun->level);
-
 	  size = 0;
 	  TRY
 	    {
@@ -1098,32 +1092,38 @@ btrace_compute_ftrace_bts (struct thread_info *tp,
 	    }
 	  END_CATCH
 
-	  insn.pc = pc;
-	  insn.size = size;
-	  insn.iclass = ftrace_classify_insn (gdbarch, pc);
-	  insn.flags = 0;
+	  pcs.push_back (pc);
+	  sizes.push_back (size);
 
-	  ftrace_update_insns (bfun, insn);
-
-	  /* We're done once we pushed the instruction at the end.  */
-	  if (block->end == pc)
+	  /* We're done once we found the instruction at the end.  We can't
+	     continue if we fail to compute the size.  */
+	  if (block->end == pc || size <= 0)
 	    break;
 
-	  /* We can't continue if we fail to compute the size.  */
-	  if (size <= 0)
-	    {
-	      /* Indicate the gap in the trace.  We just added INSN so we're
-		 not at the beginning.  */
-	      bfun = ftrace_new_gap (btinfo, BDE_BTS_INSN_SIZE, gaps);
+	  pc += size;
+	}
 
-	      warning (_("Recorded trace may be incomplete at instruction %u "
-			 "(pc = %s)."), bfun->insn_offset - 1,
-		       core_addr_to_string_nz (pc));
+      msyms.resize (pcs.size ());
+      lookup_minimal_symbols_by_pc (pcs, msyms);
 
-	      break;
-	    }
+      for (size_t i = 0; i < pcs.size (); ++i)
+	{
+	  struct btrace_function *bfun;
+	  struct btrace_insn insn;
 
-	  pc += size;
+	  bfun = ftrace_update_function (btinfo, pcs[i], msyms[i].minsym);
+
+	  /* Maintain the function level offset.
+	     For all but the last block, we do it here.  */
+	  if (blk != 0)
+	    level = std::min (level, bfun->level);
+
+	  insn.pc = pcs[i];
+	  insn.size = sizes[i];
+	  insn.iclass = ftrace_classify_insn (gdbarch, pcs[i]);
+	  insn.flags = 0;
+
+	  ftrace_update_insns (bfun, insn);
 
 	  /* Maintain the function level offset.
 	     For the last block, we do it here to not consider the last
@@ -1131,9 +1131,31 @@ btrace_compute_ftrace_bts (struct thread_info *tp,
 	     Since the last instruction corresponds to the current instruction
 	     and is not really part of the execution history, it shouldn't
 	     affect the level.  */
-	  if (blk == 0)
+	  if (blk == 0 && (i + 1 < pcs.size () || overflow))
 	    level = std::min (level, bfun->level);
 	}
+
+      if (overflow)
+	{
+	  /* Indicate the gap in the trace.  */
+	  struct btrace_function *bfun
+	    = ftrace_new_gap (btinfo, BDE_BTS_OVERFLOW, gaps);
+
+	  warning (_("Recorded trace may be corrupted at instruction "
+		     "%u (pc = %s)."), bfun->insn_offset - 1,
+		   core_addr_to_string_nz (pc));
+	}
+      else if (pc != block->end)
+	{
+	  /* Indicate the gap in the trace.  We just added the instruction
+	     at PC so we're not at the beginning.  */
+	  struct btrace_function *bfun
+	    = ftrace_new_gap (btinfo, BDE_BTS_INSN_SIZE, gaps);
+
+	  warning (_("Recorded trace may be incomplete at instruction %u "
+		     "(pc = %s)."), bfun->insn_offset - 1,
+		   core_addr_to_string_nz (pc));
+	}
     }
 
   /* LEVEL is the minimal function level of all btrace function segments.
@@ -1323,7 +1345,8 @@ ftrace_add_pt (struct btrace_thread_info *btinfo,
 	  /* Handle events indicated by flags in INSN.  */
 	  handle_pt_insn_event_flags (btinfo, decoder, insn, gaps);
 
-	  bfun = ftrace_update_function (btinfo, insn.ip);
+	  bfun = ftrace_update_function
+	    (btinfo, insn.ip, lookup_minimal_symbol_by_pc (insn.ip).minsym);
 
 	  /* Maintain the function level offset.  */
 	  *plevel = std::min (*plevel, bfun->level);
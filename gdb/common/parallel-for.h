@@ -0,0 +1,105 @@
+/* Parallel for loops
+
+   Copyright (C) 2018 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef COMMON_PARALLEL_FOR_H
+#define COMMON_PARALLEL_FOR_H
+
+#include "config.h"
+
+#if CXX_STD_THREAD
+#include <atomic>
+#include <signal.h>
+#include <system_error>
+#include <thread>
+#include <vector>
+#endif
+
+namespace gdb
+{
+
+/* Call CALLBACK with each index in [0, N), using at most N_THREADS
+   threads, the calling thread included.  The indices are handed out
+   in increasing order, but the calls may run concurrently and finish
+   in any order.  This returns once all the calls are done.
+
+   CALLBACK must not throw, and may only touch state which no other
+   call touches at the same time.  In particular, most of GDB may only
+   be used from the main thread.
+
+   The worker threads run with all signals blocked, so that signals
+   are still delivered to the main thread.  If threads are not
+   available, or cannot be created, the calls are all made by the
+   calling thread.  */
+
+template<typename Callback>
+void
+parallel_for (unsigned int n_threads, size_t n, Callback callback)
+{
+#if CXX_STD_THREAD
+  if (n_threads > n)
+    n_threads = n;
+
+  if (n_threads > 1)
+    {
+      std::atomic<size_t> next (0);
+      auto worker = [&] ()
+	{
+	  for (size_t i = next++; i < n; i = next++)
+	    callback (i);
+	};
+
+      std::vector<std::thread> threads;
+      threads.reserve (n_threads - 1);
+
+#if HAVE_SIGPROCMASK
+      sigset_t blocked, old_mask;
+
+      sigfillset (&blocked);
+      sigprocmask (SIG_BLOCK, &blocked, &old_mask);
+#endif
+
+      try
+	{
+	  for (unsigned int i = 1; i < n_threads; ++i)
+	    threads.emplace_back (worker);
+	}
+      catch (const std::system_error &)
+	{
+	  /* Make do with the threads we have.  */
+	}
+
+#if HAVE_SIGPROCMASK
+      sigprocmask (SIG_SETMASK, &old_mask, NULL);
+#endif
+
+      worker ();
+
+      for (std::thread &thread : threads)
+	thread.join ();
+      return;
+    }
+#endif
+
+  for (size_t i = 0; i < n; ++i)
+    callback (i);
+}
+
+}
+
+#endif /* COMMON_PARALLEL_FOR_H */
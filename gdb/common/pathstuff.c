@@ -158,3 +158,27 @@ contains_dir_separator (const char *path)
 
   return false;
 }
+
+/* See common/pathstuff.h.  */
+
+std::string
+get_standard_cache_dir ()
+{
+  const char *xdg_cache_home = getenv ("XDG_CACHE_HOME");
+  if (xdg_cache_home != NULL && xdg_cache_home[0] != '\0')
+    {
+      /* Make sure the path is absolute and tilde-expanded.  */
+      gdb::unique_xmalloc_ptr<char> abs (gdb_abspath (xdg_cache_home));
+      return string_printf ("%s" SLASH_STRING "gdb", abs.get ());
+    }
+
+  const char *home = getenv ("HOME");
+  if (home != NULL && home[0] != '\0')
+    {
+      gdb::unique_xmalloc_ptr<char> abs (gdb_abspath (home));
+      return string_printf ("%s" SLASH_STRING ".cache" SLASH_STRING "gdb",
+			    abs.get ());
+    }
+
+  return {};
+}
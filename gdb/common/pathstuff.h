@@ -50,4 +50,11 @@ extern gdb::unique_xmalloc_ptr<char> gdb_abspath (const char *path);
 
 extern bool contains_dir_separator (const char *path);
 
+/* Return the path to the directory where GDB should store files
+   which can be recreated, such as the index cache: $XDG_CACHE_HOME/gdb
+   or, if XDG_CACHE_HOME is not set, $HOME/.cache/gdb.  Return an
+   empty string if neither variable is set.  */
+
+extern std::string get_standard_cache_dir ();
+
 #endif /* PATHSTUFF_H */
@@ -20,6 +20,8 @@
 #ifndef PTID_H
 #define PTID_H
 
+#include <functional>
+
 /* The ptid struct is a collection of the various "ids" necessary for
    identifying the inferior process/thread being debugged.  This
    consists of the process id (pid), lightweight process id (lwp) and
@@ -143,6 +145,21 @@ private:
   long m_tid;
 };
 
+/* Functor to hash a ptid, e.g. to use it as the key of a
+   std::unordered_map.  */
+
+struct hash_ptid
+{
+  size_t operator() (const ptid_t &ptid) const
+  {
+    std::hash<long> long_hash;
+
+    return (long_hash (ptid.pid ())
+	    + long_hash (ptid.lwp ())
+	    + long_hash (ptid.tid ()));
+  }
+};
+
 /* The null or zero ptid, often used to indicate no process. */
 
 extern ptid_t null_ptid;
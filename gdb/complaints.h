@@ -25,6 +25,11 @@
    particular category.  */
 struct complaints;
 
+/* The maximum number of complaints of each category to print; see
+   "set complaints".  Complaints are not printed at all if this is
+   zero.  */
+extern int stop_whining;
+
 /* Helper for complaint.  */
 extern void complaint_internal (const char *fmt, ...)
   ATTRIBUTE_PRINTF (1, 2);
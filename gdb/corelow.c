@@ -45,6 +45,13 @@
 #include "gdb_bfd.h"
 #include "completer.h"
 #include "filestuff.h"
+#include <algorithm>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#ifndef MAP_FAILED
+#define MAP_FAILED ((void *) -1)
+#endif
+#endif
 
 #ifndef O_LARGEFILE
 #define O_LARGEFILE 0
@@ -121,6 +128,23 @@ private: /* per-core data */
      targets.  */
   target_section_table m_core_section_table {};
 
+  /* True if the sections of M_CORE_SECTION_TABLE are sorted by
+     address and do not overlap, so the one holding an address can be
+     found by binary search.  A core of a process with thousands of
+     threads has thousands of sections.  */
+  bool m_core_sections_sorted = false;
+
+  /* The core file mapped in memory, or NULL if it could not be
+     mapped or was opened for writing.  Reading memory from the map
+     avoids a seek and a read system call for each access.  */
+  gdb_byte *m_core_map = NULL;
+
+  /* The size of the part of the core file M_CORE_MAP holds, and the
+     address and length actually mapped.  */
+  bfd_size_type m_core_map_size = 0;
+  void *m_core_map_addr = NULL;
+  bfd_size_type m_core_map_len = 0;
+
   /* The core_fns for a core file handler that is prepared to read the
      core file currently open on core_bfd.  */
   core_fns *m_core_vec = NULL;
@@ -145,10 +169,48 @@ core_target::core_target ()
 			   &m_core_section_table.sections_end))
     error (_("\"%s\": Can't find sections: %s"),
 	   bfd_get_filename (core_bfd), bfd_errmsg (bfd_get_error ()));
+
+  m_core_sections_sorted = true;
+  for (target_section *p = m_core_section_table.sections + 1;
+       p < m_core_section_table.sections_end;
+       p++)
+    if (p->addr < p[-1].endaddr)
+      {
+	m_core_sections_sorted = false;
+	break;
+      }
+
+#ifdef HAVE_MMAP
+  /* Map the whole file; on failure, e.g. if the address space is too
+     small to hold it, memory is read through BFD.  Don't map a core
+     file opened with "set write on": writes go through BFD, and a
+     private map would keep returning the old contents.  */
+  ufile_ptr size = write_files ? 0 : bfd_get_file_size (core_bfd);
+  if (size != 0)
+    {
+      void *map = bfd_mmap (core_bfd, NULL, size, PROT_READ, MAP_PRIVATE,
+			    0, &m_core_map_addr, &m_core_map_len);
+
+      if (map != MAP_FAILED)
+	{
+	  m_core_map = (gdb_byte *) map;
+	  m_core_map_size = size;
+	}
+      else
+	{
+	  m_core_map_addr = NULL;
+	  m_core_map_len = 0;
+	}
+    }
+#endif
 }
 
 core_target::~core_target ()
 {
+#ifdef HAVE_MMAP
+  if (m_core_map_addr != NULL)
+    munmap (m_core_map_addr, m_core_map_len);
+#endif
   xfree (m_core_section_table.sections);
 }
 
@@ -752,6 +814,47 @@ core_target::xfer_partial (enum target_object object, const char *annex,
   switch (object)
     {
     case TARGET_OBJECT_MEMORY:
+      if (m_core_sections_sorted)
+	{
+	  /* Only the last section starting at or before OFFSET can
+	     hold it.  */
+	  target_section *p
+	    = std::upper_bound (m_core_section_table.sections,
+				m_core_section_table.sections_end, offset,
+				[] (ULONGEST addr, const target_section &sect)
+				{
+				  return addr < sect.addr;
+				});
+
+	  if (p == m_core_section_table.sections)
+	    return TARGET_XFER_EOF;
+
+	  /* Copy the contents straight out of the mapped file when
+	     they are all there.  Anything else, e.g. a section without
+	     contents, which reads as zeros, is left to BFD.  */
+	  const target_section *sect = p - 1;
+	  asection *asect = sect->the_bfd_section;
+	  if (readbuf != NULL
+	      && m_core_map != NULL
+	      && offset < sect->endaddr
+	      && (bfd_get_section_flags (core_bfd, asect) & SEC_HAS_CONTENTS))
+	    {
+	      ULONGEST n = std::min (len, sect->endaddr - offset);
+	      ULONGEST pos = asect->filepos + (offset - sect->addr);
+
+	      if (pos <= m_core_map_size && n <= m_core_map_size - pos)
+		{
+		  memcpy (readbuf, m_core_map + pos, n);
+		  *xfered_len = n;
+		  return TARGET_XFER_OK;
+		}
+	    }
+
+	  return section_table_xfer_memory_partial (readbuf, writebuf,
+						    offset, len, xfered_len,
+						    p - 1, p, NULL);
+	}
+
       return (section_table_xfer_memory_partial
 	      (readbuf, writebuf,
 	       offset, len, xfered_len,
@@ -23,7 +23,9 @@
 #include "gdbcore.h"
 #include "target-dcache.h"
 #include "inferior.h"
-#include "splay-tree.h"
+#include "gdbthread.h"
+#include "common/byte-vector.h"
+#include <algorithm>
 
 /* Commands with a prefix of `{set,show} dcache'.  */
 static struct cmd_list_element *dcache_set_list = NULL;
@@ -42,14 +44,22 @@ static struct cmd_list_element *dcache_show_list = NULL;
    significantly.  This is most useful when accessing a large amount
    of data, such as when performing a backtrace.
 
-   The cache is a splay tree along with a linked list for replacement.
-   Each block caches a LINE_SIZE area of memory.  Within each line we
-   remember the address of the line (which must be a multiple of
-   LINE_SIZE) and the actual data block.
+   The cache is set-associative: the address of a line selects one
+   set of DCACHE_WAYS lines, which is searched linearly and evicts its
+   least recently used line.  Each block caches a LINE_SIZE area of
+   memory.  Within each line we remember the address of the line
+   (which must be a multiple of LINE_SIZE) and the actual data block.
 
    Lines are only allocated as needed, so DCACHE_SIZE really specifies the
    *maximum* number of lines in the cache.
 
+   When lines are missing, the cache reads all the missing lines the
+   request covers with a single target read.  When misses follow each
+   other sequentially through memory, it also reads ahead, doubling
+   the number of lines read each time up to DCACHE_MAX_FILL_LINES.
+   This matters most for remote targets, where each read is a round
+   trip.
+
    At present, the cache is write-through rather than writeback: as soon
    as data is written to the cache, it is also immediately written to
    the target.  Therefore, cache lines are never "dirty".  Whether a given
@@ -82,6 +92,15 @@ static unsigned dcache_size = DCACHE_DEFAULT_SIZE;
 #define DCACHE_DEFAULT_LINE_SIZE 64
 static unsigned dcache_line_size = DCACHE_DEFAULT_LINE_SIZE;
 
+/* The number of lines in each set.  */
+#define DCACHE_WAYS 4
+
+/* The maximum number of lines read with a single target read.  */
+#define DCACHE_MAX_FILL_LINES 16
+
+/* Whether to read ahead when memory is read sequentially.  */
+static int dcache_prefetch_p = 1;
+
 /* Each cache block holds LINE_SIZE bytes of data
    starting at a multiple-of-LINE_SIZE address.  */
 
@@ -91,8 +110,7 @@ static unsigned dcache_line_size = DCACHE_DEFAULT_LINE_SIZE;
 
 struct dcache_block
 {
-  /* For least-recently-allocated and free lists.  */
-  struct dcache_block *prev;
+  /* For the free list.  */
   struct dcache_block *next;
 
   CORE_ADDR addr;		/* address of data */
@@ -102,11 +120,15 @@ struct dcache_block
 
 struct dcache_struct
 {
-  splay_tree tree;
-  struct dcache_block *oldest; /* least-recently-allocated list.  */
+  /* The lines of the cache, DCACHE_WAYS per set.  Each set is ordered
+     from the most to the least recently used line, followed by the
+     unused slots, which are NULL.  */
+  struct dcache_block **lines;
+
+  /* The number of sets in LINES.  */
+  unsigned n_sets;
 
-  /* The free list is maintained identically to OLDEST to simplify
-     the code: we only need one set of accessors.  */
+  /* Blocks not in use, chained through their NEXT field.  */
   struct dcache_block *freelist;
 
   /* The number of in-use lines in the cache.  */
@@ -115,9 +137,21 @@ struct dcache_struct
 
   /* The ptid of last inferior to use cache or null_ptid.  */
   ptid_t ptid;
-};
 
-typedef void (block_func) (struct dcache_block *block, void *param);
+  /* The address just past the last lines read from the target, and
+     how many lines were read then.  See dcache_fill.  */
+  CORE_ADDR next_fill_addr;
+  unsigned fill_lines;
+
+  /* Statistics for "info dcache", since the cache was last
+     invalidated: the number of lines read requests found and did not
+     find in the cache, the number of lines read from the target, and
+     the number of target reads that took.  */
+  ULONGEST hits;
+  ULONGEST misses;
+  ULONGEST lines_read;
+  ULONGEST target_reads;
+};
 
 static struct dcache_block *dcache_hit (DCACHE *dcache, CORE_ADDR addr);
 
@@ -134,83 +168,52 @@ show_dcache_enabled_p (struct ui_file *file, int from_tty,
   fprintf_filtered (file, _("Deprecated remotecache flag is %s.\n"), value);
 }
 
-/* Add BLOCK to circular block list BLIST, behind the block at *BLIST.
-   *BLIST is not updated (unless it was previously NULL of course).
-   This is for the least-recently-allocated list's sake:
-   BLIST points to the oldest block.
-   ??? This makes for poor cache usage of the free list,
-   but is it measurable?  */
+/* Return the number of sets needed to hold DCACHE_SIZE lines.  */
 
-static void
-append_block (struct dcache_block **blist, struct dcache_block *block)
+static unsigned
+dcache_n_sets (void)
 {
-  if (*blist)
-    {
-      block->next = *blist;
-      block->prev = (*blist)->prev;
-      block->prev->next = block;
-      (*blist)->prev = block;
-      /* We don't update *BLIST here to maintain the invariant that for the
-	 least-recently-allocated list *BLIST points to the oldest block.  */
-    }
-  else
-    {
-      block->next = block;
-      block->prev = block;
-      *blist = block;
-    }
+  return (dcache_size + DCACHE_WAYS - 1) / DCACHE_WAYS;
 }
 
-/* Remove BLOCK from circular block list BLIST.  */
+/* Return the first slot of the set the line of ADDR belongs to.  */
 
-static void
-remove_block (struct dcache_block **blist, struct dcache_block *block)
+static struct dcache_block **
+dcache_set (DCACHE *dcache, CORE_ADDR addr)
 {
-  if (block->next == block)
-    {
-      *blist = NULL;
-    }
-  else
-    {
-      block->next->prev = block->prev;
-      block->prev->next = block->next;
-      /* If we removed the block *BLIST points to, shift it to the next block
-	 to maintain the invariant that for the least-recently-allocated list
-	 *BLIST points to the oldest block.  */
-      if (*blist == block)
-	*blist = block->next;
-    }
+  ULONGEST index = (addr / dcache->line_size) % dcache->n_sets;
+
+  return &dcache->lines[index * DCACHE_WAYS];
 }
 
-/* Iterate over all elements in BLIST, calling FUNC.
-   PARAM is passed to FUNC.
-   FUNC may remove the block it's passed, but only that block.  */
+/* Return the slot holding the line of ADDR, or NULL if that line is
+   not in the cache.  */
 
-static void
-for_each_block (struct dcache_block **blist, block_func *func, void *param)
+static struct dcache_block **
+dcache_lookup (DCACHE *dcache, CORE_ADDR addr)
 {
-  struct dcache_block *db;
-
-  if (*blist == NULL)
-    return;
+  struct dcache_block **set = dcache_set (dcache, addr);
+  CORE_ADDR line = MASK (dcache, addr);
 
-  db = *blist;
-  do
-    {
-      struct dcache_block *next = db->next;
+  for (int i = 0; i < DCACHE_WAYS && set[i] != NULL; i++)
+    if (set[i]->addr == line)
+      return &set[i];
 
-      func (db, param);
-      db = next;
-    }
-  while (*blist && db != *blist);
+  return NULL;
 }
 
-/* BLOCK_FUNC routine for dcache_free.  */
+/* Free the blocks of the free list of DCACHE.  */
 
 static void
-free_block (struct dcache_block *block, void *param)
+dcache_free_freelist (DCACHE *dcache)
 {
-  xfree (block);
+  while (dcache->freelist != NULL)
+    {
+      struct dcache_block *db = dcache->freelist;
+
+      dcache->freelist = db->next;
+      xfree (db);
+    }
 }
 
 /* Free a data cache.  */
@@ -218,46 +221,52 @@ free_block (struct dcache_block *block, void *param)
 void
 dcache_free (DCACHE *dcache)
 {
-  splay_tree_delete (dcache->tree);
-  for_each_block (&dcache->oldest, free_block, NULL);
-  for_each_block (&dcache->freelist, free_block, NULL);
+  for (unsigned i = 0; i < dcache->n_sets * DCACHE_WAYS; i++)
+    xfree (dcache->lines[i]);
+  xfree (dcache->lines);
+  dcache_free_freelist (dcache);
   xfree (dcache);
 }
 
-
-/* BLOCK_FUNC function for dcache_invalidate.
-   This doesn't remove the block from the oldest list on purpose.
-   dcache_invalidate will do it later.  */
-
-static void
-invalidate_block (struct dcache_block *block, void *param)
-{
-  DCACHE *dcache = (DCACHE *) param;
-
-  splay_tree_remove (dcache->tree, (splay_tree_key) block->addr);
-  append_block (&dcache->freelist, block);
-}
-
 /* Free all the data cache blocks, thus discarding all cached data.  */
 
 void
 dcache_invalidate (DCACHE *dcache)
 {
-  for_each_block (&dcache->oldest, invalidate_block, dcache);
+  for (unsigned i = 0; i < dcache->n_sets * DCACHE_WAYS; i++)
+    if (dcache->lines[i] != NULL)
+      {
+	dcache->lines[i]->next = dcache->freelist;
+	dcache->freelist = dcache->lines[i];
+	dcache->lines[i] = NULL;
+      }
 
-  dcache->oldest = NULL;
   dcache->size = 0;
   dcache->ptid = null_ptid;
+  dcache->next_fill_addr = 0;
+  dcache->fill_lines = 0;
+  dcache->hits = 0;
+  dcache->misses = 0;
+  dcache->lines_read = 0;
+  dcache->target_reads = 0;
 
   if (dcache->line_size != dcache_line_size)
     {
       /* We've been asked to use a different line size.
 	 All of our freelist blocks are now the wrong size, so free them.  */
 
-      for_each_block (&dcache->freelist, free_block, dcache);
-      dcache->freelist = NULL;
+      dcache_free_freelist (dcache);
       dcache->line_size = dcache_line_size;
     }
+
+  if (dcache->n_sets != dcache_n_sets ())
+    {
+      /* We've been asked to use a different number of lines.  */
+      xfree (dcache->lines);
+      dcache->n_sets = dcache_n_sets ();
+      dcache->lines = XCNEWVEC (struct dcache_block *,
+				dcache->n_sets * DCACHE_WAYS);
+    }
 }
 
 /* Invalidate the line associated with ADDR.  */
@@ -265,32 +274,44 @@ dcache_invalidate (DCACHE *dcache)
 static void
 dcache_invalidate_line (DCACHE *dcache, CORE_ADDR addr)
 {
-  struct dcache_block *db = dcache_hit (dcache, addr);
+  struct dcache_block **slot = dcache_lookup (dcache, addr);
 
-  if (db)
+  if (slot)
     {
-      splay_tree_remove (dcache->tree, (splay_tree_key) db->addr);
-      remove_block (&dcache->oldest, db);
-      append_block (&dcache->freelist, db);
+      struct dcache_block **set = dcache_set (dcache, addr);
+      struct dcache_block *db = *slot;
+
+      /* Close the gap, keeping the order of the other lines.  */
+      for (; slot < &set[DCACHE_WAYS - 1]; slot++)
+	slot[0] = slot[1];
+      set[DCACHE_WAYS - 1] = NULL;
+
+      db->next = dcache->freelist;
+      dcache->freelist = db;
       --dcache->size;
     }
 }
 
 /* If addr is present in the dcache, return the address of the block
-   containing it.  Otherwise return NULL.  */
+   containing it, after making it the most recently used line of its
+   set.  Otherwise return NULL.  */
 
 static struct dcache_block *
 dcache_hit (DCACHE *dcache, CORE_ADDR addr)
 {
+  struct dcache_block **slot = dcache_lookup (dcache, addr);
+  struct dcache_block **set;
   struct dcache_block *db;
 
-  splay_tree_node node = splay_tree_lookup (dcache->tree,
-					    (splay_tree_key) MASK (dcache, addr));
-
-  if (!node)
+  if (!slot)
     return NULL;
 
-  db = (struct dcache_block *) node->value;
+  set = dcache_set (dcache, addr);
+  db = *slot;
+  for (; slot > set; slot--)
+    slot[0] = slot[-1];
+  set[0] = db;
+
   db->refs++;
   return db;
 }
@@ -333,6 +354,7 @@ dcache_read_line (DCACHE *dcache, struct dcache_block *db)
 	}
 
       res = target_read_raw_memory (memaddr, myaddr, reg_len);
+      dcache->target_reads++;
       if (res != 0)
 	return 0;
 
@@ -341,30 +363,30 @@ dcache_read_line (DCACHE *dcache, struct dcache_block *db)
       len -= reg_len;
     }
 
+  dcache->lines_read++;
   return 1;
 }
 
-/* Get a free cache block, put or keep it on the valid list,
-   and return its address.  */
+/* Get a free cache block, make it the most recently used line of its
+   set, and return its address.  The line of ADDR must not be in the
+   cache already.  */
 
 static struct dcache_block *
 dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
 {
+  struct dcache_block **set = dcache_set (dcache, addr);
   struct dcache_block *db;
 
-  if (dcache->size >= dcache_size)
+  if (set[DCACHE_WAYS - 1] != NULL)
     {
-      /* Evict the least recently allocated line.  */
-      db = dcache->oldest;
-      remove_block (&dcache->oldest, db);
-
-      splay_tree_remove (dcache->tree, (splay_tree_key) db->addr);
+      /* Evict the least recently used line of the set.  */
+      db = set[DCACHE_WAYS - 1];
     }
   else
     {
       db = dcache->freelist;
       if (db)
-	remove_block (&dcache->freelist, db);
+	dcache->freelist = db->next;
       else
 	db = ((struct dcache_block *)
 	      xmalloc (offsetof (struct dcache_block, data)
@@ -373,38 +395,101 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
       dcache->size++;
     }
 
+  for (int i = DCACHE_WAYS - 1; i > 0; i--)
+    set[i] = set[i - 1];
+  set[0] = db;
+
   db->addr = MASK (dcache, addr);
   db->refs = 0;
 
-  /* Put DB at the end of the list, it's the newest.  */
-  append_block (&dcache->oldest, db);
-
-  splay_tree_insert (dcache->tree, (splay_tree_key) db->addr,
-		     (splay_tree_value) db);
-
   return db;
 }
 
-/* Using the data cache DCACHE, store in *PTR the contents of the byte at
-   address ADDR in the remote machine.  
+/* Read the line of ADDR, which is not in the cache, from the target
+   into the cache and return its block.  If the caller needs WANT
+   lines starting there, read the ones which are not in the cache
+   along with it, with a single target read; if the cache detects
+   that memory is being read sequentially, read ahead too.  Return
+   NULL if the line of ADDR could not be read.  */
 
-   Returns 1 for success, 0 for error.  */
-
-static int
-dcache_peek_byte (DCACHE *dcache, CORE_ADDR addr, gdb_byte *ptr)
+static struct dcache_block *
+dcache_fill (DCACHE *dcache, CORE_ADDR addr, unsigned want)
 {
-  struct dcache_block *db = dcache_hit (dcache, addr);
+  CORE_ADDR line = MASK (dcache, addr);
+  CORE_ADDR line_size = dcache->line_size;
+  struct dcache_block *db;
+  unsigned n = 1;
+
+  /* A miss soon after the lines read last time means memory is being
+     read sequentially, though perhaps skipping some bytes (like a
+     backtrace does, going through the frames).  */
+  if (dcache_prefetch_p
+      && line >= dcache->next_fill_addr
+      && (line - dcache->next_fill_addr
+	  <= dcache->fill_lines * line_size))
+    want = std::max (want, 2 * dcache->fill_lines);
+  want = std::min (want, (unsigned) DCACHE_MAX_FILL_LINES);
+
+  /* Consecutive lines belong to different sets, so that filling them
+     can't evict one of the others, as long as there aren't more of
+     them than sets.  Stop at the first line which is already cached,
+     and before the address space wraps around.  */
+  while (n < want && n < dcache->n_sets
+	 && line + n * line_size > line
+	 && dcache_lookup (dcache, line + n * line_size) == NULL)
+    n++;
+
+  if (n > 1)
+    {
+      struct mem_region *region = lookup_mem_region (line);
+
+      /* Stay within the memory region of ADDR; dcache_read_line deals
+	 with the lines which straddle regions.  */
+      if (region->attrib.mode == MEM_WO)
+	n = 1;
+      else if (region->hi != 0 && line + n * line_size > region->hi)
+	n = std::max ((ULONGEST) 1, (ULONGEST) (region->hi - line) / line_size);
+    }
 
-  if (!db)
+  if (n > 1)
     {
-      db = dcache_alloc (dcache, addr);
+      gdb::byte_vector buf (n * line_size);
 
-      if (!dcache_read_line (dcache, db))
-         return 0;
+      dcache->target_reads++;
+      if (target_read_raw_memory (line, buf.data (), buf.size ()) == 0)
+	{
+	  struct dcache_block *first = NULL;
+
+	  for (unsigned i = 0; i < n; i++)
+	    {
+	      db = dcache_alloc (dcache, line + i * line_size);
+	      memcpy (db->data, &buf[i * line_size], line_size);
+	      if (i == 0)
+		first = db;
+	    }
+
+	  dcache->lines_read += n;
+	  dcache->next_fill_addr = line + n * line_size;
+	  dcache->fill_lines = n;
+	  return first;
+	}
+
+      /* Some of the lines can't be read.  Fall back to reading just
+	 the one which is needed.  */
     }
 
-  *ptr = db->data[XFORM (dcache, addr)];
-  return 1;
+  db = dcache_alloc (dcache, line);
+  if (!dcache_read_line (dcache, db))
+    {
+      /* Discard the cache line so we don't have a partially read
+	 line.  */
+      dcache_invalidate_line (dcache, line);
+      return NULL;
+    }
+
+  dcache->next_fill_addr = line + line_size;
+  dcache->fill_lines = 1;
+  return db;
 }
 
 /* Write the byte at PTR into ADDR in the data cache.
@@ -425,29 +510,16 @@ dcache_poke_byte (DCACHE *dcache, CORE_ADDR addr, const gdb_byte *ptr)
     db->data[XFORM (dcache, addr)] = *ptr;
 }
 
-static int
-dcache_splay_tree_compare (splay_tree_key a, splay_tree_key b)
-{
-  if (a > b)
-    return 1;
-  else if (a == b)
-    return 0;
-  else
-    return -1;
-}
-
 /* Allocate and initialize a data cache.  */
 
 DCACHE *
 dcache_init (void)
 {
-  DCACHE *dcache = XNEW (DCACHE);
-
-  dcache->tree = splay_tree_new (dcache_splay_tree_compare,
-				 NULL,
-				 NULL);
+  DCACHE *dcache = XCNEW (DCACHE);
 
-  dcache->oldest = NULL;
+  dcache->n_sets = dcache_n_sets ();
+  dcache->lines = XCNEWVEC (struct dcache_block *,
+			    dcache->n_sets * DCACHE_WAYS);
   dcache->freelist = NULL;
   dcache->size = 0;
   dcache->line_size = dcache_line_size;
@@ -467,26 +539,48 @@ dcache_read_memory_partial (struct target_ops *ops, DCACHE *dcache,
 			    CORE_ADDR memaddr, gdb_byte *myaddr,
 			    ULONGEST len, ULONGEST *xfered_len)
 {
-  ULONGEST i;
+  ULONGEST i = 0;
 
-  /* If this is a different inferior from what we've recorded,
-     flush the cache.  */
+  /* If this is a different thread from what we've recorded, flush the
+     cache if it may be stale.  The threads of an inferior share its
+     memory, so when they are all stopped, switching threads, e.g. in
+     "thread apply all backtrace", keeps the cached lines.  But if some
+     thread may be running, it may have written to the memory since we
+     cached it.  */
 
-  if (! ptid_equal (inferior_ptid, dcache->ptid))
+  if (inferior_ptid != dcache->ptid)
     {
-      dcache_invalidate (dcache);
+      if (inferior_ptid.pid () != dcache->ptid.pid ()
+	  || target_is_non_stop_p ()
+	  || threads_are_executing ())
+	dcache_invalidate (dcache);
       dcache->ptid = inferior_ptid;
     }
 
-  for (i = 0; i < len; i++)
+  while (i < len)
     {
-      if (!dcache_peek_byte (dcache, memaddr + i, myaddr + i))
+      CORE_ADDR addr = memaddr + i;
+      ULONGEST offset = XFORM (dcache, addr);
+      ULONGEST chunk = std::min (dcache->line_size - offset, len - i);
+      struct dcache_block *db = dcache_hit (dcache, addr);
+
+      if (db != NULL)
+	dcache->hits++;
+      else
 	{
-	  /* That failed.  Discard its cache line so we don't have a
-	     partially read line.  */
-	  dcache_invalidate_line (dcache, memaddr + i);
-	  break;
+	  /* The number of lines the rest of the request needs.  */
+	  ULONGEST want = (offset + (len - i) + dcache->line_size - 1)
+			  / dcache->line_size;
+
+	  dcache->misses++;
+	  db = dcache_fill (dcache, addr,
+			    std::min (want, (ULONGEST) DCACHE_MAX_FILL_LINES));
+	  if (db == NULL)
+	    break;
 	}
+
+      memcpy (myaddr + i, db->data + offset, chunk);
+      i += chunk;
     }
 
   if (i == 0)
@@ -534,14 +628,34 @@ dcache_update (DCACHE *dcache, enum target_xfer_status status,
       }
 }
 
+/* Return the lines in DCACHE, sorted by address.  */
+
+static std::vector<struct dcache_block *>
+dcache_sorted_lines (DCACHE *dcache)
+{
+  std::vector<struct dcache_block *> lines;
+
+  lines.reserve (dcache->size);
+  for (unsigned i = 0; i < dcache->n_sets * DCACHE_WAYS; i++)
+    if (dcache->lines[i] != NULL)
+      lines.push_back (dcache->lines[i]);
+
+  std::sort (lines.begin (), lines.end (),
+	     [] (const struct dcache_block *a, const struct dcache_block *b)
+	     {
+	       return a->addr < b->addr;
+	     });
+
+  return lines;
+}
+
 /* Print DCACHE line INDEX.  */
 
 static void
 dcache_print_line (DCACHE *dcache, int index)
 {
-  splay_tree_node n;
   struct dcache_block *db;
-  int i, j;
+  int j;
 
   if (dcache == NULL)
     {
@@ -549,22 +663,15 @@ dcache_print_line (DCACHE *dcache, int index)
       return;
     }
 
-  n = splay_tree_min (dcache->tree);
-
-  for (i = index; i > 0; --i)
-    {
-      if (!n)
-	break;
-      n = splay_tree_successor (dcache->tree, n->key);
-    }
+  std::vector<struct dcache_block *> lines = dcache_sorted_lines (dcache);
 
-  if (!n)
+  if ((size_t) index >= lines.size ())
     {
       printf_filtered (_("No such cache line exists.\n"));
       return;
     }
-    
-  db = (struct dcache_block *) n->value;
+
+  db = lines[index];
 
   printf_filtered (_("Line %d: address %s [%d hits]\n"),
 		   index, paddress (target_gdbarch (), db->addr), db->refs);
@@ -585,7 +692,6 @@ dcache_print_line (DCACHE *dcache, int index)
 static void
 dcache_info_1 (DCACHE *dcache, const char *exp)
 {
-  splay_tree_node n;
   int i, refcount;
 
   if (exp)
@@ -618,23 +724,22 @@ dcache_info_1 (DCACHE *dcache, const char *exp)
 		   target_pid_to_str (dcache->ptid));
 
   refcount = 0;
-
-  n = splay_tree_min (dcache->tree);
   i = 0;
 
-  while (n)
+  for (struct dcache_block *db : dcache_sorted_lines (dcache))
     {
-      struct dcache_block *db = (struct dcache_block *) n->value;
-
       printf_filtered (_("Line %d: address %s [%d hits]\n"),
 		       i, paddress (target_gdbarch (), db->addr), db->refs);
       i++;
       refcount += db->refs;
-
-      n = splay_tree_successor (dcache->tree, n->key);
     }
 
   printf_filtered (_("Cache state: %d active lines, %d hits\n"), i, refcount);
+  printf_filtered (_("Lookups: %s hits, %s misses; "
+		     "%s lines read in %s target reads\n"),
+		   pulongest (dcache->hits), pulongest (dcache->misses),
+		   pulongest (dcache->lines_read),
+		   pulongest (dcache->target_reads));
 }
 
 static void
@@ -729,4 +834,15 @@ Show number of dcache lines."),
 			     set_dcache_size,
 			     NULL,
 			     &dcache_set_list, &dcache_show_list);
+  add_setshow_boolean_cmd ("prefetch", class_obscure,
+			   &dcache_prefetch_p, _("\
+Set whether the dcache reads ahead when memory is read sequentially."), _("\
+Show whether the dcache reads ahead when memory is read sequentially."),
+			   _("\
+When on, each time a read misses the cache shortly after the lines read\n\
+for the previous miss, the dcache reads twice as many lines as it did\n\
+then, up to 16 lines, with a single target read."),
+			   NULL,
+			   NULL,
+			   &dcache_set_list, &dcache_show_list);
 }
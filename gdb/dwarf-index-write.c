@@ -26,6 +26,7 @@
 #include "common/gdb_unlinker.h"
 #include "complaints.h"
 #include "dwarf-index-common.h"
+#include "dwarf-index-write.h"
 #include "dwarf2.h"
 #include "dwarf2read.h"
 #include "gdb/gdb-index.h"
@@ -35,15 +36,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <forward_list>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
 
-/* The suffix for an index file.  */
-#define INDEX4_SUFFIX ".gdb-index"
-#define INDEX5_SUFFIX ".debug_names"
-#define DEBUG_STR_SUFFIX ".debug_str"
-
 /* Ensure only legit values are used.  */
 #define DW2_GDB_INDEX_SYMBOL_STATIC_SET_VALUE(cu_index, value) \
   do { \
@@ -1545,11 +1542,11 @@ assert_file_size (FILE *file, const char *filename, size_t expected_size)
   gdb_assert (file_size == expected_size);
 }
 
-/* Create an index file for OBJFILE in the directory DIR.  */
+/* See dwarf-index-write.h.  */
 
-static void
+void
 write_psymtabs_to_index (struct dwarf2_per_objfile *dwarf2_per_objfile,
-			 const char *dir,
+			 const char *dir, const char *basename,
 			 dw_index_kind index_kind)
 {
   struct objfile *objfile = dwarf2_per_objfile->objfile;
@@ -1567,49 +1564,61 @@ write_psymtabs_to_index (struct dwarf2_per_objfile *dwarf2_per_objfile,
   if (stat (objfile_name (objfile), &st) < 0)
     perror_with_name (objfile_name (objfile));
 
-  std::string filename (std::string (dir) + SLASH_STRING
-			+ lbasename (objfile_name (objfile))
+  std::string filename (std::string (dir) + SLASH_STRING + basename
 			+ (index_kind == dw_index_kind::DEBUG_NAMES
 			   ? INDEX5_SUFFIX : INDEX4_SUFFIX));
+  std::string filename_str (std::string (dir) + SLASH_STRING + basename
+			    + DEBUG_STR_SUFFIX);
+
+  /* Write to temporary files, and rename them once they are complete:
+     another GDB may be reading the index at the same time, e.g. from
+     the index cache.  */
+  std::string tmp_suffix = string_printf (".tmp-%ld", (long) getpid ());
+  std::string tmp_filename = filename + tmp_suffix;
+  std::string tmp_filename_str = filename_str + tmp_suffix;
 
-  FILE *out_file = gdb_fopen_cloexec (filename.c_str (), "wb").release ();
+  FILE *out_file = gdb_fopen_cloexec (tmp_filename.c_str (), "wb").release ();
   if (!out_file)
-    error (_("Can't open `%s' for writing"), filename.c_str ());
+    error (_("Can't open `%s' for writing"), tmp_filename.c_str ());
 
   /* Order matters here; we want FILE to be closed before FILENAME is
      unlinked, because on MS-Windows one cannot delete a file that is
      still open.  (Don't call anything here that might throw until
-     file_closer is created.)  */
-  gdb::unlinker unlink_file (filename.c_str ());
+     file_closer is created.)  For the same reason, the files are
+     closed before they are renamed.  */
+  gdb::unlinker unlink_file (tmp_filename.c_str ());
   gdb_file_up close_out_file (out_file);
 
   if (index_kind == dw_index_kind::DEBUG_NAMES)
     {
-      std::string filename_str (std::string (dir) + SLASH_STRING
-				+ lbasename (objfile_name (objfile))
-				+ DEBUG_STR_SUFFIX);
       FILE *out_file_str
-	= gdb_fopen_cloexec (filename_str.c_str (), "wb").release ();
+	= gdb_fopen_cloexec (tmp_filename_str.c_str (), "wb").release ();
       if (!out_file_str)
-	error (_("Can't open `%s' for writing"), filename_str.c_str ());
-      gdb::unlinker unlink_file_str (filename_str.c_str ());
+	error (_("Can't open `%s' for writing"), tmp_filename_str.c_str ());
+      gdb::unlinker unlink_file_str (tmp_filename_str.c_str ());
       gdb_file_up close_out_file_str (out_file_str);
 
       const size_t total_len
 	= write_debug_names (dwarf2_per_objfile, out_file, out_file_str);
-      assert_file_size (out_file, filename.c_str (), total_len);
+      assert_file_size (out_file, tmp_filename.c_str (), total_len);
 
       /* We want to keep the file .debug_str file too.  */
+      close_out_file_str.reset ();
+      if (rename (tmp_filename_str.c_str (), filename_str.c_str ()) != 0)
+	perror_with_name (filename_str.c_str ());
       unlink_file_str.keep ();
     }
   else
     {
       const size_t total_len
 	= write_gdbindex (dwarf2_per_objfile, out_file);
-      assert_file_size (out_file, filename.c_str (), total_len);
+      assert_file_size (out_file, tmp_filename.c_str (), total_len);
     }
 
   /* We want to keep the file.  */
+  close_out_file.reset ();
+  if (rename (tmp_filename.c_str (), filename.c_str ()) != 0)
+    perror_with_name (filename.c_str ());
   unlink_file.keep ();
 }
 
@@ -1655,7 +1664,9 @@ save_gdb_index_command (const char *arg, int from_tty)
       {
 	TRY
 	  {
-	    write_psymtabs_to_index (dwarf2_per_objfile, arg, index_kind);
+	    write_psymtabs_to_index (dwarf2_per_objfile, arg,
+				     lbasename (objfile_name (objfile)),
+				     index_kind);
 	  }
 	CATCH (except, RETURN_MASK_ERROR)
 	  {
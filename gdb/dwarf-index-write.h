@@ -0,0 +1,42 @@
+/* DWARF index writing support for GDB.
+
+   Copyright (C) 2018 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef DWARF_INDEX_WRITE_H
+#define DWARF_INDEX_WRITE_H
+
+#include "symfile.h"
+
+struct dwarf2_per_objfile;
+
+/* The suffix for an index file.  */
+#define INDEX4_SUFFIX ".gdb-index"
+#define INDEX5_SUFFIX ".debug_names"
+#define DEBUG_STR_SUFFIX ".debug_str"
+
+/* Create an index file of kind INDEX_KIND for the objfile of
+   DWARF2_PER_OBJFILE, in the directory DIR.  The file is named
+   BASENAME followed by the suffix for INDEX_KIND.  The file is written
+   under a temporary name and renamed when complete, so that a reader
+   never sees a partial index.  Throw an error on failure.  */
+
+extern void write_psymtabs_to_index
+  (struct dwarf2_per_objfile *dwarf2_per_objfile, const char *dir,
+   const char *basename, dw_index_kind index_kind);
+
+#endif /* DWARF_INDEX_WRITE_H */
@@ -38,6 +38,8 @@
 #include "ax.h"
 #include "dwarf2loc.h"
 #include "dwarf2-frame-tailcall.h"
+#include "gdb_bfd.h"
+#include <algorithm>
 #if GDB_SELF_TEST
 #include "selftest.h"
 #include "selftest-arch.h"
@@ -129,8 +131,30 @@ struct dwarf2_fde_table
 {
   int num_entries;
   struct dwarf2_fde **entries;
+
+  /* The initial location of each of ENTRIES, in the same order.  These
+     are kept apart so that looking up a PC only touches one compact
+     array, and not each FDE it compares against.  */
+  CORE_ADDR *initial_locations;
+
+  /* The highest end of the ranges of ENTRIES.  No PC at or above it
+     can be found in this table.  */
+  CORE_ADDR end_address;
+
+  /* If non-NULL, the FDEs were not decoded when the table was built,
+     which was instead filled in from the search table of the
+     .eh_frame_hdr section.  ENTRIES[I] is then NULL until the FDE
+     found FDE_OFFSETS[I] bytes into the .eh_frame section of UNIT is
+     first looked up, and CIE_TABLE holds the CIEs decoded so far.
+     FDE_OFFSETS[I] is set to BAD_LAZY_FDE_OFFSET if that FDE could
+     not be decoded or covers no addresses.  */
+  struct comp_unit *unit;
+  unsigned int *fde_offsets;
+  struct dwarf2_cie_table *cie_table;
 };
 
+#define BAD_LAZY_FDE_OFFSET ((unsigned int) -1)
+
 /* A minimal decoding of DWARF2 compilation units.  We only decode
    what's needed to get to the call frame information.  */
 
@@ -1657,32 +1681,107 @@ find_cie (struct dwarf2_cie_table *cie_table, ULONGEST cie_pointer)
   return NULL;
 }
 
-/* Add a pointer to new CIE to the CIE_TABLE, allocating space for it.  */
+/* Add a pointer to new CIE to the CIE_TABLE, allocating space for it.
+   The CIEs are usually added in increasing order, but not when the
+   FDEs are decoded on demand.  */
 static void
 add_cie (struct dwarf2_cie_table *cie_table, struct dwarf2_cie *cie)
 {
-  const int n = cie_table->num_entries;
+  int n = cie_table->num_entries;
+
+  cie_table->entries
+    = XRESIZEVEC (struct dwarf2_cie *, cie_table->entries, n + 1);
+  for (; n > 0 && cie_table->entries[n - 1]->cie_pointer > cie->cie_pointer;
+       n--)
+    cie_table->entries[n] = cie_table->entries[n - 1];
 
   gdb_assert (n < 1
               || cie_table->entries[n - 1]->cie_pointer < cie->cie_pointer);
 
-  cie_table->entries
-    = XRESIZEVEC (struct dwarf2_cie *, cie_table->entries, n + 1);
   cie_table->entries[n] = cie;
-  cie_table->num_entries = n + 1;
+  cie_table->num_entries++;
 }
 
-static int
-bsearch_fde_cmp (const void *key, const void *element)
+/* Defines the type of eh_frames that are expected to be decoded: CIE, FDE
+   or any of them.  */
+
+enum eh_frame_type
 {
-  CORE_ADDR seek_pc = *(CORE_ADDR *) key;
-  struct dwarf2_fde *fde = *(struct dwarf2_fde **) element;
+  EH_CIE_TYPE_ID = 1 << 0,
+  EH_FDE_TYPE_ID = 1 << 1,
+  EH_CIE_OR_FDE_TYPE_ID = EH_CIE_TYPE_ID | EH_FDE_TYPE_ID
+};
 
-  if (seek_pc < fde->initial_location)
-    return -1;
-  if (seek_pc < fde->initial_location + fde->address_range)
-    return 0;
-  return 1;
+static const gdb_byte *decode_frame_entry (struct comp_unit *unit,
+					   const gdb_byte *start,
+					   int eh_frame_p,
+					   struct dwarf2_cie_table *cie_table,
+					   struct dwarf2_fde_table *fde_table,
+					   enum eh_frame_type entry_type);
+
+/* Decode the FDE at index IX of the lazily filled FDE_TABLE.  Return
+   NULL if it can not be decoded, now or in an earlier call.  */
+
+static struct dwarf2_fde *
+decode_lazy_fde (struct dwarf2_fde_table *fde_table, int ix)
+{
+  struct comp_unit *unit = fde_table->unit;
+  struct dwarf2_fde_table found;
+  struct dwarf2_fde *fde;
+
+  if (fde_table->fde_offsets[ix] == BAD_LAZY_FDE_OFFSET)
+    return NULL;
+
+  found.num_entries = 0;
+  found.entries = NULL;
+
+  TRY
+    {
+      decode_frame_entry (unit,
+			  unit->dwarf_frame_buffer + fde_table->fde_offsets[ix],
+			  1, fde_table->cie_table, &found, EH_FDE_TYPE_ID);
+    }
+  CATCH (e, RETURN_MASK_ERROR)
+    {
+      complaint (_("Corrupt FDE in %s:%s: %s"),
+		 unit->dwarf_frame_section->owner->filename,
+		 unit->dwarf_frame_section->name, e.message);
+    }
+  END_CATCH
+
+  fde = found.num_entries != 0 ? found.entries[0] : NULL;
+  xfree (found.entries);
+  if (fde == NULL)
+    fde_table->fde_offsets[ix] = BAD_LAZY_FDE_OFFSET;
+  fde_table->entries[ix] = fde;
+  return fde;
+}
+
+/* Return the FDE of FDE_TABLE whose range contains SEEK_PC, or NULL if
+   there is none.  */
+
+static struct dwarf2_fde *
+find_fde_in_table (struct dwarf2_fde_table *fde_table, CORE_ADDR seek_pc)
+{
+  const CORE_ADDR *first = fde_table->initial_locations;
+  const CORE_ADDR *last = first + fde_table->num_entries;
+  const CORE_ADDR *it = std::upper_bound (first, last, seek_pc);
+  struct dwarf2_fde *fde;
+  int ix;
+
+  if (it == first)
+    return NULL;
+  ix = it - first - 1;
+
+  fde = fde_table->entries[ix];
+  if (fde == NULL && fde_table->unit != NULL)
+    fde = decode_lazy_fde (fde_table, ix);
+
+  if (fde == NULL
+      || seek_pc < fde->initial_location
+      || seek_pc - fde->initial_location >= fde->address_range)
+    return NULL;
+  return fde;
 }
 
 /* Find the FDE for *PC.  Return a pointer to the FDE, and store the
@@ -1696,7 +1795,7 @@ dwarf2_frame_find_fde (CORE_ADDR *pc, CORE_ADDR *out_offset)
   ALL_OBJFILES (objfile)
     {
       struct dwarf2_fde_table *fde_table;
-      struct dwarf2_fde **p_fde;
+      struct dwarf2_fde *fde;
       CORE_ADDR offset;
       CORE_ADDR seek_pc;
 
@@ -1717,19 +1816,20 @@ dwarf2_frame_find_fde (CORE_ADDR *pc, CORE_ADDR *out_offset)
       offset = ANOFFSET (objfile->section_offsets, SECT_OFF_TEXT (objfile));
 
       gdb_assert (fde_table->num_entries > 0);
-      if (*pc < offset + fde_table->entries[0]->initial_location)
+      if (*pc < offset + fde_table->initial_locations[0])
         continue;
 
       seek_pc = *pc - offset;
-      p_fde = ((struct dwarf2_fde **)
-	       bsearch (&seek_pc, fde_table->entries, fde_table->num_entries,
-                        sizeof (fde_table->entries[0]), bsearch_fde_cmp));
-      if (p_fde != NULL)
+      if (seek_pc >= fde_table->end_address)
+	continue;
+
+      fde = find_fde_in_table (fde_table, seek_pc);
+      if (fde != NULL)
         {
-          *pc = (*p_fde)->initial_location + offset;
+          *pc = fde->initial_location + offset;
 	  if (out_offset)
 	    *out_offset = offset;
-          return *p_fde;
+          return fde;
         }
     }
   return NULL;
@@ -1751,22 +1851,6 @@ add_fde (struct dwarf2_fde_table *fde_table, struct dwarf2_fde *fde)
 
 #define DW64_CIE_ID 0xffffffffffffffffULL
 
-/* Defines the type of eh_frames that are expected to be decoded: CIE, FDE
-   or any of them.  */
-
-enum eh_frame_type
-{
-  EH_CIE_TYPE_ID = 1 << 0,
-  EH_FDE_TYPE_ID = 1 << 1,
-  EH_CIE_OR_FDE_TYPE_ID = EH_CIE_TYPE_ID | EH_FDE_TYPE_ID
-};
-
-static const gdb_byte *decode_frame_entry (struct comp_unit *unit,
-					   const gdb_byte *start,
-					   int eh_frame_p,
-					   struct dwarf2_cie_table *cie_table,
-					   struct dwarf2_fde_table *fde_table,
-					   enum eh_frame_type entry_type);
 
 /* Decode the next CIE or FDE, entry_type specifies the expected type.
    Return NULL if invalid input, otherwise the next byte to be processed.  */
@@ -2167,6 +2251,105 @@ Corrupt data in %s:%s; align 8 workaround apparently succeeded"),
   return ret;
 }
 
+/* Build an FDE table from the binary search table that the linker
+   put in the .eh_frame_hdr section of UNIT's objfile, leaving the FDEs
+   of UNIT's .eh_frame section to be decoded when first looked up.
+   Return NULL if there is no such table or if it is not in the format
+   GNU ld and gold always use; the caller then decodes the whole
+   .eh_frame section.  */
+
+static struct dwarf2_fde_table *
+dwarf2_frame_use_eh_frame_hdr (struct comp_unit *unit)
+{
+  struct objfile *objfile = unit->objfile;
+  struct gdbarch *gdbarch = get_objfile_arch (objfile);
+  bfd *abfd = unit->abfd;
+  asection *hdr_section;
+  const gdb_byte *hdr, *table;
+  bfd_size_type hdr_size;
+  CORE_ADDR hdr_vma, eh_frame_vma, prev_location = 0;
+  ULONGEST fde_count, i;
+  struct dwarf2_fde_table *fde_table;
+
+  hdr_section = bfd_get_section_by_name (abfd, ".eh_frame_hdr");
+  if (hdr_section == NULL)
+    return NULL;
+
+  /* The header is made of the version, the encodings of the .eh_frame
+     pointer, of the FDE count and of the table entries, then the
+     .eh_frame pointer and the FDE count themselves.  */
+  hdr = gdb_bfd_map_section (hdr_section, &hdr_size);
+  if (hdr == NULL || hdr_size < 12
+      || hdr[0] != 1
+      || hdr[1] != (DW_EH_PE_pcrel | DW_EH_PE_sdata4)
+      || hdr[2] != DW_EH_PE_udata4
+      || hdr[3] != (DW_EH_PE_datarel | DW_EH_PE_sdata4))
+    return NULL;
+
+  hdr_vma = bfd_get_section_vma (abfd, hdr_section);
+  eh_frame_vma = bfd_get_section_vma (abfd, unit->dwarf_frame_section);
+  if (hdr_vma + 4 + bfd_get_signed_32 (abfd, hdr + 4) != eh_frame_vma)
+    return NULL;
+
+  fde_count = bfd_get_32 (abfd, hdr + 8);
+  if (fde_count == 0 || fde_count > (hdr_size - 12) / 8)
+    return NULL;
+
+  /* Each entry of the table holds the initial location of an FDE and
+     the address of the FDE, both relative to the start of the
+     .eh_frame_hdr section.  Check that they are sorted and point into
+     .eh_frame before trusting them.  */
+  table = hdr + 12;
+  for (i = 0; i < fde_count; i++)
+    {
+      CORE_ADDR location
+	= gdbarch_adjust_dwarf2_addr (gdbarch,
+				      hdr_vma + bfd_get_signed_32 (abfd,
+								   table
+								   + 8 * i));
+      CORE_ADDR fde_addr = hdr_vma + bfd_get_signed_32 (abfd,
+							 table + 8 * i + 4);
+
+      if ((i > 0 && location <= prev_location)
+	  || fde_addr < eh_frame_vma
+	  || fde_addr - eh_frame_vma >= unit->dwarf_frame_size)
+	return NULL;
+      prev_location = location;
+    }
+
+  fde_table = XOBNEW (&objfile->objfile_obstack, struct dwarf2_fde_table);
+  fde_table->num_entries = fde_count;
+  fde_table->entries = OBSTACK_CALLOC (&objfile->objfile_obstack, fde_count,
+				       struct dwarf2_fde *);
+  fde_table->initial_locations
+    = XOBNEWVEC (&objfile->objfile_obstack, CORE_ADDR, fde_count);
+  fde_table->fde_offsets
+    = XOBNEWVEC (&objfile->objfile_obstack, unsigned int, fde_count);
+  for (i = 0; i < fde_count; i++)
+    {
+      fde_table->initial_locations[i]
+	= gdbarch_adjust_dwarf2_addr (gdbarch,
+				      hdr_vma + bfd_get_signed_32 (abfd,
+								   table
+								   + 8 * i));
+      fde_table->fde_offsets[i]
+	= (hdr_vma + bfd_get_signed_32 (abfd, table + 8 * i + 4)
+	   - eh_frame_vma);
+    }
+
+  fde_table->unit = unit;
+  fde_table->cie_table = XOBNEW (&objfile->objfile_obstack,
+				 struct dwarf2_cie_table);
+  fde_table->cie_table->num_entries = 0;
+  fde_table->cie_table->entries = NULL;
+
+  /* Any FDE may end the highest, and finding out which would mean
+     decoding all of them, so don't bound the table.  */
+  fde_table->end_address = (CORE_ADDR) -1;
+
+  return fde_table;
+}
+
 static int
 qsort_fde_cmp (const void *a, const void *b)
 {
@@ -2196,6 +2379,9 @@ dwarf2_build_frame_info (struct objfile *objfile)
   struct dwarf2_cie_table cie_table;
   struct dwarf2_fde_table fde_table;
   struct dwarf2_fde_table *fde_table2;
+  asection *debug_frame_section;
+  const gdb_byte *debug_frame_buffer;
+  bfd_size_type debug_frame_size;
 
   cie_table.num_entries = 0;
   cie_table.entries = NULL;
@@ -2236,6 +2422,23 @@ dwarf2_build_frame_info (struct objfile *objfile)
           if (txt)
             unit->tbase = txt->vma;
 
+	  /* Unless there is a .debug_frame section to merge in too, look
+	     the FDEs up through the .eh_frame_hdr section, so that only
+	     the ones we need get decoded.  */
+	  dwarf2_get_section_info (objfile, DWARF2_DEBUG_FRAME,
+				   &debug_frame_section, &debug_frame_buffer,
+				   &debug_frame_size);
+	  if (debug_frame_size == 0)
+	    {
+	      fde_table2 = dwarf2_frame_use_eh_frame_hdr (unit);
+	      if (fde_table2 != NULL)
+		{
+		  set_objfile_data (objfile, dwarf2_frame_objfile_data,
+				    fde_table2);
+		  return;
+		}
+	    }
+
 	  TRY
 	    {
 	      frame_ptr = unit->dwarf_frame_buffer;
@@ -2322,11 +2525,16 @@ dwarf2_build_frame_info (struct objfile *objfile)
 
   /* Copy fde_table to obstack: it is needed at runtime.  */
   fde_table2 = XOBNEW (&objfile->objfile_obstack, struct dwarf2_fde_table);
+  fde_table2->unit = NULL;
+  fde_table2->fde_offsets = NULL;
+  fde_table2->cie_table = NULL;
 
   if (fde_table.num_entries == 0)
     {
       fde_table2->entries = NULL;
       fde_table2->num_entries = 0;
+      fde_table2->initial_locations = NULL;
+      fde_table2->end_address = 0;
     }
   else
     {
@@ -2387,6 +2595,20 @@ dwarf2_build_frame_info (struct objfile *objfile)
       fde_table2->entries
 	= (struct dwarf2_fde **) obstack_finish (&objfile->objfile_obstack);
 
+      fde_table2->initial_locations
+	= XOBNEWVEC (&objfile->objfile_obstack, CORE_ADDR,
+		     fde_table2->num_entries);
+      fde_table2->end_address = 0;
+      for (i = 0; i < fde_table2->num_entries; i++)
+	{
+	  struct dwarf2_fde *fde = fde_table2->entries[i];
+
+	  fde_table2->initial_locations[i] = fde->initial_location;
+	  fde_table2->end_address
+	    = std::max (fde_table2->end_address,
+			fde->initial_location + fde->address_range);
+	}
+
       /* Discard the original fde_table.  */
       xfree (fde_table.entries);
     }
@@ -2394,11 +2616,24 @@ dwarf2_build_frame_info (struct objfile *objfile)
   set_objfile_data (objfile, dwarf2_frame_objfile_data, fde_table2);
 }
 
+/* Free the CIE table of a lazily filled FDE table, the only part of it
+   not on the objfile obstack.  */
+
+static void
+dwarf2_frame_objfile_data_free (struct objfile *objfile, void *arg)
+{
+  struct dwarf2_fde_table *fde_table = (struct dwarf2_fde_table *) arg;
+
+  if (fde_table->cie_table != NULL)
+    xfree (fde_table->cie_table->entries);
+}
+
 void
 _initialize_dwarf2_frame (void)
 {
   dwarf2_frame_data = gdbarch_data_register_pre_init (dwarf2_frame_init);
-  dwarf2_frame_objfile_data = register_objfile_data ();
+  dwarf2_frame_objfile_data
+    = register_objfile_data_with_cleanup (NULL, dwarf2_frame_objfile_data_free);
 
 #if GDB_SELF_TEST
   selftests::register_test_foreach_arch ("execute_cfa_program",
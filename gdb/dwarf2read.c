@@ -77,7 +77,10 @@
 #include "common/underlying.h"
 #include "common/byte-vector.h"
 #include "common/hash_enum.h"
+#include "common/parallel-for.h"
 #include "filename-seen-cache.h"
+#include "index-cache.h"
+#include "maint.h"
 #include "producer.h"
 #include <fcntl.h>
 #include <sys/types.h>
@@ -90,6 +93,9 @@
 #include <forward_list>
 #include "rust-lang.h"
 #include "common/pathstuff.h"
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
 
 /* When == 1, print basic high level tracing messages.
    When > 1, be more verbose.
@@ -170,9 +176,17 @@ struct mapped_index_base
     return false;
   }
 
+  /* Make symbol_name_at safe to call from several threads at once.
+     This is called before building the name components in worker
+     threads.  */
+  virtual void decode_symbol_names ()
+  {
+  }
+
   /* Build the symbol name component sorted vector, if we haven't
-     yet.  */
-  void build_name_components ();
+     yet.  Use up to N_THREADS threads to do so, or the number given
+     by worker_thread_count if N_THREADS is zero.  */
+  void build_name_components (unsigned int n_threads = 0);
 
   /* Returns the lower (inclusive) and upper (exclusive) bounds of the
      possible matches for LN_NO_PARAMS in the name component
@@ -264,6 +278,11 @@ struct mapped_debug_names final : public mapped_index_base
 
   std::unordered_map<ULONGEST, index_val> abbrev_map;
 
+  /* The names of the name table, indexed by name index.  A name is
+     only read from .debug_str the first time it is needed; the vector
+     is empty until then.  */
+  mutable std::vector<const char *> name_strings;
+
   const char *namei_to_name (uint32_t namei) const;
 
   /* Implementation of the mapped_index_base virtual interface, for
@@ -274,6 +293,8 @@ struct mapped_debug_names final : public mapped_index_base
 
   size_t symbol_name_count () const override
   { return this->name_count; }
+
+  void decode_symbol_names () override;
 };
 
 /* See dwarf2read.h.  */
@@ -450,6 +471,11 @@ struct dwarf2_cu
      with partial_die->offset.SECT_OFF as hash.  */
   htab_t partial_dies = nullptr;
 
+  /* Non-NULL if the partial symbols of this CU are being read by a
+     worker thread.  What would be added to the objfile is recorded
+     here instead, see process_psymtab_comp_units.  */
+  struct deferred_psymtab *deferred_psymtab = nullptr;
+
   /* Storage for things with the same lifetime as this read-in compilation
      unit, including partial DIEs.  */
   auto_obstack comp_unit_obstack;
@@ -1869,6 +1895,9 @@ static void queue_comp_unit (struct dwarf2_per_cu_data *per_cu,
 
 static void process_queue (struct dwarf2_per_objfile *dwarf2_per_objfile);
 
+static unsigned int prepare_worker_threads
+  (struct dwarf2_per_objfile *dwarf2_per_objfile);
+
 /* Class, the destructor of which frees all allocated queue entries.  This
    will only have work to do if an error was thrown while processing the
    dwarf.  If no error was thrown then the queue entries should have all
@@ -2833,10 +2862,15 @@ create_quick_file_names_table (unsigned int nr_initial_entries)
 static void
 load_cu (struct dwarf2_per_cu_data *per_cu, bool skip_partial)
 {
-  if (per_cu->is_debug_types)
-    load_full_type_unit (per_cu);
-  else
-    load_full_comp_unit (per_cu, skip_partial, language_minimal);
+  /* The DIEs may have been read in advance by a worker thread, see
+     dw2_expand_all_symtabs.  */
+  if (per_cu->cu == NULL || per_cu->cu->dies == NULL)
+    {
+      if (per_cu->is_debug_types)
+	load_full_type_unit (per_cu);
+      else
+	load_full_comp_unit (per_cu, skip_partial, language_minimal);
+    }
 
   if (per_cu->cu == NULL)
     return;  /* Dummy CU.  */
@@ -3403,44 +3437,32 @@ find_slot_in_mapped_hash (struct mapped_index *index, const char *name,
     }
 }
 
-/* A helper function that reads the .gdb_index from SECTION and fills
-   in MAP.  FILENAME is the name of the file containing the section;
-   it is used for error reporting.  DEPRECATED_OK is true if it is
-   ok to use deprecated sections.
+/* A helper function that reads the .gdb_index contents in BUFFER
+   and fills in MAP.  FILENAME is the name of the file containing the
+   index; it is used for error reporting.  DEPRECATED_OK is true if it
+   is ok to use deprecated sections.
 
    CU_LIST, CU_LIST_ELEMENTS, TYPES_LIST, and TYPES_LIST_ELEMENTS are
    out parameters that are filled in with information about the CU and
-   TU lists in the section.
+   TU lists in the index.
 
-   Returns 1 if all went well, 0 otherwise.  */
+   Returns true if all went well, false otherwise.  */
 
 static bool
-read_index_from_section (struct objfile *objfile,
-			 const char *filename,
-			 bool deprecated_ok,
-			 struct dwarf2_section_info *section,
-			 struct mapped_index *map,
-			 const gdb_byte **cu_list,
-			 offset_type *cu_list_elements,
-			 const gdb_byte **types_list,
-			 offset_type *types_list_elements)
-{
-  const gdb_byte *addr;
+read_gdb_index_from_buffer (const char *filename,
+			    bool deprecated_ok,
+			    gdb::array_view<const gdb_byte> buffer,
+			    struct mapped_index *map,
+			    const gdb_byte **cu_list,
+			    offset_type *cu_list_elements,
+			    const gdb_byte **types_list,
+			    offset_type *types_list_elements)
+{
+  const gdb_byte *addr = buffer.data ();
   offset_type version;
   offset_type *metadata;
   int i;
 
-  if (dwarf2_section_empty_p (section))
-    return 0;
-
-  /* Older elfutils strip versions could keep the section in the main
-     executable while splitting it for the separate debug info file.  */
-  if ((get_section_flags (section) & SEC_HAS_CONTENTS) == 0)
-    return 0;
-
-  dwarf2_read_section (objfile, section);
-
-  addr = section->buffer;
   /* Version check.  */
   version = MAYBE_SWAP (*(offset_type *) addr);
   /* Versions earlier than 3 emitted every copy of a psymbol.  This
@@ -3528,11 +3550,45 @@ to use the section anyway."),
   return 1;
 }
 
-/* Read .gdb_index.  If everything went ok, initialize the "quick"
-   elements of all the CUs and return 1.  Otherwise, return 0.  */
+/* Like read_gdb_index_from_buffer, but read the index from SECTION of
+   OBJFILE.  */
+
+static bool
+read_index_from_section (struct objfile *objfile,
+			 const char *filename,
+			 bool deprecated_ok,
+			 struct dwarf2_section_info *section,
+			 struct mapped_index *map,
+			 const gdb_byte **cu_list,
+			 offset_type *cu_list_elements,
+			 const gdb_byte **types_list,
+			 offset_type *types_list_elements)
+{
+  if (dwarf2_section_empty_p (section))
+    return 0;
+
+  /* Older elfutils strip versions could keep the section in the main
+     executable while splitting it for the separate debug info file.  */
+  if ((get_section_flags (section) & SEC_HAS_CONTENTS) == 0)
+    return 0;
+
+  dwarf2_read_section (objfile, section);
+
+  gdb::array_view<const gdb_byte> buffer (section->buffer, section->size);
+  return read_gdb_index_from_buffer (filename, deprecated_ok, buffer, map,
+				     cu_list, cu_list_elements,
+				     types_list, types_list_elements);
+}
+
+/* Read .gdb_index.  If CACHED is not empty, it holds the contents of
+   an index for this objfile found in the index cache, which is read
+   instead of the objfile's section.  If everything went ok,
+   initialize the "quick" elements of all the CUs and return 1.
+   Otherwise, return 0.  */
 
 static int
-dwarf2_read_index (struct dwarf2_per_objfile *dwarf2_per_objfile)
+dwarf2_read_index (struct dwarf2_per_objfile *dwarf2_per_objfile,
+		   gdb::array_view<const gdb_byte> cached = {})
 {
   const gdb_byte *cu_list, *types_list, *dwz_list = NULL;
   offset_type cu_list_elements, types_list_elements, dwz_list_elements = 0;
@@ -3540,11 +3596,22 @@ dwarf2_read_index (struct dwarf2_per_objfile *dwarf2_per_objfile)
   struct objfile *objfile = dwarf2_per_objfile->objfile;
 
   std::unique_ptr<struct mapped_index> map (new struct mapped_index);
-  if (!read_index_from_section (objfile, objfile_name (objfile),
-				use_deprecated_index_sections,
-				&dwarf2_per_objfile->gdb_index, map.get (),
-				&cu_list, &cu_list_elements,
-				&types_list, &types_list_elements))
+  if (!cached.empty ())
+    {
+      /* The cache only holds indices written by this GDB, so there
+	 is no reason to consider them deprecated.  */
+      if (!read_gdb_index_from_buffer (objfile_name (objfile), true,
+				       cached, map.get (),
+				       &cu_list, &cu_list_elements,
+				       &types_list, &types_list_elements))
+	return 0;
+    }
+  else if (!read_index_from_section (objfile, objfile_name (objfile),
+				     use_deprecated_index_sections,
+				     &dwarf2_per_objfile->gdb_index,
+				     map.get (),
+				     &cu_list, &cu_list_elements,
+				     &types_list, &types_list_elements))
     return 0;
 
   /* Don't use the index if it's empty.  */
@@ -4120,6 +4187,91 @@ dw2_expand_symtabs_for_function (struct objfile *objfile,
 
 }
 
+/* True in a worker thread reading the DIEs of a CU for
+   dw2_expand_all_symtabs or dwarf2_expand_all_psymtabs.  */
+
+static thread_local bool preloading_comp_unit;
+
+/* Worker thread function for dw2_expand_all_symtabs and
+   dwarf2_expand_all_psymtabs.  Read the full DIEs of PER_CU, skipping
+   it if it is a partial unit and SKIP_PARTIAL is true.  Return the new
+   dwarf2_cu, which is not in the read_in_chain and not referred to by
+   PER_CU, or NULL if the CU has no DIEs or cannot be read by a worker
+   thread.  */
+
+static struct dwarf2_cu *
+preload_full_comp_unit (struct dwarf2_per_cu_data *per_cu, bool skip_partial)
+{
+  struct dwarf2_cu *cu = NULL;
+
+  preloading_comp_unit = true;
+  TRY
+    {
+      load_full_comp_unit (per_cu, skip_partial, language_minimal);
+      cu = per_cu->cu;
+      if (cu != NULL)
+	dwarf2_find_base_address (cu->dies, cu);
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      /* The main thread reads the CU again, and reports the error
+	 if there is one.  */
+    }
+  END_CATCH
+  preloading_comp_unit = false;
+
+  per_cu->cu = NULL;
+  return cu;
+}
+
+/* Deleter for the dwarf2_cu objects returned by
+   preload_full_comp_unit.  */
+
+struct preloaded_comp_unit_deleter
+{
+  void operator() (struct dwarf2_cu *cu) const
+  {
+    /* The destructor clears PER_CU->CU, which may have been read again
+       since CU was preloaded.  */
+    struct dwarf2_per_cu_data *per_cu = cu->per_cu;
+    struct dwarf2_cu *current = per_cu->cu;
+
+    delete cu;
+    per_cu->cu = current;
+  }
+};
+
+typedef std::unique_ptr<dwarf2_cu, preloaded_comp_unit_deleter>
+  preloaded_comp_unit_up;
+
+/* Make PRELOADED, read by preload_full_comp_unit, the cached CU of its
+   per_cu, unless that CU has been read or expanded in the meantime,
+   as a dependency of another CU.  */
+
+static void
+install_preloaded_comp_unit (preloaded_comp_unit_up preloaded)
+{
+  struct dwarf2_per_cu_data *per_cu = preloaded->per_cu;
+  struct dwarf2_per_objfile *dwarf2_per_objfile = per_cu->dwarf2_per_objfile;
+
+  if (per_cu->cu != NULL
+      || (dwarf2_per_objfile->using_index
+	  ? per_cu->v.quick->compunit_symtab != NULL
+	  : per_cu->v.psymtab->readin))
+    return;
+
+  per_cu->cu = preloaded.release ();
+  per_cu->cu->read_in_chain = dwarf2_per_objfile->read_in_chain;
+  dwarf2_per_objfile->read_in_chain = per_cu;
+}
+
+/* Expand all the CUs of OBJFILE.
+
+   If worker threads are enabled (see "maint set worker-threads"), the
+   DIEs of the CUs are read, a batch at a time, by several threads at
+   once.  The symtabs are then built from those DIEs by the main
+   thread, in CU order, since building them changes the objfile.  */
+
 static void
 dw2_expand_all_symtabs (struct objfile *objfile)
 {
@@ -4127,17 +4279,58 @@ dw2_expand_all_symtabs (struct objfile *objfile)
     = get_dwarf2_per_objfile (objfile);
   int total_units = (dwarf2_per_objfile->all_comp_units.size ()
 		     + dwarf2_per_objfile->all_type_units.size ());
+  unsigned int n_threads = 1;
+
+  if (total_units > 1)
+    n_threads = prepare_worker_threads (dwarf2_per_objfile);
+
+  /* Bound the memory used by the DIEs read in advance.  */
+  const int batch_size = n_threads > 1 ? 16 * n_threads : total_units;
 
-  for (int i = 0; i < total_units; ++i)
+  for (int start = 0; start < total_units; start += batch_size)
     {
-      dwarf2_per_cu_data *per_cu = dwarf2_per_objfile->get_cutu (i);
+      int count = std::min (batch_size, total_units - start);
+      std::vector<preloaded_comp_unit_up> preloaded (count);
+
+      if (n_threads > 1)
+	{
+	  /* Only read the DIEs of the CUs which are not read or
+	     expanded yet.  Type units are read with their type unit
+	     group.  */
+	  std::vector<bool> wanted (count);
+	  for (int i = 0; i < count; ++i)
+	    {
+	      dwarf2_per_cu_data *per_cu
+		= dwarf2_per_objfile->get_cutu (start + i);
 
-      /* We don't want to directly expand a partial CU, because if we
-	 read it with the wrong language, then assertion failures can
-	 be triggered later on.  See PR symtab/23010.  So, tell
-	 dw2_instantiate_symtab to skip partial CUs -- any important
-	 partial CU will be read via DW_TAG_imported_unit anyway.  */
-      dw2_instantiate_symtab (per_cu, true);
+	      wanted[i] = (!per_cu->is_debug_types
+			   && per_cu->cu == NULL
+			   && per_cu->v.quick->compunit_symtab == NULL);
+	    }
+
+	  gdb::parallel_for (n_threads, count, [&] (size_t i)
+	    {
+	      if (wanted[i])
+		preloaded[i].reset (preload_full_comp_unit
+				      (dwarf2_per_objfile->get_cutu (start + i),
+				       true));
+	    });
+	}
+
+      for (int i = 0; i < count; ++i)
+	{
+	  dwarf2_per_cu_data *per_cu = dwarf2_per_objfile->get_cutu (start + i);
+
+	  if (preloaded[i] != NULL)
+	    install_preloaded_comp_unit (std::move (preloaded[i]));
+
+	  /* We don't want to directly expand a partial CU, because if
+	     we read it with the wrong language, then assertion failures
+	     can be triggered later on.  See PR symtab/23010.  So, tell
+	     dw2_instantiate_symtab to skip partial CUs -- any important
+	     partial CU will be read via DW_TAG_imported_unit anyway.  */
+	  dw2_instantiate_symtab (per_cu, true);
+	}
     }
 }
 
@@ -4424,10 +4617,15 @@ mapped_index_base::find_name_components_bounds
   return {lower, upper};
 }
 
+/* The minimum number of symbol names worth giving to a worker thread
+   in build_name_components.  */
+
+static const size_t name_components_min_chunk = 8192;
+
 /* See declaration.  */
 
 void
-mapped_index_base::build_name_components ()
+mapped_index_base::build_name_components (unsigned int n_threads)
 {
   if (!this->name_components.empty ())
     return;
@@ -4436,36 +4634,6 @@ mapped_index_base::build_name_components ()
   auto *name_cmp
     = this->name_components_casing == case_sensitive_on ? strcmp : strcasecmp;
 
-  /* The code below only knows how to break apart components of C++
-     symbol names (and other languages that use '::' as
-     namespace/module separator).  If we add support for wild matching
-     to some language that uses some other operator (E.g., Ada, Go and
-     D use '.'), then we'll need to try splitting the symbol name
-     according to that language too.  Note that Ada does support wild
-     matching, but doesn't currently support .gdb_index.  */
-  auto count = this->symbol_name_count ();
-  for (offset_type idx = 0; idx < count; idx++)
-    {
-      if (this->symbol_name_slot_invalid (idx))
-	continue;
-
-      const char *name = this->symbol_name_at (idx);
-
-      /* Add each name component to the name component table.  */
-      unsigned int previous_len = 0;
-      for (unsigned int current_len = cp_find_first_component (name);
-	   name[current_len] != '\0';
-	   current_len += cp_find_first_component (name + current_len))
-	{
-	  gdb_assert (name[current_len] == ':');
-	  this->name_components.push_back ({previous_len, idx});
-	  /* Skip the '::'.  */
-	  current_len += 2;
-	  previous_len = current_len;
-	}
-      this->name_components.push_back ({previous_len, idx});
-    }
-
   /* Sort name_components elements by name.  */
   auto name_comp_compare = [&] (const name_component &left,
 				const name_component &right)
@@ -4479,9 +4647,86 @@ mapped_index_base::build_name_components ()
       return name_cmp (left_name, right_name) < 0;
     };
 
-  std::sort (this->name_components.begin (),
-	     this->name_components.end (),
-	     name_comp_compare);
+  /* The symbol table is split into chunks of consecutive names, whose
+     name components are found and sorted independently, possibly by
+     worker threads.  The sorted chunks are then merged.  Complaints
+     can only be issued from the main thread, so don't use threads if
+     they are enabled.  */
+  auto count = this->symbol_name_count ();
+  if (n_threads == 0)
+    n_threads = stop_whining > 0 ? 1 : worker_thread_count ();
+  size_t n_chunks = std::min<size_t> (n_threads,
+				      count / name_components_min_chunk);
+  if (n_chunks <= 1)
+    n_chunks = 1;
+  else
+    this->decode_symbol_names ();
+
+  std::vector<std::vector<name_component>> chunks (n_chunks);
+
+  gdb::parallel_for (n_chunks, n_chunks, [&] (size_t chunk)
+    {
+      std::vector<name_component> &components = chunks[chunk];
+      offset_type begin = count * chunk / n_chunks;
+      offset_type end = count * (chunk + 1) / n_chunks;
+
+      /* The code below only knows how to break apart components of
+	 C++ symbol names (and other languages that use '::' as
+	 namespace/module separator).  If we add support for wild
+	 matching to some language that uses some other operator
+	 (E.g., Ada, Go and D use '.'), then we'll need to try
+	 splitting the symbol name according to that language too.
+	 Note that Ada does support wild matching, but doesn't
+	 currently support .gdb_index.  */
+      for (offset_type idx = begin; idx < end; idx++)
+	{
+	  if (this->symbol_name_slot_invalid (idx))
+	    continue;
+
+	  const char *name = this->symbol_name_at (idx);
+
+	  /* Add each name component to the name component table.  */
+	  unsigned int previous_len = 0;
+	  for (unsigned int current_len = cp_find_first_component (name);
+	       name[current_len] != '\0';
+	       current_len += cp_find_first_component (name + current_len))
+	    {
+	      gdb_assert (name[current_len] == ':');
+	      components.push_back ({previous_len, idx});
+	      /* Skip the '::'.  */
+	      current_len += 2;
+	      previous_len = current_len;
+	    }
+	  components.push_back ({previous_len, idx});
+	}
+
+      std::sort (components.begin (), components.end (), name_comp_compare);
+    });
+
+  if (n_chunks == 1)
+    {
+      this->name_components = std::move (chunks[0]);
+      return;
+    }
+
+  size_t total = 0;
+  for (const std::vector<name_component> &components : chunks)
+    total += components.size ();
+  this->name_components.reserve (total);
+
+  for (std::vector<name_component> &components : chunks)
+    {
+      auto middle = this->name_components.size ();
+
+      this->name_components.insert (this->name_components.end (),
+				    components.begin (), components.end ());
+      components.clear ();
+      components.shrink_to_fit ();
+      std::inplace_merge (this->name_components.begin (),
+			  this->name_components.begin () + middle,
+			  this->name_components.end (),
+			  name_comp_compare);
+    }
 }
 
 /* Helper for dw2_expand_symtabs_matching that works with a
@@ -4966,11 +5211,50 @@ test_dw2_expand_symtabs_matching_symbol ()
 #undef CHECK_MATCH
 }
 
+/* Test that building the name components with several threads gives
+   the same table as building it in a single thread.  */
+
+static void
+test_build_name_components_threads ()
+{
+  /* Enough names for build_name_components to split them in several
+     chunks.  */
+  std::vector<std::string> names;
+  for (int i = 0; i < 4 * name_components_min_chunk; ++i)
+    names.push_back (string_printf ("ns%d::cls%d::func%d",
+				    i % 7, (i * 31) % 101, i));
+
+  std::vector<const char *> symbols;
+  for (const std::string &name : names)
+    symbols.push_back (name.c_str ());
+
+  mock_mapped_index serial_index (symbols);
+  serial_index.build_name_components (1);
+
+  mock_mapped_index parallel_index (symbols);
+  parallel_index.build_name_components (4);
+
+  SELF_CHECK (serial_index.name_components.size ()
+	      == parallel_index.name_components.size ());
+
+  for (size_t i = 0; i < serial_index.name_components.size (); ++i)
+    {
+      const name_component &serial = serial_index.name_components[i];
+      const name_component &parallel = parallel_index.name_components[i];
+
+      SELF_CHECK (strcmp (serial_index.symbol_name_at (serial.idx)
+			  + serial.name_offset,
+			  parallel_index.symbol_name_at (parallel.idx)
+			  + parallel.name_offset) == 0);
+    }
+}
+
 static void
 run_test ()
 {
   test_mapped_index_find_name_component_bounds ();
   test_dw2_expand_symtabs_matching_symbol ();
+  test_build_name_components_threads ();
 }
 
 }} // namespace selftests::dw2_expand_symtabs_matching
@@ -5707,13 +5991,37 @@ private:
 const char *
 mapped_debug_names::namei_to_name (uint32_t namei) const
 {
-  const ULONGEST namei_string_offs
-    = extract_unsigned_integer ((name_table_string_offs_reordered
-				 + namei * offset_size),
-				offset_size,
-				dwarf5_byte_order);
-  return read_indirect_string_at_offset
-    (dwarf2_per_objfile, dwarf2_per_objfile->objfile->obfd, namei_string_offs);
+  if (name_strings.empty ())
+    name_strings.resize (name_count);
+
+  const char *&name = name_strings[namei];
+  if (name == NULL)
+    {
+      const ULONGEST namei_string_offs
+	= extract_unsigned_integer ((name_table_string_offs_reordered
+				     + namei * offset_size),
+				    offset_size,
+				    dwarf5_byte_order);
+      name = read_indirect_string_at_offset
+	(dwarf2_per_objfile, dwarf2_per_objfile->objfile->obfd,
+	 namei_string_offs);
+
+      /* read_indirect_string_at_offset returns NULL for an empty
+	 string, which callers are not prepared for.  */
+      if (name == NULL)
+	name = "";
+    }
+
+  return name;
+}
+
+/* See declaration.  */
+
+void
+mapped_debug_names::decode_symbol_names ()
+{
+  for (uint32_t namei = 0; namei < name_count; ++namei)
+    namei_to_name (namei);
 }
 
 /* Find a slot in .debug_names for the object named NAME.  If NAME is
@@ -6204,6 +6512,34 @@ dwarf2_initialize_objfile (struct objfile *objfile, dw_index_kind *index_kind)
       return true;
     }
 
+  /* Objfiles using a dwz file are never stored in the index cache,
+     see dwarf2_build_psymtabs.  */
+  if (global_index_cache.enabled ()
+      && dwarf2_get_dwz_file (dwarf2_per_objfile) == NULL)
+    {
+      const bfd_build_id *build_id = build_id_bfd_get (objfile->obfd);
+
+      if (build_id != NULL)
+	{
+	  gdb::array_view<const gdb_byte> cached
+	    = global_index_cache.lookup_gdb_index
+		(build_id, &dwarf2_per_objfile->index_cache_res);
+
+	  if (!cached.empty ()
+	      && dwarf2_read_index (dwarf2_per_objfile, cached))
+	    {
+	      global_index_cache.hit ();
+	      *index_kind = dw_index_kind::GDB_INDEX;
+	      return true;
+	    }
+
+	  /* Don't keep a mapping of an index we could not use.  */
+	  dwarf2_per_objfile->index_cache_res.reset ();
+	}
+
+      global_index_cache.miss ();
+    }
+
   return false;
 }
 
@@ -6229,6 +6565,11 @@ dwarf2_build_psymtabs (struct objfile *objfile)
       psymtab_discarder psymtabs (objfile);
       dwarf2_build_psymtabs_hard (dwarf2_per_objfile);
       psymtabs.keep ();
+
+      /* The index cache does not know about dwz files, so it would
+	 only hold half of the index of such objfiles.  */
+      if (dwarf2_get_dwz_file (dwarf2_per_objfile) == NULL)
+	global_index_cache.store (dwarf2_per_objfile);
     }
   CATCH (except, RETURN_MASK_ERROR)
     {
@@ -7558,6 +7899,11 @@ init_cutu_and_read_dies (struct dwarf2_per_cu_data *this_cu,
 		     sect_offset_str (this_cu->sect_off),
 		     bfd_get_filename (abfd));
 	}
+      /* Looking up the DWO file changes the objfile.  */
+      if (preloading_comp_unit)
+	throw_error (NOT_SUPPORTED_ERROR,
+		     _("cannot read DWO file in a worker thread"));
+
       dwo_unit = lookup_dwo_unit (this_cu, comp_unit_die);
       if (dwo_unit != NULL)
 	{
@@ -7588,10 +7934,15 @@ init_cutu_and_read_dies (struct dwarf2_per_cu_data *this_cu,
   /* Done, clean up.  */
   if (new_cu != NULL && keep)
     {
-      /* Link this CU into read_in_chain.  */
-      this_cu->cu->read_in_chain = dwarf2_per_objfile->read_in_chain;
-      dwarf2_per_objfile->read_in_chain = this_cu;
-      /* The chain owns it now.  */
+      /* Link this CU into read_in_chain.  A CU read by a worker thread
+	 is linked in later by the main thread, see
+	 install_preloaded_comp_unit.  */
+      if (!preloading_comp_unit)
+	{
+	  this_cu->cu->read_in_chain = dwarf2_per_objfile->read_in_chain;
+	  dwarf2_per_objfile->read_in_chain = this_cu;
+	}
+      /* The chain, or the worker thread, owns it now.  */
       new_cu.release ();
     }
 }
@@ -7841,6 +8192,155 @@ get_type_unit_group (struct dwarf2_cu *cu, const struct attribute *stmt_list)
 
 /* Partial symbol tables.  */
 
+/* A partial symbol recorded by a worker thread.  The arguments to
+   add_psymbol_to_list, except for the list, language and objfile.  */
+
+struct deferred_psymbol
+{
+  const char *name;
+  int namelength;
+  int copy_name;
+  domain_enum domain;
+  enum address_class theclass;
+
+  /* True for objfile->global_psymbols, false for
+     objfile->static_psymbols.  */
+  bool is_global;
+
+  CORE_ADDR coreaddr;
+};
+
+/* When the partial symbols of a CU are read by a worker thread, the
+   changes that would be made to the objfile are recorded in an object
+   of this type, and made by the main thread afterwards.  See
+   process_psymtab_comp_units.  */
+
+struct deferred_psymtab
+{
+  /* True if the CU was read, false if there is nothing to add, e.g.
+     because the CU is a partial unit.  */
+  bool read = false;
+
+  /* True if the CU must be read again by the main thread; see
+     cannot_defer_psymtab.  */
+  bool failed = false;
+
+  /* Stands in for the psymtab of the CU.  Only FILENAME, DIRNAME,
+     TEXTLOW and TEXTHIGH are set.  */
+  struct partial_symtab pst {};
+
+  /* The language of the CU.  */
+  enum language language = language_unknown;
+
+  /* The ranges for the psymtab address map, in the order they were
+     found.  */
+  std::vector<std::pair<CORE_ADDR, CORE_ADDR>> ranges;
+
+  /* The partial symbols, in the order they were found.  */
+  std::vector<deferred_psymbol> psymbols;
+
+  /* The name and language of the main program, if the CU has a
+     DW_AT_main_subprogram.  */
+  const char *main_name = nullptr;
+  enum language main_language = language_unknown;
+
+  /* The files included by the CU, for the include psymtabs.  */
+  std::vector<const char *> include_names;
+
+  /* Storage for the names which must be copied.  */
+  auto_obstack storage;
+};
+
+#if CXX_STD_THREAD
+/* Worker threads reading partial symbols hold this while they allocate
+   from the objfile's storage obstack, or call the demangler.  */
+static std::mutex psymtab_storage_mutex;
+#endif
+
+/* Hold psymtab_storage_mutex, if there is one, for the lifetime of
+   the object.  */
+
+class scoped_psymtab_storage_lock
+{
+public:
+
+  scoped_psymtab_storage_lock ()
+  {
+#if CXX_STD_THREAD
+    psymtab_storage_mutex.lock ();
+#endif
+  }
+
+  ~scoped_psymtab_storage_lock ()
+  {
+#if CXX_STD_THREAD
+    psymtab_storage_mutex.unlock ();
+#endif
+  }
+
+  DISABLE_COPY_AND_ASSIGN (scoped_psymtab_storage_lock);
+};
+
+/* Report that CU needs something which a worker thread cannot do,
+   such as reading another CU.  If CU is being read by a worker
+   thread, this throws an error, and the CU is read again in the main
+   thread.  Otherwise this does nothing.  */
+
+static void
+cannot_defer_psymtab (struct dwarf2_cu *cu)
+{
+  if (cu->deferred_psymtab != NULL)
+    throw_error (NOT_SUPPORTED_ERROR,
+		 _("cannot read CU at %s in a worker thread"),
+		 sect_offset_str (cu->per_cu->sect_off));
+}
+
+/* Add a partial symbol from CU to LIST, which is either the global or
+   the static partial symbols of the objfile of CU.  The arguments are
+   as for add_psymbol_to_list.  */
+
+static void
+dwarf2_add_psymbol (struct dwarf2_cu *cu, const char *name, int namelength,
+		    int copy_name, domain_enum domain,
+		    enum address_class theclass,
+		    std::vector<partial_symbol *> *list, CORE_ADDR coreaddr)
+{
+  struct objfile *objfile = cu->per_cu->dwarf2_per_objfile->objfile;
+  struct deferred_psymtab *deferred = cu->deferred_psymtab;
+
+  if (deferred == NULL)
+    {
+      add_psymbol_to_list (name, namelength, copy_name, domain, theclass,
+			   list, coreaddr, cu->language, objfile);
+      return;
+    }
+
+  /* NAME may not outlive this call if it must be copied.  */
+  if (copy_name)
+    name = (const char *) obstack_copy0 (&deferred->storage, name,
+					 namelength);
+
+  deferred->psymbols.push_back ({ name, namelength, copy_name, domain,
+				  theclass, list == &objfile->global_psymbols,
+				  coreaddr });
+}
+
+/* Map the addresses LOW to HIGH, inclusive, to PST, the psymtab of CU,
+   in the psymtab address map of the objfile, unless they are mapped
+   already.  */
+
+static void
+dwarf2_psymtabs_addrmap_set (struct dwarf2_cu *cu, CORE_ADDR low,
+			     CORE_ADDR high, struct partial_symtab *pst)
+{
+  struct objfile *objfile = cu->per_cu->dwarf2_per_objfile->objfile;
+
+  if (cu->deferred_psymtab != NULL)
+    cu->deferred_psymtab->ranges.emplace_back (low, high);
+  else
+    addrmap_set_empty (objfile->psymtabs_addrmap, low, high, pst);
+}
+
 /* Create a psymtab named NAME and assign it to PER_CU.
 
    The caller must fill in the following details:
@@ -7879,6 +8379,11 @@ struct process_psymtab_comp_unit_data
      language.  */
 
   enum language pretend_language;
+
+  /* If not NULL, the CU is being read by a worker thread, and the
+     psymtab is recorded here instead of being created.  */
+
+  struct deferred_psymtab *deferred;
 };
 
 /* die_reader_func for process_psymtab_comp_unit.  */
@@ -7907,16 +8412,37 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
 
   gdb_assert (! per_cu->is_debug_types);
 
+  if (info->deferred != NULL)
+    {
+      cu->deferred_psymtab = info->deferred;
+
+      /* init_cutu_and_read_dies_simple does not do this.  */
+      per_cu->dwarf_version = cu->header.version;
+
+      /* Nor does it read the DWO file.  */
+      if (dwarf2_attr (comp_unit_die, DW_AT_GNU_dwo_name, cu) != NULL)
+	cannot_defer_psymtab (cu);
+    }
+
   prepare_one_comp_unit (cu, comp_unit_die, info->pretend_language);
 
   cu->list_in_scope = &file_symbols;
 
+  if (info->deferred != NULL)
+    info->deferred->language = cu->language;
+
   /* Allocate a new partial symbol table structure.  */
   filename = dwarf2_string_attr (comp_unit_die, DW_AT_name, cu);
   if (filename == NULL)
     filename = "";
 
-  pst = create_partial_symtab (per_cu, filename);
+  if (info->deferred != NULL)
+    {
+      pst = &info->deferred->pst;
+      pst->filename = filename;
+    }
+  else
+    pst = create_partial_symtab (per_cu, filename);
 
   /* This must be done before calling dwarf2_build_include_psymtabs.  */
   pst->dirname = dwarf2_string_attr (comp_unit_die, DW_AT_comp_dir, cu);
@@ -7932,12 +8458,14 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
   if (cu_bounds_kind == PC_BOUNDS_HIGH_LOW && best_lowpc < best_highpc)
     /* Store the contiguous range if it is not empty; it can be empty for
        CUs with no code.  */
-    addrmap_set_empty (objfile->psymtabs_addrmap,
-		       gdbarch_adjust_dwarf2_addr (gdbarch,
-						   best_lowpc + baseaddr),
-		       gdbarch_adjust_dwarf2_addr (gdbarch,
-						   best_highpc + baseaddr) - 1,
-		       pst);
+    dwarf2_psymtabs_addrmap_set (cu,
+				 gdbarch_adjust_dwarf2_addr (gdbarch,
+							     best_lowpc
+							     + baseaddr),
+				 gdbarch_adjust_dwarf2_addr (gdbarch,
+							     best_highpc
+							     + baseaddr) - 1,
+				 pst);
 
   /* Check if comp unit has_children.
      If so, read the rest of the partial symbols from this comp unit.
@@ -7971,7 +8499,8 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
   pst->textlow = gdbarch_adjust_dwarf2_addr (gdbarch, best_lowpc + baseaddr);
   pst->texthigh = gdbarch_adjust_dwarf2_addr (gdbarch, best_highpc + baseaddr);
 
-  end_psymtab_common (objfile, pst);
+  if (info->deferred == NULL)
+    end_psymtab_common (objfile, pst);
 
   if (!VEC_empty (dwarf2_per_cu_ptr, cu->per_cu->imported_symtabs))
     {
@@ -7997,7 +8526,9 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
      and build a psymtab for each of them.  */
   dwarf2_build_include_psymtabs (cu, comp_unit_die, pst);
 
-  if (dwarf_read_debug)
+  if (info->deferred != NULL)
+    info->deferred->read = true;
+  else if (dwarf_read_debug)
     {
       struct gdbarch *gdbarch = get_objfile_arch (objfile);
 
@@ -8036,6 +8567,7 @@ process_psymtab_comp_unit (struct dwarf2_per_cu_data *this_cu,
       process_psymtab_comp_unit_data info;
       info.want_partial_unit = want_partial_unit;
       info.pretend_language = pretend_language;
+      info.deferred = NULL;
       init_cutu_and_read_dies (this_cu, NULL, 0, 0, false,
 			       process_psymtab_comp_unit_reader, &info);
     }
@@ -8044,6 +8576,182 @@ process_psymtab_comp_unit (struct dwarf2_per_cu_data *this_cu,
   age_cached_comp_units (this_cu->dwarf2_per_objfile);
 }
 
+/* Create the psymtab of PER_CU from DEFERRED, which was filled in by a
+   worker thread.  This makes the same changes to the objfile, in the
+   same order, as process_psymtab_comp_unit would have.  */
+
+static void
+apply_deferred_psymtab (struct dwarf2_per_cu_data *per_cu,
+			struct deferred_psymtab *deferred)
+{
+  struct objfile *objfile = per_cu->dwarf2_per_objfile->objfile;
+  struct partial_symtab *pst;
+
+  pst = create_partial_symtab (per_cu, deferred->pst.filename);
+  pst->dirname = deferred->pst.dirname;
+
+  for (const auto &range : deferred->ranges)
+    addrmap_set_empty (objfile->psymtabs_addrmap, range.first, range.second,
+		       pst);
+
+  for (const deferred_psymbol &psym : deferred->psymbols)
+    add_psymbol_to_list (psym.name, psym.namelength, psym.copy_name,
+			 psym.domain, psym.theclass,
+			 (psym.is_global
+			  ? &objfile->global_psymbols
+			  : &objfile->static_psymbols),
+			 psym.coreaddr, deferred->language, objfile);
+
+  if (deferred->main_name != NULL)
+    set_objfile_main_name (objfile, deferred->main_name,
+			   deferred->main_language);
+
+  pst->textlow = deferred->pst.textlow;
+  pst->texthigh = deferred->pst.texthigh;
+
+  end_psymtab_common (objfile, pst);
+
+  for (const char *include_name : deferred->include_names)
+    dwarf2_create_include_psymtab (include_name, pst, objfile);
+}
+
+/* Worker thread function for process_psymtab_comp_units.  Read the
+   partial symbols of PER_CU into DEFERRED.  */
+
+static void
+read_deferred_psymtab (struct dwarf2_per_cu_data *per_cu,
+		       struct deferred_psymtab *deferred)
+{
+  process_psymtab_comp_unit_data info;
+
+  info.want_partial_unit = 0;
+  info.pretend_language = language_minimal;
+  info.deferred = deferred;
+
+  TRY
+    {
+      init_cutu_and_read_dies_simple (per_cu,
+				      process_psymtab_comp_unit_reader,
+				      &info);
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      deferred->failed = true;
+    }
+  END_CATCH
+}
+
+/* Return the number of threads which may read the DIEs of the CUs of
+   DWARF2_PER_OBJFILE at once, or 1 if the main thread must read them
+   all.  If threads may be used, also read the sections the workers
+   need, since reading a section is not thread safe.  */
+
+static unsigned int
+prepare_worker_threads (struct dwarf2_per_objfile *dwarf2_per_objfile)
+{
+  struct objfile *objfile = dwarf2_per_objfile->objfile;
+  unsigned int n_threads = worker_thread_count ();
+
+  /* Complaints and debug output are printed as they are found, so
+     keep their order by not using threads at all.  DWZ files are read
+     lazily, and so are not supported either.  */
+  if (n_threads <= 1
+      || stop_whining > 0
+      || dwarf_read_debug
+      || dwarf_die_debug
+      || dwarf_line_debug
+      || dwarf2_get_dwz_file (dwarf2_per_objfile) != NULL)
+    return 1;
+
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->info);
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->abbrev);
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->str);
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->line_str);
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->line);
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->ranges);
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->rnglists);
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->addr);
+
+  return n_threads;
+}
+
+/* Subroutine of dwarf2_build_psymtabs_hard to simplify it.
+   Process all the compilation units for psymtabs.
+
+   If worker threads are enabled (see "maint set worker-threads"), the
+   DIEs of the CUs are read, a batch at a time, by several threads at
+   once.  The workers do not change the objfile: they record what they
+   found in a deferred_psymtab, and the main thread then creates the
+   psymtabs in CU order, so that the result is the same as reading the
+   CUs one at a time.  A CU which needs more than its own DIEs, e.g.
+   because it imports a partial unit or refers to a DIE in another CU,
+   is read again by the main thread.  */
+
+static void
+process_psymtab_comp_units (struct dwarf2_per_objfile *dwarf2_per_objfile)
+{
+  const std::vector<dwarf2_per_cu_data *> &all_comp_units
+    = dwarf2_per_objfile->all_comp_units;
+  unsigned int n_threads = 1;
+
+  if (all_comp_units.size () > 1)
+    n_threads = prepare_worker_threads (dwarf2_per_objfile);
+
+  if (n_threads <= 1)
+    {
+      for (dwarf2_per_cu_data *per_cu : all_comp_units)
+	process_psymtab_comp_unit (per_cu, 0, language_minimal);
+      return;
+    }
+
+  /* Bound the memory used by the deferred psymtabs.  */
+  const size_t batch_size = 64 * n_threads;
+
+  for (size_t start = 0; start < all_comp_units.size (); start += batch_size)
+    {
+      size_t count = std::min (batch_size, all_comp_units.size () - start);
+      std::unique_ptr<deferred_psymtab[]> deferred
+	(new deferred_psymtab[count]);
+
+      /* A CU which is in the cache, having been read as a dependency
+	 of an earlier CU, must be read again in the main thread; see
+	 process_psymtab_comp_unit.  So must type units.  */
+      for (size_t i = 0; i < count; ++i)
+	{
+	  dwarf2_per_cu_data *per_cu = all_comp_units[start + i];
+
+	  if (per_cu->cu != NULL || per_cu->is_debug_types)
+	    deferred[i].failed = true;
+	}
+
+      gdb::parallel_for (n_threads, count, [&] (size_t i)
+	{
+	  if (!deferred[i].failed)
+	    read_deferred_psymtab (all_comp_units[start + i], &deferred[i]);
+	});
+
+      for (size_t i = 0; i < count; ++i)
+	{
+	  dwarf2_per_cu_data *per_cu = all_comp_units[start + i];
+
+	  if (deferred[i].failed)
+	    process_psymtab_comp_unit (per_cu, 0, language_minimal);
+	  else
+	    {
+	      /* An earlier CU in this batch may have read this one as a
+		 dependency.  */
+	      if (per_cu->cu != NULL)
+		free_one_cached_comp_unit (per_cu);
+
+	      if (deferred[i].read)
+		apply_deferred_psymtab (per_cu, &deferred[i]);
+
+	      age_cached_comp_units (dwarf2_per_objfile);
+	    }
+	}
+    }
+}
+
 /* Reader function for build_type_psymtabs.  */
 
 static void
@@ -8397,8 +9105,7 @@ dwarf2_build_psymtabs_hard (struct dwarf2_per_objfile *dwarf2_per_objfile)
     = make_scoped_restore (&objfile->psymtabs_addrmap,
 			   addrmap_create_mutable (&temp_obstack));
 
-  for (dwarf2_per_cu_data *per_cu : dwarf2_per_objfile->all_comp_units)
-    process_psymtab_comp_unit (per_cu, 0, language_minimal);
+  process_psymtab_comp_units (dwarf2_per_objfile);
 
   /* This has to wait until we read the CUs, we need the list of DWOs.  */
   process_skeletonless_type_units (dwarf2_per_objfile);
@@ -8616,6 +9323,8 @@ scan_partial_symbols (struct partial_die_info *first_die, CORE_ADDR *lowpc,
 			   objfile_name (cu->per_cu->dwarf2_per_objfile->objfile));
 		  }
 
+		cannot_defer_psymtab (cu);
+
 		per_cu = dwarf2_find_containing_comp_unit
 			   (pdi->d.sect_off, pdi->is_dwz,
 			    cu->per_cu->dwarf2_per_objfile);
@@ -8755,6 +9464,8 @@ partial_die_full_name (struct partial_die_info *pdi,
 
       if (pdi->name != NULL && strchr (pdi->name, '<') == NULL)
 	{
+	  cannot_defer_psymtab (cu);
+
 	  struct die_info *die;
 	  struct attribute attr;
 	  struct dwarf2_cu *ref_cu = cu;
@@ -8808,23 +9519,34 @@ add_partial_symbol (struct partial_die_info *pdi, struct dwarf2_cu *cu)
              of the global scope.  But in Ada, we want to be able to access
              nested procedures globally.  So all Ada subprograms are stored
              in the global scope.  */
-	  add_psymbol_to_list (actual_name, strlen (actual_name),
-			       built_actual_name != NULL,
-			       VAR_DOMAIN, LOC_BLOCK,
-			       &objfile->global_psymbols,
-			       addr, cu->language, objfile);
+	  dwarf2_add_psymbol (cu, actual_name, strlen (actual_name),
+				  built_actual_name != NULL,
+				  VAR_DOMAIN, LOC_BLOCK,
+				  &objfile->global_psymbols,
+				  addr);
 	}
       else
 	{
-	  add_psymbol_to_list (actual_name, strlen (actual_name),
-			       built_actual_name != NULL,
-			       VAR_DOMAIN, LOC_BLOCK,
-			       &objfile->static_psymbols,
-			       addr, cu->language, objfile);
+	  dwarf2_add_psymbol (cu, actual_name, strlen (actual_name),
+				  built_actual_name != NULL,
+				  VAR_DOMAIN, LOC_BLOCK,
+				  &objfile->static_psymbols,
+				  addr);
 	}
 
       if (pdi->main_subprogram && actual_name != NULL)
-	set_objfile_main_name (objfile, actual_name, cu->language);
+	{
+	  struct deferred_psymtab *deferred = cu->deferred_psymtab;
+
+	  if (deferred != NULL)
+	    {
+	      deferred->main_name
+		= obstack_strdup (&deferred->storage, actual_name);
+	      deferred->main_language = cu->language;
+	    }
+	  else
+	    set_objfile_main_name (objfile, actual_name, cu->language);
+	}
       break;
     case DW_TAG_constant:
       {
@@ -8834,9 +9556,9 @@ add_partial_symbol (struct partial_die_info *pdi, struct dwarf2_cu *cu)
 	  list = &objfile->global_psymbols;
 	else
 	  list = &objfile->static_psymbols;
-	add_psymbol_to_list (actual_name, strlen (actual_name),
-			     built_actual_name != NULL, VAR_DOMAIN, LOC_STATIC,
-			     list, 0, cu->language, objfile);
+	dwarf2_add_psymbol (cu, actual_name, strlen (actual_name),
+				built_actual_name != NULL, VAR_DOMAIN,
+				LOC_STATIC, list, 0);
       }
       break;
     case DW_TAG_variable:
@@ -8868,12 +9590,11 @@ add_partial_symbol (struct partial_die_info *pdi, struct dwarf2_cu *cu)
 	     table building.  */
 
 	  if (pdi->d.locdesc || pdi->has_type)
-	    add_psymbol_to_list (actual_name, strlen (actual_name),
-				 built_actual_name != NULL,
-				 VAR_DOMAIN, LOC_STATIC,
-				 &objfile->global_psymbols,
-				 addr + baseaddr,
-				 cu->language, objfile);
+	    dwarf2_add_psymbol (cu, actual_name, strlen (actual_name),
+				    built_actual_name != NULL,
+				    VAR_DOMAIN, LOC_STATIC,
+				    &objfile->global_psymbols,
+				    addr + baseaddr);
 	}
       else
 	{
@@ -8887,37 +9608,36 @@ add_partial_symbol (struct partial_die_info *pdi, struct dwarf2_cu *cu)
 	      return;
 	    }
 
-	  add_psymbol_to_list (actual_name, strlen (actual_name),
-			       built_actual_name != NULL,
-			       VAR_DOMAIN, LOC_STATIC,
-			       &objfile->static_psymbols,
-			       has_loc ? addr + baseaddr : (CORE_ADDR) 0,
-			       cu->language, objfile);
+	  dwarf2_add_psymbol (cu, actual_name, strlen (actual_name),
+				  built_actual_name != NULL,
+				  VAR_DOMAIN, LOC_STATIC,
+				  &objfile->static_psymbols,
+				  has_loc ? addr + baseaddr : (CORE_ADDR) 0);
 	}
       break;
     case DW_TAG_typedef:
     case DW_TAG_base_type:
     case DW_TAG_subrange_type:
-      add_psymbol_to_list (actual_name, strlen (actual_name),
-			   built_actual_name != NULL,
-			   VAR_DOMAIN, LOC_TYPEDEF,
-			   &objfile->static_psymbols,
-			   0, cu->language, objfile);
+      dwarf2_add_psymbol (cu, actual_name, strlen (actual_name),
+			      built_actual_name != NULL,
+			      VAR_DOMAIN, LOC_TYPEDEF,
+			      &objfile->static_psymbols,
+			      0);
       break;
     case DW_TAG_imported_declaration:
     case DW_TAG_namespace:
-      add_psymbol_to_list (actual_name, strlen (actual_name),
-			   built_actual_name != NULL,
-			   VAR_DOMAIN, LOC_TYPEDEF,
-			   &objfile->global_psymbols,
-			   0, cu->language, objfile);
+      dwarf2_add_psymbol (cu, actual_name, strlen (actual_name),
+			      built_actual_name != NULL,
+			      VAR_DOMAIN, LOC_TYPEDEF,
+			      &objfile->global_psymbols,
+			      0);
       break;
     case DW_TAG_module:
-      add_psymbol_to_list (actual_name, strlen (actual_name),
-			   built_actual_name != NULL,
-			   MODULE_DOMAIN, LOC_TYPEDEF,
-			   &objfile->global_psymbols,
-			   0, cu->language, objfile);
+      dwarf2_add_psymbol (cu, actual_name, strlen (actual_name),
+			      built_actual_name != NULL,
+			      MODULE_DOMAIN, LOC_TYPEDEF,
+			      &objfile->global_psymbols,
+			      0);
       break;
     case DW_TAG_class_type:
     case DW_TAG_interface_type:
@@ -8937,23 +9657,23 @@ add_partial_symbol (struct partial_die_info *pdi, struct dwarf2_cu *cu)
 
       /* NOTE: carlton/2003-10-07: See comment in new_symbol about
 	 static vs. global.  */
-      add_psymbol_to_list (actual_name, strlen (actual_name),
-			   built_actual_name != NULL,
-			   STRUCT_DOMAIN, LOC_TYPEDEF,
-			   cu->language == language_cplus
-			   ? &objfile->global_psymbols
-			   : &objfile->static_psymbols,
-			   0, cu->language, objfile);
+      dwarf2_add_psymbol (cu, actual_name, strlen (actual_name),
+			      built_actual_name != NULL,
+			      STRUCT_DOMAIN, LOC_TYPEDEF,
+			      cu->language == language_cplus
+			      ? &objfile->global_psymbols
+			      : &objfile->static_psymbols,
+			      0);
 
       break;
     case DW_TAG_enumerator:
-      add_psymbol_to_list (actual_name, strlen (actual_name),
-			   built_actual_name != NULL,
-			   VAR_DOMAIN, LOC_CONST,
-			   cu->language == language_cplus
-			   ? &objfile->global_psymbols
-			   : &objfile->static_psymbols,
-			   0, cu->language, objfile);
+      dwarf2_add_psymbol (cu, actual_name, strlen (actual_name),
+			      built_actual_name != NULL,
+			      VAR_DOMAIN, LOC_CONST,
+			      cu->language == language_cplus
+			      ? &objfile->global_psymbols
+			      : &objfile->static_psymbols,
+			      0);
       break;
     default:
       break;
@@ -9036,8 +9756,8 @@ add_partial_subprogram (struct partial_die_info *pdi,
 						  pdi->lowpc + baseaddr);
 	      highpc = gdbarch_adjust_dwarf2_addr (gdbarch,
 						   pdi->highpc + baseaddr);
-	      addrmap_set_empty (objfile->psymtabs_addrmap, lowpc, highpc - 1,
-				 cu->per_cu->v.psymtab);
+	      dwarf2_psymtabs_addrmap_set (cu, lowpc, highpc - 1,
+					   cu->per_cu->v.psymtab);
 	    }
         }
 
@@ -9357,6 +10077,93 @@ dwarf2_read_symtab (struct partial_symtab *self,
 
   process_cu_includes (dwarf2_per_objfile);
 }
+
+/* See symfile.h.
+
+   This is the psymtab version of dw2_expand_all_symtabs: the DIEs of
+   a batch of CUs are read by worker threads, and the main thread then
+   expands their psymtabs one at a time.  */
+
+void
+dwarf2_expand_all_psymtabs (struct objfile *objfile)
+{
+  struct dwarf2_per_objfile *dwarf2_per_objfile
+    = get_dwarf2_per_objfile (objfile);
+
+  if (dwarf2_per_objfile == NULL
+      || dwarf2_per_objfile->using_index
+      || dwarf2_per_objfile->all_comp_units.size () <= 1)
+    return;
+
+  unsigned int n_threads = prepare_worker_threads (dwarf2_per_objfile);
+  if (n_threads <= 1)
+    return;
+
+  /* Expand the psymtabs in the order psym_expand_all_symtabs would,
+     that of the objfile's list, so that the symtabs come out the same.
+     New psymtabs go to the front of that list, so this is the reverse
+     of the CU order.  */
+  const std::vector<dwarf2_per_cu_data *> units
+    (dwarf2_per_objfile->all_comp_units.rbegin (),
+     dwarf2_per_objfile->all_comp_units.rend ());
+  const int total_units = units.size ();
+
+  /* Bound the memory used by the DIEs read in advance.  */
+  const int batch_size = 16 * n_threads;
+
+  /* The workers read full DIEs, as dwarf2_read_symtab does.  */
+  dwarf2_per_objfile->reading_partial_symbols = 0;
+
+  for (int start = 0; start < total_units; start += batch_size)
+    {
+      int count = std::min (batch_size, total_units - start);
+      std::vector<preloaded_comp_unit_up> preloaded (count);
+
+      /* Only read the DIEs of the CUs whose psymtabs are not expanded
+	 yet.  A psymtab with a user, i.e. that of a partial unit, is
+	 expanded with its user.  */
+      std::vector<bool> wanted (count);
+      for (int i = 0; i < count; ++i)
+	{
+	  dwarf2_per_cu_data *per_cu = units[start + i];
+	  struct partial_symtab *pst = per_cu->v.psymtab;
+
+	  wanted[i] = (pst != NULL
+		       && !pst->readin
+		       && pst->user == NULL
+		       && per_cu->cu == NULL);
+	}
+
+      gdb::parallel_for (n_threads, count, [&] (size_t i)
+	{
+	  if (wanted[i])
+	    preloaded[i].reset (preload_full_comp_unit
+				  (units[start + i], false));
+	});
+
+      for (int i = 0; i < count; ++i)
+	{
+	  struct partial_symtab *pst = units[start + i]->v.psymtab;
+
+	  if (preloaded[i] != NULL)
+	    install_preloaded_comp_unit (std::move (preloaded[i]));
+
+	  if (pst == NULL)
+	    continue;
+
+	  /* The same as psymtab_to_symtab.  */
+	  while (pst->user != NULL)
+	    pst = pst->user;
+
+	  if (!pst->readin)
+	    {
+	      scoped_restore decrementer = increment_reading_symtab ();
+
+	      dwarf2_read_symtab (pst, objfile);
+	    }
+	}
+    }
+}
 
 /* Reading in full CUs.  */
 
@@ -14464,8 +15271,7 @@ dwarf2_ranges_read (unsigned offset, CORE_ADDR *low_return,
 					      range_beginning + baseaddr);
 	  highpc = gdbarch_adjust_dwarf2_addr (gdbarch,
 					       range_end + baseaddr);
-	  addrmap_set_empty (objfile->psymtabs_addrmap, lowpc, highpc - 1,
-			     ranges_pst);
+	  dwarf2_psymtabs_addrmap_set (cu, lowpc, highpc - 1, ranges_pst);
 	}
 
       /* FIXME: This is recording everything as a low-high
@@ -18208,10 +19014,10 @@ load_partial_dies (const struct die_reader_specs *reader,
 	      || pdi.tag == DW_TAG_subrange_type))
 	{
 	  if (building_psymtab && pdi.name != NULL)
-	    add_psymbol_to_list (pdi.name, strlen (pdi.name), 0,
-				 VAR_DOMAIN, LOC_TYPEDEF,
-				 &objfile->static_psymbols,
-				 0, cu->language, objfile);
+	    dwarf2_add_psymbol (cu, pdi.name, strlen (pdi.name), 0,
+				    VAR_DOMAIN, LOC_TYPEDEF,
+				    &objfile->static_psymbols,
+				    0);
 	  info_ptr = locate_pdi_sibling (reader, &pdi, info_ptr);
 	  continue;
 	}
@@ -18242,12 +19048,12 @@ load_partial_dies (const struct die_reader_specs *reader,
 	  if (pdi.name == NULL)
 	    complaint (_("malformed enumerator DIE ignored"));
 	  else if (building_psymtab)
-	    add_psymbol_to_list (pdi.name, strlen (pdi.name), 0,
-				 VAR_DOMAIN, LOC_CONST,
-				 cu->language == language_cplus
-				 ? &objfile->global_psymbols
-				 : &objfile->static_psymbols,
-				 0, cu->language, objfile);
+	    dwarf2_add_psymbol (cu, pdi.name, strlen (pdi.name), 0,
+				    VAR_DOMAIN, LOC_CONST,
+				    cu->language == language_cplus
+				    ? &objfile->global_psymbols
+				    : &objfile->static_psymbols,
+				    0);
 
 	  info_ptr = locate_pdi_sibling (reader, &pdi, info_ptr);
 	  continue;
@@ -18618,6 +19424,7 @@ find_partial_die (sect_offset sect_off, int offset_in_dwz, struct dwarf2_cu *cu)
 		 sect_offset_str (cu->header.sect_off), sect_offset_str (sect_off),
 		 bfd_get_filename (objfile->obfd));
 	}
+      cannot_defer_psymtab (cu);
       per_cu = dwarf2_find_containing_comp_unit (sect_off, offset_in_dwz,
 						 dwarf2_per_objfile);
 
@@ -18633,6 +19440,7 @@ find_partial_die (sect_offset sect_off, int offset_in_dwz, struct dwarf2_cu *cu)
 
   if (pd == NULL && per_cu->load_all_dies == 0)
     {
+      cannot_defer_psymtab (cu);
       per_cu->load_all_dies = 1;
 
       /* This is nasty.  When we reread the DIEs, somewhere up the call chain
@@ -18690,6 +19498,7 @@ guess_partial_die_structure_name (struct partial_die_info *struct_pdi,
       if (child_pdi->tag == DW_TAG_subprogram
 	  && child_pdi->linkage_name != NULL)
 	{
+	  scoped_psymtab_storage_lock lock;
 	  char *actual_class_name
 	    = language_class_name_from_physname (cu->language_defn,
 						 child_pdi->linkage_name);
@@ -18765,6 +19574,7 @@ partial_die_info::fixup (struct dwarf2_cu *cu)
 	  || tag == DW_TAG_union_type)
       && linkage_name != NULL)
     {
+      scoped_psymtab_storage_lock lock;
       char *demangled;
 
       demangled = gdb_demangle (linkage_name, DMGL_TYPES);
@@ -20938,8 +21748,16 @@ dwarf_decode_lines (struct line_header *lh, const char *comp_dir,
 	    const char *include_name =
 	      psymtab_include_file_name (lh, file_index, pst, comp_dir,
 					 &name_holder);
-	    if (include_name != NULL)
-              dwarf2_create_include_psymtab (include_name, pst, objfile);
+	    if (include_name == NULL)
+	      continue;
+
+	    struct deferred_psymtab *deferred = cu->deferred_psymtab;
+
+	    if (deferred != NULL)
+	      deferred->include_names.push_back
+		(obstack_strdup (&deferred->storage, include_name));
+	    else
+	      dwarf2_create_include_psymtab (include_name, pst, objfile);
           }
     }
   else
@@ -22297,9 +23115,13 @@ dwarf2_canonicalize_name (const char *name, struct dwarf2_cu *cu,
       if (!canon_name.empty ())
 	{
 	  if (canon_name != name)
-	    name = (const char *) obstack_copy0 (obstack,
-						 canon_name.c_str (),
-						 canon_name.length ());
+	    {
+	      scoped_psymtab_storage_lock lock;
+
+	      name = (const char *) obstack_copy0 (obstack,
+						   canon_name.c_str (),
+						   canon_name.length ());
+	    }
 	}
     }
 
@@ -21,6 +21,7 @@
 #define DWARF2READ_H
 
 #include "filename-seen-cache.h"
+#include "index-cache.h"
 #include "gdb_obstack.h"
 
 typedef struct dwarf2_per_cu_data *dwarf2_per_cu_ptr;
@@ -214,6 +215,10 @@ public:
   /* The mapped index, or NULL if .debug_names is missing or not being used.  */
   std::unique_ptr<mapped_debug_names> debug_names_table;
 
+  /* If the index was loaded from the index cache, this holds the
+     memory the index_table points into.  */
+  std::unique_ptr<index_cache_resource> index_cache_res;
+
   /* When using index_table, this keeps track of all quick_file_names entries.
      TUs typically share line table entries with a CU, so we maintain a
      separate table of all line table entries to support the sharing.
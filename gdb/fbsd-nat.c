@@ -45,6 +45,7 @@
 #include "fbsd-tdep.h"
 
 #include <list>
+#include <forward_list>
 
 /* Return the name of a file that can be opened to get the symbols for
    the child process identified by PID.  */
@@ -43,6 +43,12 @@
    generate-core-file for programs with large resident data.  */
 #define MAX_COPY_BYTES (1024 * 1024)
 
+/* The granularity at which memory is read again when a bigger read
+   fails, and at which blocks of zeros are left out of the core file.
+   Leaving them out turns them into holes in the file, which read back
+   as zeros without taking disk space.  */
+#define GCORE_BLOCK_BYTES 4096
+
 static const char *default_gcore_target (void);
 static enum bfd_architecture default_gcore_arch (void);
 static unsigned long default_gcore_mach (void);
@@ -541,11 +547,100 @@ objfile_find_memory_regions (struct target_ops *self,
   return 0;
 }
 
+/* Return true if the LEN bytes at BUF are all zero.  */
+
+static bool
+gcore_block_is_zero (const gdb_byte *buf, size_t len)
+{
+  return buf[0] == 0 && memcmp (buf, buf + 1, len - 1) == 0;
+}
+
+/* Read SIZE bytes of memory at ADDR into BUF, one block at a time.
+   Fill the blocks which can't be read with zeros.  Return the number
+   of bytes which could not be read.  */
+
+static bfd_size_type
+gcore_read_blocks (CORE_ADDR addr, gdb_byte *buf, bfd_size_type size)
+{
+  bfd_size_type unreadable = 0;
+
+  for (bfd_size_type done = 0; done < size; done += GCORE_BLOCK_BYTES)
+    {
+      bfd_size_type len = std::min (size - done,
+				    (bfd_size_type) GCORE_BLOCK_BYTES);
+
+      if (target_read_memory (addr + done, buf + done, len) != 0)
+	{
+	  memset (buf + done, 0, len);
+	  unreadable += len;
+	}
+    }
+
+  return unreadable;
+}
+
+/* Write the SIZE bytes at BUF at offset OFFSET of OSEC, leaving out
+   the blocks of zeros.  If LAST, SIZE bytes from OFFSET are the end of
+   OSEC, whose last byte is then always written, so that the file
+   extends to the end of the section.  Return false on failure.  */
+
+static bool
+gcore_write_sparse (bfd *obfd, asection *osec, const gdb_byte *buf,
+		    file_ptr offset, bfd_size_type size, bool last)
+{
+  bfd_size_type start = 0;
+
+  while (start < size)
+    {
+      bfd_size_type end;
+
+      /* Skip the blocks of zeros.  */
+      while (start < size)
+	{
+	  bfd_size_type len = std::min (size - start,
+					(bfd_size_type) GCORE_BLOCK_BYTES);
+
+	  if (!gcore_block_is_zero (buf + start, len))
+	    break;
+	  start += len;
+	}
+
+      /* Find the end of the blocks with data, and write them.  */
+      end = start;
+      while (end < size)
+	{
+	  bfd_size_type len = std::min (size - end,
+					(bfd_size_type) GCORE_BLOCK_BYTES);
+
+	  if (gcore_block_is_zero (buf + end, len))
+	    break;
+	  end += len;
+	}
+
+      if (end > start
+	  && !bfd_set_section_contents (obfd, osec, buf + start,
+					offset + start, end - start))
+	return false;
+
+      start = end;
+    }
+
+  if (last
+      && size > 0
+      && gcore_block_is_zero (buf + size - 1, 1)
+      && !bfd_set_section_contents (obfd, osec, buf + size - 1,
+				    offset + size - 1, 1))
+    return false;
+
+  return true;
+}
+
 static void
 gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
 {
   bfd_size_type size, total_size = bfd_section_size (obfd, osec);
   file_ptr offset = 0;
+  bfd_size_type unreadable = 0;
 
   /* Read-only sections are marked; we don't have to copy their contents.  */
   if ((bfd_get_section_flags (obfd, osec) & SEC_LOAD) == 0)
@@ -560,20 +655,18 @@ gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
 
   while (total_size > 0)
     {
+      CORE_ADDR addr = bfd_section_vma (obfd, osec) + offset;
+
       if (size > total_size)
 	size = total_size;
 
-      if (target_read_memory (bfd_section_vma (obfd, osec) + offset,
-			      memhunk.data (), size) != 0)
-	{
-	  warning (_("Memory read failed for corefile "
-		     "section, %s bytes at %s."),
-		   plongest (size),
-		   paddress (target_gdbarch (), bfd_section_vma (obfd, osec)));
-	  break;
-	}
-      if (!bfd_set_section_contents (obfd, osec, memhunk.data (),
-				     offset, size))
+      /* If the whole hunk can't be read, salvage the blocks which
+	 can.  */
+      if (target_read_memory (addr, memhunk.data (), size) != 0)
+	unreadable += gcore_read_blocks (addr, memhunk.data (), size);
+
+      if (!gcore_write_sparse (obfd, osec, memhunk.data (), offset, size,
+			       size == total_size))
 	{
 	  warning (_("Failed to write corefile contents (%s)."),
 		   bfd_errmsg (bfd_get_error ()));
@@ -583,6 +676,12 @@ gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
       total_size -= size;
       offset += size;
     }
+
+  if (unreadable > 0)
+    warning (_("Memory read failed for corefile "
+	       "section, %s bytes at %s."),
+	     plongest (unreadable),
+	     paddress (target_gdbarch (), bfd_section_vma (obfd, osec)));
 }
 
 static int
@@ -71,6 +71,11 @@ struct thread_info
 
   /* Branch trace target information for this thread.  */
   struct btrace_target_info *btrace;
+
+  /* The last reply to a "g" packet sent for this thread, in full, if
+     the "delta-registers" feature is active.  NULL if there is
+     none.  */
+  char *last_g_reply;
 };
 
 extern std::list<thread_info *> all_threads;
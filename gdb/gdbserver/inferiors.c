@@ -91,6 +91,7 @@ static void
 free_one_thread (thread_info *thread)
 {
   free_register_cache (thread_regcache_data (thread));
+  free (thread->last_g_reply);
   free (thread);
 }
 
@@ -5760,6 +5760,24 @@ linux_read_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
   int ret;
   int fd;
 
+  /* Try process_vm_readv first.  It costs a single system call, so it
+     beats PTRACE_PEEKTEXT as soon as more than one word is needed.  */
+  if (len > sizeof (long))
+    {
+      ssize_t bytes = linux_process_vm_xfer (pid, memaddr, myaddr, NULL, len);
+
+      if (bytes == len)
+	return 0;
+
+      /* Some data was read, get the rest with the slower methods.  */
+      if (bytes > 0)
+	{
+	  memaddr += bytes;
+	  myaddr += bytes;
+	  len -= bytes;
+	}
+    }
+
   /* Try using /proc.  Don't bother for one word.  */
   if (len >= 3 * sizeof (long))
     {
@@ -5834,11 +5852,12 @@ linux_read_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
 }
 
 /* Copy LEN bytes of data from debugger memory at MYADDR to inferior's
-   memory at MEMADDR.  On failure (cannot write to the inferior)
-   returns the value of errno.  Always succeeds if LEN is zero.  */
+   memory at MEMADDR with PTRACE_POKETEXT.  On failure (cannot write to
+   the inferior) returns the value of errno.  Always succeeds if LEN is
+   zero.  */
 
 static int
-linux_write_memory (CORE_ADDR memaddr, const unsigned char *myaddr, int len)
+ptrace_write_memory (CORE_ADDR memaddr, const unsigned char *myaddr, int len)
 {
   int i;
   /* Round starting address down to longword boundary.  */
@@ -5859,24 +5878,6 @@ linux_write_memory (CORE_ADDR memaddr, const unsigned char *myaddr, int len)
       return 0;
     }
 
-  if (debug_threads)
-    {
-      /* Dump up to four bytes.  */
-      char str[4 * 2 + 1];
-      char *p = str;
-      int dump = len < 4 ? len : 4;
-
-      for (i = 0; i < dump; i++)
-	{
-	  sprintf (p, "%02x", myaddr[i]);
-	  p += 2;
-	}
-      *p = '\0';
-
-      debug_printf ("Writing %s to 0x%08lx in process %d\n",
-		    str, (long) memaddr, pid);
-    }
-
   /* Fill start and end extra bytes of buffer with existing memory data.  */
 
   errno = 0;
@@ -5924,6 +5925,61 @@ linux_write_memory (CORE_ADDR memaddr, const unsigned char *myaddr, int len)
   return 0;
 }
 
+/* Copy LEN bytes of data from debugger memory at MYADDR to inferior's
+   memory at MEMADDR.  On failure (cannot write to the inferior)
+   returns the value of errno.  Always succeeds if LEN is zero.  */
+
+static int
+linux_write_memory (CORE_ADDR memaddr, const unsigned char *myaddr, int len)
+{
+  int pid = lwpid_of (current_thread);
+
+  if (len == 0)
+    {
+      /* Zero length write always succeeds.  */
+      return 0;
+    }
+
+  if (debug_threads)
+    {
+      /* Dump up to four bytes.  */
+      char str[4 * 2 + 1];
+      char *p = str;
+      int dump = len < 4 ? len : 4;
+
+      for (int i = 0; i < dump; i++)
+	{
+	  sprintf (p, "%02x", myaddr[i]);
+	  p += 2;
+	}
+      *p = '\0';
+
+      debug_printf ("Writing %s to 0x%08lx in process %d\n",
+		    str, (long) memaddr, pid);
+    }
+
+  /* Try process_vm_writev first.  It cannot write to read-only pages,
+     such as the ones breakpoints are inserted in, so don't bother for
+     a few words.  */
+  if (len >= 3 * sizeof (long))
+    {
+      ssize_t bytes = linux_process_vm_xfer (pid, memaddr, NULL, myaddr, len);
+
+      if (bytes == len)
+	return 0;
+
+      /* Write the rest with ptrace.  */
+      if (bytes > 0)
+	{
+	  memaddr += bytes;
+	  myaddr += bytes;
+	  len -= bytes;
+	}
+    }
+
+  return ptrace_write_memory (memaddr, myaddr, len);
+}
+
 static void
 linux_look_up_symbols (void)
 {
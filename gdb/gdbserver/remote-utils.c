@@ -25,6 +25,7 @@
 #include "tdesc.h"
 #include "dll.h"
 #include "rsp-low.h"
+#include "common/byte-vector.h"
 #include "gdbthread.h"
 #include <ctype.h>
 #if HAVE_SYS_IOCTL_H
@@ -60,6 +61,9 @@
 #include <arpa/inet.h>
 #endif
 #include <sys/stat.h>
+#if defined HAVE_ZLIB_H && defined HAVE_LIBZ
+#include <zlib.h>
+#endif
 
 #if USE_WIN32API
 #include <winsock2.h>
@@ -584,6 +588,45 @@ read_prim (void *buf, int count)
     return read (remote_desc, buf, count);
 }
 
+#if defined HAVE_ZLIB_H && defined HAVE_LIBZ
+
+/* Packets shorter than this are not worth compressing.  */
+#define COMPRESS_MIN_LEN 128
+
+/* Compress the packet in BUF, of CNT bytes, into "z", the length of
+   the packet in hex, ':' and the binary-escaped zlib stream.  If that
+   is shorter than the packet, store it in a new buffer in *ZBUF and
+   return its length.  Otherwise, return -1.  */
+
+static int
+compress_packet (const char *buf, int cnt, char **zbuf)
+{
+  uLongf zlen = compressBound (cnt);
+  gdb::byte_vector z (zlen);
+
+  if (compress2 (z.data (), &zlen, (const Bytef *) buf, cnt,
+		 Z_DEFAULT_COMPRESSION) != Z_OK)
+    return -1;
+
+  /* The escaped stream has to fit in the packet.  */
+  char *out = (char *) xmalloc (cnt);
+  int len = sprintf (out, "z%x:", cnt);
+  int out_units;
+
+  len += remote_escape_output (z.data (), zlen, 1, (gdb_byte *) out + len,
+			       &out_units, cnt - len);
+  if ((uLongf) out_units < zlen || len >= cnt)
+    {
+      xfree (out);
+      return -1;
+    }
+
+  *zbuf = out;
+  return len;
+}
+
+#endif
+
 /* Send a packet to the remote machine, with error checking.
    The data of the packet is in BUF, and the length of the
    packet is in CNT.  Returns >= 0 on success, -1 otherwise.  */
@@ -598,6 +641,23 @@ putpkt_binary_1 (char *buf, int cnt, int is_notif)
   char *p;
   int cc;
 
+#if defined HAVE_ZLIB_H && defined HAVE_LIBZ
+  gdb::unique_xmalloc_ptr<char> zbuf;
+
+  if (cs.compressed_replies && !is_notif && cnt >= COMPRESS_MIN_LEN)
+    {
+      char *z;
+      int zcnt = compress_packet (buf, cnt, &z);
+
+      if (zcnt >= 0)
+	{
+	  zbuf.reset (z);
+	  buf = z;
+	  cnt = zcnt;
+	}
+    }
+#endif
+
   buf2 = (char *) xmalloc (strlen ("$") + cnt + strlen ("#nn") + 1);
 
   /* Copy the packet into buffer BUF2, encapsulating it
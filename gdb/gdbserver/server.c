@@ -2350,6 +2350,18 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 		     events.  */
 		  report_no_resumed = 1;
 		}
+	      else if (strcmp (p, "delta-registers+") == 0)
+		{
+		  /* GDB can apply a delta "g" reply.  */
+		  cs.delta_registers = 1;
+		}
+	      else if (strcmp (p, "compressed-replies+") == 0)
+		{
+		  /* GDB can decompress the packets we send.  */
+#if defined HAVE_ZLIB_H && defined HAVE_LIBZ
+		  cs.compressed_replies = 1;
+#endif
+		}
 	      else
 		{
 		  /* Move the unknown features all together.  */
@@ -2407,7 +2419,13 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
       strcat (own_buf, ";qXfer:features:read+");
 
       if (cs.transport_is_reliable)
-	strcat (own_buf, ";QStartNoAckMode+");
+	{
+	  strcat (own_buf, ";QStartNoAckMode+");
+
+	  /* Packets which arrive before the previous one was handled
+	     wait in the transport, and are handled in order.  */
+	  strcat (own_buf, ";pipelined-memory-reads+");
+	}
 
       if (the_target->qxfer_osdata != NULL)
 	strcat (own_buf, ";qXfer:osdata:read+");
@@ -2476,6 +2494,12 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 
       strcat (own_buf, ";no-resumed+");
 
+      if (cs.compressed_replies)
+	strcat (own_buf, ";compressed-replies+");
+
+      if (cs.delta_registers)
+	strcat (own_buf, ";delta-registers+");
+
       /* Reinitialize components as needed for the new connection.  */
       hostio_handle_new_gdb_connection ();
       target_handle_new_gdb_connection ();
@@ -3850,6 +3874,8 @@ captured_main (int argc, char *argv[])
       cs.swbreak_feature = 0;
       cs.hwbreak_feature = 0;
       cs.vCont_supported = 0;
+      cs.compressed_replies = 0;
+      cs.delta_registers = 0;
 
       remote_open (port);
 
@@ -4013,6 +4039,75 @@ process_point_options (struct gdb_breakpoint *bp, const char **packet)
   *packet = dataptr;
 }
 
+/* Maximum number of unchanged register bytes between two changed
+   ones which are sent in the same entry of a delta "g" reply, rather
+   than starting a new entry.  */
+#define G_DELTA_MAX_GAP 4
+
+/* OWN_BUF holds the full reply to a "g" packet for THREAD.  If
+   WANT_DELTA, GDB asked for the registers which changed since the last
+   reply sent for THREAD, and CRC is the checksum of its copy of that
+   reply.  If it matches ours, and the delta is shorter, replace OWN_BUF
+   with it.  In any case, remember the full reply.  */
+
+static void
+make_g_delta (thread_info *thread, char *own_buf, bool want_delta,
+	      unsigned int crc)
+{
+  const char *old = thread->last_g_reply;
+  size_t len = strlen (own_buf);
+  std::string delta;
+
+  if (want_delta
+      && old != NULL
+      && strlen (old) == len
+      && xcrc32 ((const unsigned char *) old, len, 0xffffffff) == crc)
+    {
+      size_t nbytes = len / 2;
+      auto same = [&] (size_t i)
+	{
+	  return (old[2 * i] == own_buf[2 * i]
+		  && old[2 * i + 1] == own_buf[2 * i + 1]);
+	};
+
+      delta = "=";
+      for (size_t i = 0; i < nbytes && delta.size () < len; )
+	{
+	  if (same (i))
+	    {
+	      i++;
+	      continue;
+	    }
+
+	  /* Extend the entry over short runs of unchanged bytes.  */
+	  size_t end = i + 1;
+	  for (;;)
+	    {
+	      size_t next = end;
+
+	      while (next < nbytes && next - end <= G_DELTA_MAX_GAP
+		     && same (next))
+		next++;
+	      if (next == nbytes || next - end > G_DELTA_MAX_GAP)
+		break;
+	      end = next + 1;
+	    }
+
+	  if (delta.size () > 1)
+	    delta += ';';
+	  delta += string_printf ("%x:", (unsigned int) i);
+	  delta.append (own_buf + 2 * i, 2 * (end - i));
+	  i = end;
+	}
+    }
+
+  free (thread->last_g_reply);
+  thread->last_g_reply = xstrdup (own_buf);
+
+  if (!delta.empty () && delta.size () < len)
+    strcpy (own_buf, delta.c_str ());
+}
+
 /* Event loop callback that handles a serial event.  The first byte in
    the serial buffer gets us here.  We expect characters to arrive at
    a brisk pace, so we read the rest of the packet with a blocking
@@ -4144,8 +4239,24 @@ process_serial_event (void)
 	    write_enn (cs.own_buf);
 	  else
 	    {
+	      const char *delta = NULL;
+
+	      if (startswith (cs.own_buf, "g;delta:"))
+		delta = cs.own_buf + strlen ("g;delta:");
+
 	      regcache = get_thread_regcache (current_thread, 1);
-	      registers_to_string (regcache, cs.own_buf);
+	      if (cs.delta_registers)
+		{
+		  /* Take the checksum before the reply overwrites the
+		     request.  */
+		  unsigned int crc
+		    = delta != NULL ? strtoul (delta, NULL, 16) : 0;
+
+		  registers_to_string (regcache, cs.own_buf);
+		  make_g_delta (current_thread, cs.own_buf, delta != NULL, crc);
+		}
+	      else
+		registers_to_string (regcache, cs.own_buf);
 	    }
 	}
       break;
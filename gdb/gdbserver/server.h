@@ -174,6 +174,16 @@ struct client_state
      "vCont?" packet.  */
   int vCont_supported = 0;
 
+  /* True if the "compressed-replies" feature is active.  In that case,
+     GDB can decompress the packets we send, and we compress the large
+     ones.  Only enabled if gdbserver was built with zlib.  */
+  int compressed_replies = 0;
+
+  /* True if the "delta-registers" feature is active.  In that case,
+     we remember the last "g" reply sent for each thread, and GDB can
+     ask for the registers which changed since.  */
+  int delta_registers = 0;
+
   /* Whether we should attempt to disable the operating system's address
      space randomization feature before starting an inferior.  */
   int disable_randomization = 0;
@@ -33,6 +33,7 @@ struct symtab;
 #include "cli/cli-utils.h"
 #include "common/refcounted-object.h"
 #include "common-gdbthread.h"
+#include <unordered_map>
 
 /* Frontend view of the thread state.  Possible extensions: stepping,
    finishing, until(ling),...  */
@@ -743,4 +744,23 @@ extern void thread_select (const char *tidstr, class thread_info *thr);
 
 extern struct thread_info *thread_list;
 
+/* Make THREAD the only thread of the thread list, for as long as this
+   object lives.  This is used by selftests which set up a mock thread,
+   so that it can be found by ptid like a real one.  */
+
+class scoped_mock_thread_list
+{
+public:
+  explicit scoped_mock_thread_list (struct thread_info *thread);
+  ~scoped_mock_thread_list ();
+
+  DISABLE_COPY_AND_ASSIGN (scoped_mock_thread_list);
+
+private:
+  struct thread_info *m_saved_list;
+  struct thread_info *m_saved_tail;
+  size_t m_saved_length;
+  std::unordered_map<ptid_t, thread_info *, hash_ptid> m_saved_map;
+};
+
 #endif /* GDBTHREAD_H */
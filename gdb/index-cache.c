@@ -0,0 +1,417 @@
+/* Caching of GDB/DWARF index files.
+
+   Copyright (C) 2018 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "index-cache.h"
+
+#include "build-id.h"
+#include "common/byte-vector.h"
+#include "common/filestuff.h"
+#include "common/pathstuff.h"
+#include "common/rsp-low.h"
+#include "common/scoped_fd.h"
+#include "dwarf-index-write.h"
+#include "dwarf2read.h"
+#include "filenames.h"
+#include "gdbcmd.h"
+#include "objfiles.h"
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#ifndef MAP_FAILED
+#define MAP_FAILED ((void *) -1)
+#endif
+#endif
+
+/* When nonzero, show debug messages about the index cache.  */
+static int debug_index_cache = 0;
+
+/* The index cache directory, used for "set/show index-cache
+   directory".  */
+static char *index_cache_directory = NULL;
+
+/* See index-cache.h.  */
+index_cache global_index_cache;
+
+/* The "set index-cache" and "show index-cache" command lists.  */
+static struct cmd_list_element *set_index_cache_prefix_list;
+static struct cmd_list_element *show_index_cache_prefix_list;
+
+/* See index-cache.h.  */
+
+index_cache_resource::~index_cache_resource () = default;
+
+/* Return the hexadecimal form of BUILD_ID, which is used to name the
+   index files.  */
+
+static std::string
+build_id_to_string (const bfd_build_id *build_id)
+{
+  return bin2hex (build_id->data, build_id->size);
+}
+
+/* Create DIR, and any of its parents which do not exist yet.  Stop
+   at the first error; any directory already created is left
+   behind.  */
+
+static void
+mkdir_recursive (const char *dir)
+{
+  std::string path (dir);
+  size_t pos = IS_DIR_SEPARATOR (path[0]) ? 1 : 0;
+
+  for (;;)
+    {
+      size_t sep = path.find_first_of ("/\\", pos);
+      std::string component = path.substr (0, sep);
+
+      if (mkdir (component.c_str (), 0777) != 0 && errno != EEXIST)
+	perror_with_name (component.c_str ());
+
+      if (sep == std::string::npos)
+	break;
+      pos = sep + 1;
+    }
+}
+
+/* See index-cache.h.  */
+
+void
+index_cache::set_directory (std::string dir)
+{
+  gdb_assert (!dir.empty ());
+
+  m_dir = std::move (dir);
+
+  if (debug_index_cache)
+    printf_unfiltered ("index cache: now using directory %s\n",
+		       m_dir.c_str ());
+}
+
+/* See index-cache.h.  */
+
+void
+index_cache::enable ()
+{
+  /* There is no default directory when neither XDG_CACHE_HOME nor
+     HOME is set.  Leave the cache off rather than writing index files
+     relative to the root directory.  */
+  if (m_dir.empty ())
+    error (_("The index cache directory is not set.  "
+	     "Use \"set index-cache directory\" to set it."));
+
+  if (debug_index_cache)
+    printf_unfiltered ("index cache: enabling (%s)\n", m_dir.c_str ());
+
+  m_enabled = true;
+}
+
+/* See index-cache.h.  */
+
+void
+index_cache::disable ()
+{
+  if (debug_index_cache)
+    printf_unfiltered ("index cache: disabling\n");
+
+  m_enabled = false;
+}
+
+/* See index-cache.h.  */
+
+void
+index_cache::store (struct dwarf2_per_objfile *dwarf2_per_objfile)
+{
+  struct objfile *objfile = dwarf2_per_objfile->objfile;
+
+  if (!enabled ())
+    return;
+
+  const bfd_build_id *build_id = build_id_bfd_get (objfile->obfd);
+  if (build_id == NULL)
+    {
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: objfile %s has no build id\n",
+			   objfile_name (objfile));
+      return;
+    }
+
+  std::string build_id_str = build_id_to_string (build_id);
+
+  TRY
+    {
+      mkdir_recursive (m_dir.c_str ());
+
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: writing index for objfile %s\n",
+			   objfile_name (objfile));
+
+      write_psymtabs_to_index (dwarf2_per_objfile, m_dir.c_str (),
+			       build_id_str.c_str (),
+			       dw_index_kind::GDB_INDEX);
+    }
+  CATCH (except, RETURN_MASK_ERROR)
+    {
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: couldn't store index for objfile "
+			   "%s: %s\n", objfile_name (objfile),
+			   except.message);
+    }
+  END_CATCH
+}
+
+#ifdef HAVE_MMAP
+
+/* An index file mapped into memory.  */
+
+struct index_cache_resource_mmap final : public index_cache_resource
+{
+  /* Map FILENAME.  Throw an error on failure, including if the file
+     does not exist.  */
+  explicit index_cache_resource_mmap (const char *filename);
+
+  ~index_cache_resource_mmap () override
+  {
+    if (map_addr != NULL)
+      munmap (map_addr, map_len);
+  }
+
+  void *map_addr = NULL;
+  size_t map_len = 0;
+};
+
+index_cache_resource_mmap::index_cache_resource_mmap (const char *filename)
+{
+  scoped_fd fd (gdb_open_cloexec (filename, O_RDONLY, 0));
+  if (fd.get () < 0)
+    perror_with_name (filename);
+
+  struct stat st;
+  if (fstat (fd.get (), &st) < 0)
+    perror_with_name (filename);
+  if (st.st_size == 0)
+    error (_("`%s' is empty"), filename);
+
+  void *addr = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd.get (), 0);
+  if (addr == MAP_FAILED)
+    perror_with_name (filename);
+
+  map_addr = addr;
+  map_len = st.st_size;
+}
+
+#else
+
+/* An index file read into memory.  */
+
+struct index_cache_resource_buffer final : public index_cache_resource
+{
+  /* Read FILENAME.  Throw an error on failure, including if the file
+     does not exist.  */
+  explicit index_cache_resource_buffer (const char *filename);
+
+  gdb::byte_vector contents;
+};
+
+index_cache_resource_buffer::index_cache_resource_buffer
+  (const char *filename)
+{
+  gdb_file_up file = gdb_fopen_cloexec (filename, "rb");
+  if (file == NULL)
+    perror_with_name (filename);
+
+  gdb_byte buf[4096];
+  size_t n;
+  while ((n = fread (buf, 1, sizeof (buf), file.get ())) > 0)
+    contents.insert (contents.end (), buf, buf + n);
+  if (ferror (file.get ()))
+    perror_with_name (filename);
+  if (contents.empty ())
+    error (_("`%s' is empty"), filename);
+}
+
+#endif /* HAVE_MMAP */
+
+/* See index-cache.h.  */
+
+gdb::array_view<const gdb_byte>
+index_cache::lookup_gdb_index (const bfd_build_id *build_id,
+			       std::unique_ptr<index_cache_resource> *resource)
+{
+  if (!enabled ())
+    return {};
+
+  std::string filename = make_index_filename (build_id, INDEX4_SUFFIX);
+
+  TRY
+    {
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: trying to read %s\n",
+			   filename.c_str ());
+
+#ifdef HAVE_MMAP
+      index_cache_resource_mmap *res
+	= new index_cache_resource_mmap (filename.c_str ());
+      resource->reset (res);
+
+      return gdb::array_view<const gdb_byte> ((const gdb_byte *) res->map_addr,
+					      res->map_len);
+#else
+      index_cache_resource_buffer *res
+	= new index_cache_resource_buffer (filename.c_str ());
+      resource->reset (res);
+
+      return gdb::array_view<const gdb_byte> (res->contents.data (),
+					      res->contents.size ());
+#endif
+    }
+  CATCH (except, RETURN_MASK_ERROR)
+    {
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: couldn't read %s: %s\n",
+			   filename.c_str (), except.message);
+    }
+  END_CATCH
+
+  return {};
+}
+
+/* See index-cache.h.  */
+
+std::string
+index_cache::make_index_filename (const bfd_build_id *build_id,
+				  const char *suffix) const
+{
+  return m_dir + SLASH_STRING + build_id_to_string (build_id) + suffix;
+}
+
+/* "set index-cache" handler.  */
+
+static void
+set_index_cache_command (const char *arg, int from_tty)
+{
+  printf_unfiltered (_("\
+\"set index-cache\" must be followed by the name of a subcommand.\n"));
+  help_list (set_index_cache_prefix_list, "set index-cache ", all_commands,
+	     gdb_stdout);
+}
+
+/* "show index-cache" handler.  */
+
+static void
+show_index_cache_command (const char *arg, int from_tty)
+{
+  cmd_show_list (show_index_cache_prefix_list, from_tty, "");
+
+  printf_filtered (_("The index cache is currently %s.\n"),
+		   global_index_cache.enabled () ? _("enabled") : _("disabled"));
+}
+
+/* "set index-cache on" handler.  */
+
+static void
+set_index_cache_on_command (const char *arg, int from_tty)
+{
+  global_index_cache.enable ();
+}
+
+/* "set index-cache off" handler.  */
+
+static void
+set_index_cache_off_command (const char *arg, int from_tty)
+{
+  global_index_cache.disable ();
+}
+
+/* "set index-cache directory" handler.  */
+
+static void
+set_index_cache_directory_command (const char *arg, int from_tty,
+				   struct cmd_list_element *c)
+{
+  /* Make sure the index cache directory is absolute and
+     tilde-expanded.  */
+  gdb::unique_xmalloc_ptr<char> abs (gdb_abspath (index_cache_directory));
+  xfree (index_cache_directory);
+  index_cache_directory = abs.release ();
+  global_index_cache.set_directory (index_cache_directory);
+}
+
+/* "show index-cache stats" handler.  */
+
+static void
+show_index_cache_stats_command (const char *arg, int from_tty)
+{
+  printf_filtered (_("  Cache hits (this session): %u\n"),
+		   global_index_cache.n_hits ());
+  printf_filtered (_("Cache misses (this session): %u\n"),
+		   global_index_cache.n_misses ());
+}
+
+void
+_initialize_index_cache ()
+{
+  /* Set the default index cache directory.  */
+  std::string cache_dir = get_standard_cache_dir ();
+  if (!cache_dir.empty ())
+    {
+      index_cache_directory = xstrdup (cache_dir.c_str ());
+      global_index_cache.set_directory (std::move (cache_dir));
+    }
+
+  add_prefix_cmd ("index-cache", class_files, set_index_cache_command,
+		  _("Set index-cache options."), &set_index_cache_prefix_list,
+		  "set index-cache ", 0, &setlist);
+  add_prefix_cmd ("index-cache", class_files, show_index_cache_command,
+		  _("Show index-cache options."),
+		  &show_index_cache_prefix_list, "show index-cache ", 0,
+		  &showlist);
+
+  add_cmd ("on", class_files, set_index_cache_on_command, _("\
+Enable the index cache.\n\
+When on, GDB looks for the index of each object file with a build-id\n\
+in the index cache directory before reading its DWARF debug information,\n\
+and saves the index there when it had to read the DWARF."),
+	   &set_index_cache_prefix_list);
+
+  add_cmd ("off", class_files, set_index_cache_off_command,
+	   _("Disable the index cache."), &set_index_cache_prefix_list);
+
+  add_setshow_filename_cmd ("directory", class_files, &index_cache_directory,
+			    _("Set the directory of the index cache."),
+			    _("Show the directory of the index cache."),
+			    NULL,
+			    set_index_cache_directory_command, NULL,
+			    &set_index_cache_prefix_list,
+			    &show_index_cache_prefix_list);
+
+  add_cmd ("stats", class_files, show_index_cache_stats_command,
+	   _("Show some stats about the index cache."),
+	   &show_index_cache_prefix_list);
+
+  add_setshow_boolean_cmd ("index-cache", class_maintenance,
+			   &debug_index_cache, _("\
+Set display of index-cache debug messages."), _("\
+Show display of index-cache debug messages."), _("\
+When non-zero, debugging output for the index cache is displayed."),
+			   NULL, NULL,
+			   &setdebuglist, &showdebuglist);
+}
@@ -4321,10 +4321,12 @@ get_inferior_stop_soon (ptid_t ptid)
 }
 
 /* Wait for one event.  Store the resulting waitstatus in WS, and
-   return the event ptid.  */
+   return the event ptid.  OPTIONS are passed to target_wait; with
+   TARGET_WNOHANG, WS is set to TARGET_WAITKIND_IGNORE if the target
+   has no event to report right away.  */
 
 static ptid_t
-wait_one (struct target_waitstatus *ws)
+wait_one (struct target_waitstatus *ws, int options)
 {
   ptid_t event_ptid;
   ptid_t wait_ptid = minus_one_ptid;
@@ -4338,9 +4340,9 @@ wait_one (struct target_waitstatus *ws)
   target_dcache_invalidate ();
 
   if (deprecated_target_wait_hook)
-    event_ptid = deprecated_target_wait_hook (wait_ptid, ws, 0);
+    event_ptid = deprecated_target_wait_hook (wait_ptid, ws, options);
   else
-    event_ptid = target_wait (wait_ptid, ws, 0);
+    event_ptid = target_wait (wait_ptid, ws, options);
 
   if (debug_infrun)
     print_target_wait_results (wait_ptid, event_ptid, ws);
@@ -4458,6 +4460,125 @@ disable_thread_events (void *arg)
   target_thread_events (0);
 }
 
+/* Handle EVENT_PTID/WS, an event reported by the target while
+   stop_all_threads waits for all the threads to stop.  */
+
+static void
+handle_stop_all_threads_event (ptid_t event_ptid,
+			       struct target_waitstatus *ws)
+{
+  if (ws->kind == TARGET_WAITKIND_NO_RESUMED)
+    {
+      /* All resumed threads exited.  */
+    }
+  else if (ws->kind == TARGET_WAITKIND_THREAD_EXITED
+	   || ws->kind == TARGET_WAITKIND_EXITED
+	   || ws->kind == TARGET_WAITKIND_SIGNALLED)
+    {
+      if (debug_infrun)
+	{
+	  ptid_t ptid = pid_to_ptid (ws->value.integer);
+
+	  fprintf_unfiltered (gdb_stdlog,
+			      "infrun: %s exited while "
+			      "stopping threads\n",
+			      target_pid_to_str (ptid));
+	}
+    }
+  else
+    {
+      struct thread_info *t;
+      struct inferior *inf;
+
+      t = find_thread_ptid (event_ptid);
+      if (t == NULL)
+	t = add_thread (event_ptid);
+
+      t->stop_requested = 0;
+      t->executing = 0;
+      t->resumed = 0;
+      t->control.may_range_step = 0;
+
+      /* This may be the first time we see the inferior report
+	 a stop.  */
+      inf = find_inferior_ptid (event_ptid);
+      if (inf->needs_setup)
+	{
+	  switch_to_thread_no_regs (t);
+	  setup_inferior (0);
+	}
+
+      if (ws->kind == TARGET_WAITKIND_STOPPED
+	  && ws->value.sig == GDB_SIGNAL_0)
+	{
+	  /* We caught the event that we intended to catch, so
+	     there's no event pending.  */
+	  t->suspend.waitstatus.kind = TARGET_WAITKIND_IGNORE;
+	  t->suspend.waitstatus_pending_p = 0;
+
+	  if (displaced_step_fixup (t->ptid, GDB_SIGNAL_0) < 0)
+	    {
+	      /* Add it back to the step-over queue.  */
+	      if (debug_infrun)
+		{
+		  fprintf_unfiltered (gdb_stdlog,
+				      "infrun: displaced-step of %s "
+				      "canceled: adding back to the "
+				      "step-over queue\n",
+				      target_pid_to_str (t->ptid));
+		}
+	      t->control.trap_expected = 0;
+	      thread_step_over_chain_enqueue (t);
+	    }
+	}
+      else
+	{
+	  enum gdb_signal sig;
+	  struct regcache *regcache;
+
+	  if (debug_infrun)
+	    {
+	      std::string statstr = target_waitstatus_to_string (ws);
+
+	      fprintf_unfiltered (gdb_stdlog,
+				  "infrun: target_wait %s, saving "
+				  "status for %d.%ld.%ld\n",
+				  statstr.c_str (),
+				  ptid_get_pid (t->ptid),
+				  ptid_get_lwp (t->ptid),
+				  ptid_get_tid (t->ptid));
+	    }
+
+	  /* Record for later.  */
+	  save_waitstatus (t, ws);
+
+	  sig = (ws->kind == TARGET_WAITKIND_STOPPED
+		 ? ws->value.sig : GDB_SIGNAL_0);
+
+	  if (displaced_step_fixup (t->ptid, sig) < 0)
+	    {
+	      /* Add it back to the step-over queue.  */
+	      t->control.trap_expected = 0;
+	      thread_step_over_chain_enqueue (t);
+	    }
+
+	  regcache = get_thread_regcache (t->ptid);
+	  t->suspend.stop_pc = regcache_read_pc (regcache);
+
+	  if (debug_infrun)
+	    {
+	      fprintf_unfiltered (gdb_stdlog,
+				  "infrun: saved stop_pc=%s for %s "
+				  "(currently_stepping=%d)\n",
+				  paddress (target_gdbarch (),
+					    t->suspend.stop_pc),
+				  target_pid_to_str (t->ptid),
+				  currently_stepping (t));
+	    }
+	}
+    }
+}
+
 /* See infrun.h.  */
 
 void
@@ -4552,115 +4673,21 @@ stop_all_threads (void)
 	  if (pass > 0)
 	    pass = -1;
 
-	  event_ptid = wait_one (&ws);
-	  if (ws.kind == TARGET_WAITKIND_NO_RESUMED)
-	    {
-	      /* All resumed threads exited.  */
-	    }
-	  else if (ws.kind == TARGET_WAITKIND_THREAD_EXITED
-		   || ws.kind == TARGET_WAITKIND_EXITED
-		   || ws.kind == TARGET_WAITKIND_SIGNALLED)
-	    {
-	      if (debug_infrun)
-		{
-		  ptid_t ptid = pid_to_ptid (ws.value.integer);
-
-		  fprintf_unfiltered (gdb_stdlog,
-				      "infrun: %s exited while "
-				      "stopping threads\n",
-				      target_pid_to_str (ptid));
-		}
-	    }
-	  else
+	  /* Handle this event, and then all the other events the
+	     target already has, before going through the thread list
+	     again.  Most of the threads we asked to stop usually have
+	     by now, and each pass over the thread list costs as much
+	     as handling an event for every thread.  */
+	  event_ptid = wait_one (&ws, 0);
+	  while (1)
 	    {
-	      struct inferior *inf;
-
-	      t = find_thread_ptid (event_ptid);
-	      if (t == NULL)
-		t = add_thread (event_ptid);
-
-	      t->stop_requested = 0;
-	      t->executing = 0;
-	      t->resumed = 0;
-	      t->control.may_range_step = 0;
-
-	      /* This may be the first time we see the inferior report
-		 a stop.  */
-	      inf = find_inferior_ptid (event_ptid);
-	      if (inf->needs_setup)
-		{
-		  switch_to_thread_no_regs (t);
-		  setup_inferior (0);
-		}
+	      handle_stop_all_threads_event (event_ptid, &ws);
+	      if (ws.kind == TARGET_WAITKIND_NO_RESUMED)
+		break;
 
-	      if (ws.kind == TARGET_WAITKIND_STOPPED
-		  && ws.value.sig == GDB_SIGNAL_0)
-		{
-		  /* We caught the event that we intended to catch, so
-		     there's no event pending.  */
-		  t->suspend.waitstatus.kind = TARGET_WAITKIND_IGNORE;
-		  t->suspend.waitstatus_pending_p = 0;
-
-		  if (displaced_step_fixup (t->ptid, GDB_SIGNAL_0) < 0)
-		    {
-		      /* Add it back to the step-over queue.  */
-		      if (debug_infrun)
-			{
-			  fprintf_unfiltered (gdb_stdlog,
-					      "infrun: displaced-step of %s "
-					      "canceled: adding back to the "
-					      "step-over queue\n",
-					      target_pid_to_str (t->ptid));
-			}
-		      t->control.trap_expected = 0;
-		      thread_step_over_chain_enqueue (t);
-		    }
-		}
-	      else
-		{
-		  enum gdb_signal sig;
-		  struct regcache *regcache;
-
-		  if (debug_infrun)
-		    {
-		      std::string statstr = target_waitstatus_to_string (&ws);
-
-		      fprintf_unfiltered (gdb_stdlog,
-					  "infrun: target_wait %s, saving "
-					  "status for %d.%ld.%ld\n",
-					  statstr.c_str (),
-					  ptid_get_pid (t->ptid),
-					  ptid_get_lwp (t->ptid),
-					  ptid_get_tid (t->ptid));
-		    }
-
-		  /* Record for later.  */
-		  save_waitstatus (t, &ws);
-
-		  sig = (ws.kind == TARGET_WAITKIND_STOPPED
-			 ? ws.value.sig : GDB_SIGNAL_0);
-
-		  if (displaced_step_fixup (t->ptid, sig) < 0)
-		    {
-		      /* Add it back to the step-over queue.  */
-		      t->control.trap_expected = 0;
-		      thread_step_over_chain_enqueue (t);
-		    }
-
-		  regcache = get_thread_regcache (t->ptid);
-		  t->suspend.stop_pc = regcache_read_pc (regcache);
-
-		  if (debug_infrun)
-		    {
-		      fprintf_unfiltered (gdb_stdlog,
-					  "infrun: saved stop_pc=%s for %s "
-					  "(currently_stepping=%d)\n",
-					  paddress (target_gdbarch (),
-						    t->suspend.stop_pc),
-					  target_pid_to_str (t->ptid),
-					  currently_stepping (t));
-		    }
-		}
+	      event_ptid = wait_one (&ws, TARGET_WNOHANG);
+	      if (ws.kind == TARGET_WAITKIND_IGNORE)
+		break;
 	    }
 	}
     }
@@ -954,6 +954,18 @@ iterate_over_lwps (ptid_t filter,
 {
   struct lwp_info *lp, *lpnext;
 
+  /* A filter naming a single LWP can only match that LWP, which the
+     hash table finds without walking the whole list.  */
+  if (ptid_lwp_p (filter))
+    {
+      lp = find_lwp_pid (filter);
+      if (lp != NULL
+	  && ptid_match (lp->ptid, filter)
+	  && (*callback) (lp, data) != 0)
+	return lp;
+      return NULL;
+    }
+
   for (lp = lwp_list; lp; lp = lpnext)
     {
       lpnext = lp->next;
@@ -3953,9 +3965,10 @@ linux_nat_target::pid_to_exec_file (int pid)
   return linux_proc_pid_to_exec_file (pid);
 }
 
-/* Implement the to_xfer_partial target method using /proc/<pid>/mem.
-   Because we can use a single read/write call, this can be much more
-   efficient than banging away at PTRACE_PEEKTEXT.  */
+/* Implement the to_xfer_partial target method using process_vm_readv
+   and process_vm_writev, falling back to /proc/<pid>/mem.  Because we
+   can use a single system call, this can be much more efficient than
+   banging away at PTRACE_PEEKTEXT.  */
 
 static enum target_xfer_status
 linux_proc_xfer_partial (enum target_object object,
@@ -3970,6 +3983,21 @@ linux_proc_xfer_partial (enum target_object object,
   if (object != TARGET_OBJECT_MEMORY)
     return TARGET_XFER_EOF;
 
+  /* A read costs a single system call, so it beats PTRACE_PEEKTEXT as
+     soon as more than one word is needed.  process_vm_writev cannot
+     write to read-only pages, such as the ones breakpoints are
+     inserted in, so don't bother for small writes.  */
+  if (readbuf != NULL ? len > sizeof (long) : len >= 3 * sizeof (long))
+    {
+      ret = linux_process_vm_xfer (ptid_get_lwp (inferior_ptid), offset,
+				   readbuf, writebuf, len);
+      if (ret > 0)
+	{
+	  *xfered_len = ret;
+	  return TARGET_XFER_OK;
+	}
+    }
+
   /* Don't bother for one word.  */
   if (len < 3 * sizeof (long))
     return TARGET_XFER_EOF;
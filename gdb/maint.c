@@ -44,6 +44,10 @@
 #include "cli/cli-utils.h"
 #include "cli/cli-setshow.h"
 
+#if CXX_STD_THREAD
+#include <thread>
+#endif
+
 static void maintenance_do_deprecate (const char *, int);
 
 /* Set this to the maximum number of seconds to wait instead of waiting forever
@@ -722,6 +726,33 @@ maintenance_set_profile_cmd (const char *args, int from_tty,
 }
 #endif
 
+/* The maximum number of threads to use for work which can be done in
+   parallel, or -1 to use one per processor.  */
+
+static int n_worker_threads = -1;
+
+static void
+show_worker_threads (struct ui_file *file, int from_tty,
+		     struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("The number of worker threads GDB "
+			    "can use is %s.\n"), value);
+}
+
+/* See maint.h.  */
+
+unsigned int
+worker_thread_count ()
+{
+#if CXX_STD_THREAD
+  if (n_worker_threads < 0)
+    return std::max (std::thread::hardware_concurrency (), 1u);
+  return std::max (n_worker_threads, 1);
+#else
+  return 1;
+#endif
+}
+
 /* If nonzero, display time usage both at startup and for each command.  */
 
 static int per_command_time;
@@ -1159,6 +1190,17 @@ of time passes without a response from the target, an error occurs."),
 			    show_watchdog,
 			    &setlist, &showlist);
 
+  add_setshow_zuinteger_unlimited_cmd ("worker-threads", class_maintenance,
+				       &n_worker_threads, _("\
+Set the number of worker threads GDB can use."), _("\
+Show the number of worker threads GDB can use."), _("\
+GDB uses worker threads for work which can be done in parallel, like\n\
+reading the symbols of a large program.  \"unlimited\" uses\n\
+one thread per processor; 0 or 1 does all the work in the main thread."),
+				       NULL, show_worker_threads,
+				       &maintenance_set_cmdlist,
+				       &maintenance_show_cmdlist);
+
   add_setshow_boolean_cmd ("profile", class_maintenance,
 			   &maintenance_profile_p, _("\
 Set internal profiling."), _("\
@@ -26,6 +26,13 @@ extern void set_per_command_time (int);
 
 extern void set_per_command_space (int);
 
+/* Return the number of threads, the main thread included, that GDB
+   may use for work which can be done in parallel.  This is 1 if
+   threads are not available, or if the user disabled them with
+   "maintenance set worker-threads".  */
+
+extern unsigned int worker_thread_count ();
+
 /* Records a run time and space usage to be used as a base for
    reporting elapsed time or change in space.  */
 
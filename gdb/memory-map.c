@@ -74,6 +74,12 @@ memory_map_start_memory (struct gdb_xml_parser *parser,
 
   data->memory_map->emplace_back (*start_p, *start_p + *length_p,
 				  (enum mem_access_mode) *type_p);
+  mem_region &r = data->memory_map->back ();
+
+  /* The contents of ROM can't change, so it is always safe to cache
+     them.  */
+  if (r.attrib.mode == MEM_RO)
+    r.attrib.cache = 1;
 }
 
 /* Handle the end of a <memory> element.  Verify that any necessary
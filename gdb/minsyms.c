@@ -51,7 +51,11 @@
 #include "language.h"
 #include "cli/cli-utils.h"
 #include "symbol.h"
+#include "maint.h"
+#include "common/parallel-for.h"
+#include "common/selftest.h"
 #include <algorithm>
+#include <numeric>
 #include "safe-ctype.h"
 
 /* See minsyms.h.  */
@@ -677,7 +681,6 @@ lookup_minimal_symbol_by_pc_section (CORE_ADDR pc_in, struct obj_section *sectio
 {
   int lo;
   int hi;
-  int newobj;
   struct objfile *objfile;
   struct minimal_symbol *msymbol;
   struct minimal_symbol *best_symbol = NULL;
@@ -741,45 +744,19 @@ lookup_minimal_symbol_by_pc_section (CORE_ADDR pc_in, struct obj_section *sectio
 	     equal to the first symbol's address, then some symbol in this
 	     minimal symbol table is a suitable candidate for being the
 	     "best" symbol.  This includes the last real symbol, for cases
-	     where the pc value is larger than any address in this vector.
-
-	     By iterating until the address associated with the current
-	     hi index (the endpoint of the test interval) is less than
-	     or equal to the desired pc value, we accomplish two things:
-	     (1) the case where the pc value is larger than any minimal
-	     symbol address is trivially solved, (2) the address associated
-	     with the hi index is always the one we want when the interation
-	     terminates.  In essence, we are iterating the test interval
-	     down until the pc value is pushed out of it from the high end.
-
-	     Warning: this code is trickier than it would appear at first.  */
+	     where the pc value is larger than any address in this vector.  */
 
 	  if (frob_address (objfile, &pc)
 	      && pc >= MSYMBOL_VALUE_RAW_ADDRESS (&msymbol[lo]))
 	    {
-	      while (MSYMBOL_VALUE_RAW_ADDRESS (&msymbol[hi]) > pc)
-		{
-		  /* pc is still strictly less than highest address.  */
-		  /* Note "new" will always be >= lo.  */
-		  newobj = (lo + hi) / 2;
-		  if ((MSYMBOL_VALUE_RAW_ADDRESS (&msymbol[newobj]) >= pc)
-		      || (lo == newobj))
-		    {
-		      hi = newobj;
-		    }
-		  else
-		    {
-		      lo = newobj;
-		    }
-		}
+	      /* Find the last symbol whose address is less than or equal
+		 to pc.  If we have multiple symbols at the same address,
+		 this is the last one.  That way we can find the right
+		 symbol if it has an index greater than hi.  */
+	      const CORE_ADDR *addresses = objfile->per_bfd->msymbol_addresses;
 
-	      /* If we have multiple symbols at the same address, we want
-	         hi to point to the last one.  That way we can find the
-	         right symbol if it has an index greater than hi.  */
-	      while (hi < objfile->per_bfd->minimal_symbol_count - 1
-		     && (MSYMBOL_VALUE_RAW_ADDRESS (&msymbol[hi])
-			 == MSYMBOL_VALUE_RAW_ADDRESS (&msymbol[hi + 1])))
-		hi++;
+	      hi = (std::upper_bound (addresses, addresses + hi + 1, pc)
+		    - addresses - 1);
 
 	      /* Skip various undesirable symbols.  */
 	      while (hi >= 0)
@@ -927,6 +904,35 @@ lookup_minimal_symbol_by_pc (CORE_ADDR pc)
   return lookup_minimal_symbol_by_pc_section (pc, NULL);
 }
 
+/* See minsyms.h.  */
+
+void
+lookup_minimal_symbols_by_pc (gdb::array_view<const CORE_ADDR> pcs,
+			      gdb::array_view<bound_minimal_symbol> results)
+{
+  gdb_assert (pcs.size () == results.size ());
+
+  /* Look the PCs up in ascending order, so that consecutive searches
+     go through the same objfiles and the same parts of their address
+     arrays, and each distinct PC is only looked up once.  */
+  std::vector<size_t> order (pcs.size ());
+  std::iota (order.begin (), order.end (), 0);
+  std::sort (order.begin (), order.end (), [&] (size_t a, size_t b)
+    {
+      return pcs[a] < pcs[b];
+    });
+
+  for (size_t i = 0; i < order.size (); ++i)
+    {
+      size_t index = order[i];
+
+      if (i > 0 && pcs[index] == pcs[order[i - 1]])
+	results[index] = results[order[i - 1]];
+      else
+	results[index] = lookup_minimal_symbol_by_pc (pcs[index]);
+    }
+}
+
 /* Return non-zero iff PC is in an STT_GNU_IFUNC function resolver.  */
 
 int
@@ -1141,42 +1147,68 @@ minimal_symbol_reader::record_full (const char *name, int name_len,
   return msymbol;
 }
 
-/* Compare two minimal symbols by address and return a signed result based
-   on unsigned comparisons, so that we sort into unsigned numeric order.
-   Within groups with the same address, sort by name.  */
+/* Return true if FN1 should be sorted before FN2.  Minimal symbols
+   are sorted by unsigned address, and within groups with the same
+   address, by name.  */
 
-static int
-compare_minimal_symbols (const void *fn1p, const void *fn2p)
+static inline bool
+minimal_symbol_is_less_than (const minimal_symbol &fn1,
+			     const minimal_symbol &fn2)
 {
-  const struct minimal_symbol *fn1;
-  const struct minimal_symbol *fn2;
-
-  fn1 = (const struct minimal_symbol *) fn1p;
-  fn2 = (const struct minimal_symbol *) fn2p;
-
-  if (MSYMBOL_VALUE_RAW_ADDRESS (fn1) < MSYMBOL_VALUE_RAW_ADDRESS (fn2))
-    {
-      return (-1);		/* addr 1 is less than addr 2.  */
-    }
-  else if (MSYMBOL_VALUE_RAW_ADDRESS (fn1) > MSYMBOL_VALUE_RAW_ADDRESS (fn2))
-    {
-      return (1);		/* addr 1 is greater than addr 2.  */
-    }
+  if (MSYMBOL_VALUE_RAW_ADDRESS (&fn1) != MSYMBOL_VALUE_RAW_ADDRESS (&fn2))
+    return MSYMBOL_VALUE_RAW_ADDRESS (&fn1) < MSYMBOL_VALUE_RAW_ADDRESS (&fn2);
   else
     /* addrs are equal: sort by name */
     {
-      const char *name1 = MSYMBOL_LINKAGE_NAME (fn1);
-      const char *name2 = MSYMBOL_LINKAGE_NAME (fn2);
+      const char *name1 = MSYMBOL_LINKAGE_NAME (&fn1);
+      const char *name2 = MSYMBOL_LINKAGE_NAME (&fn2);
 
       if (name1 && name2)	/* both have names */
-	return strcmp (name1, name2);
+	return strcmp (name1, name2) < 0;
       else if (name2)
-	return 1;		/* fn1 has no name, so it is "less".  */
-      else if (name1)		/* fn2 has no name, so it is "less".  */
-	return -1;
+	return true;		/* fn1 has no name, so it is "less".  */
       else
-	return (0);		/* Neither has a name, so they're equal.  */
+	return false;		/* fn2 has no name, or neither has one.  */
+    }
+}
+
+/* Minimum number of minimal symbols sorted by each worker thread in
+   sort_minimal_symbols.  Smaller tables are sorted faster by a single
+   thread.  */
+
+static const size_t minimal_symbol_min_sort_chunk = 16384;
+
+/* Sort the MCOUNT minimal symbols of MSYMBOLS with
+   minimal_symbol_is_less_than.  Large tables are cut into chunks
+   which are sorted by worker threads, and then merged.  */
+
+static void
+sort_minimal_symbols (struct minimal_symbol *msymbols, int mcount)
+{
+  size_t n_chunks = std::min<size_t> (worker_thread_count (),
+				      mcount / minimal_symbol_min_sort_chunk);
+  if (n_chunks <= 1)
+    {
+      std::sort (msymbols, msymbols + mcount, minimal_symbol_is_less_than);
+      return;
     }
+
+  /* The symbols are only compared, which neither calls into the rest
+     of GDB nor throws, so the chunks can be sorted concurrently.  */
+  auto chunk_start = [&] (size_t i)
+    {
+      return msymbols + (size_t) mcount * i / n_chunks;
+    };
+
+  gdb::parallel_for (n_chunks, n_chunks, [&] (size_t i)
+    {
+      std::sort (chunk_start (i), chunk_start (i + 1),
+		 minimal_symbol_is_less_than);
+    });
+
+  for (size_t i = 1; i < n_chunks; ++i)
+    std::inplace_merge (msymbols, chunk_start (i), chunk_start (i + 1),
+			minimal_symbol_is_less_than);
 }
 
 /* Compact duplicate entries out of a minimal symbol table by walking
@@ -1358,8 +1390,7 @@ minimal_symbol_reader::install ()
 
       /* Sort the minimal symbols by address.  */
 
-      qsort (msymbols, mcount, sizeof (struct minimal_symbol),
-	     compare_minimal_symbols);
+      sort_minimal_symbols (msymbols, mcount);
 
       /* Compact out any duplicates, and free up whatever space we are
          no longer using.  */
@@ -1388,6 +1419,16 @@ minimal_symbol_reader::install ()
       m_objfile->per_bfd->minimal_symbol_count = mcount;
       m_objfile->per_bfd->msymbols = msymbols;
 
+      /* Record the addresses of the symbols in an array of their own,
+	 which the binary search of lookup_minimal_symbol_by_pc_section
+	 walks with far fewer cache misses than the symbols
+	 themselves.  */
+      CORE_ADDR *addresses
+	= XOBNEWVEC (&m_objfile->per_bfd->storage_obstack, CORE_ADDR, mcount);
+      for (int i = 0; i < mcount; ++i)
+	addresses[i] = MSYMBOL_VALUE_RAW_ADDRESS (&msymbols[i]);
+      m_objfile->per_bfd->msymbol_addresses = addresses;
+
       /* Now build the hash tables; we can't do this incrementally
          at an earlier point since we weren't finished with the obstack
 	 yet.  (And if the msymbol obstack gets moved, all the internal
@@ -1521,3 +1562,65 @@ minimal_symbol_upper_bound (struct bound_minimal_symbol minsym)
 
   return result;
 }
+
+#if GDB_SELF_TEST
+
+namespace selftests {
+
+/* Check that lookup_minimal_symbols_by_pc finds the same minimal
+   symbols as looking the PCs up one at a time.  This uses the minimal
+   symbols of the objfiles which are loaded, so run it with a program
+   loaded to test more than the empty case.  */
+
+static void
+test_lookup_minimal_symbols_by_pc ()
+{
+  std::vector<CORE_ADDR> pcs;
+  struct objfile *objfile;
+
+  pcs.push_back (0);
+  pcs.push_back (~(CORE_ADDR) 0);
+  ALL_OBJFILES (objfile)
+    {
+      int count = objfile->per_bfd->minimal_symbol_count;
+      int step = std::max (count / 1000, 1);
+
+      for (int i = 0; i < count; i += step)
+	{
+	  CORE_ADDR addr
+	    = MSYMBOL_VALUE_ADDRESS (objfile, &objfile->per_bfd->msymbols[i]);
+
+	  pcs.push_back (addr - 1);
+	  pcs.push_back (addr);
+	  pcs.push_back (addr + 1);
+	}
+    }
+
+  /* Look up every PC twice, and not in ascending order.  */
+  std::vector<CORE_ADDR> reversed (pcs.rbegin (), pcs.rend ());
+  pcs.insert (pcs.end (), reversed.begin (), reversed.end ());
+
+  std::vector<bound_minimal_symbol> results (pcs.size ());
+  lookup_minimal_symbols_by_pc (pcs, results);
+
+  for (size_t i = 0; i < pcs.size (); ++i)
+    {
+      bound_minimal_symbol expected = lookup_minimal_symbol_by_pc (pcs[i]);
+
+      SELF_CHECK (results[i].minsym == expected.minsym);
+      SELF_CHECK (results[i].objfile == expected.objfile);
+    }
+}
+
+} /* namespace selftests */
+
+#endif /* GDB_SELF_TEST */
+
+void
+_initialize_minsyms (void)
+{
+#if GDB_SELF_TEST
+  selftests::register_test ("lookup_minimal_symbols_by_pc",
+			    selftests::test_lookup_minimal_symbols_by_pc);
+#endif
+}
@@ -20,6 +20,8 @@
 #ifndef MINSYMS_H
 #define MINSYMS_H
 
+#include "common/array-view.h"
+
 struct type;
 
 /* Several lookup functions return both a minimal symbol and the
@@ -275,6 +277,16 @@ struct bound_minimal_symbol lookup_minimal_symbol_by_pc_section
 
 struct bound_minimal_symbol lookup_minimal_symbol_by_pc (CORE_ADDR);
 
+/* Look up the minimal symbol of each of PCS, as
+   lookup_minimal_symbol_by_pc does, and store it in the element of
+   RESULTS at the same index.  RESULTS must be as large as PCS.  This
+   is faster than looking the PCs up one by one when there are many of
+   them, e.g. for the instructions of a branch trace.  */
+
+void lookup_minimal_symbols_by_pc
+  (gdb::array_view<const CORE_ADDR> pcs,
+   gdb::array_view<bound_minimal_symbol> results);
+
 /* Iterate over all the minimal symbols in the objfile OBJF which
    match NAME.  Both the ordinary and demangled names of each symbol
    are considered.  The caller is responsible for canonicalizing NAME,
@@ -24,6 +24,8 @@
 #ifdef HAVE_SYS_PROCFS_H
 #include <sys/procfs.h>
 #endif
+#include <sys/syscall.h>
+#include <sys/uio.h>
 
 /* Stores the ptrace options supported by the running kernel.
    A value of -1 means we did not check for features yet.  A value
@@ -611,3 +613,54 @@ linux_wstatus_maybe_breakpoint (int wstat)
 	      || WSTOPSIG (wstat) == SIGILL
 	      || WSTOPSIG (wstat) == SIGSEGV));
 }
+
+/* Set once process_vm_readv/process_vm_writev turned out not to be
+   implemented by the kernel.  */
+static int process_vm_unusable;
+
+/* See nat/linux-ptrace.h.  */
+
+ssize_t
+linux_process_vm_xfer (pid_t pid, CORE_ADDR addr, gdb_byte *readbuf,
+		       const gdb_byte *writebuf, size_t len)
+{
+#if defined __NR_process_vm_readv && defined __NR_process_vm_writev
+  struct iovec local, remote;
+  ssize_t ret;
+
+  if (process_vm_unusable)
+    {
+      errno = ENOSYS;
+      return -1;
+    }
+
+  /* The remote address must fit in a pointer of GDB's.  */
+  if ((CORE_ADDR) (uintptr_t) addr != addr)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  local.iov_base = readbuf != NULL ? (void *) readbuf : (void *) writebuf;
+  local.iov_len = len;
+  remote.iov_base = (void *) (uintptr_t) addr;
+  remote.iov_len = len;
+
+  if (readbuf != NULL)
+    ret = syscall (__NR_process_vm_readv, pid, &local, 1UL, &remote, 1UL, 0UL);
+  else
+    ret = syscall (__NR_process_vm_writev, pid, &local, 1UL, &remote, 1UL,
+		   0UL);
+
+  /* Other errors, such as EFAULT for a read-only page or EPERM from a
+     security policy, only concern this transfer; the caller falls back
+     to the slower methods for it.  */
+  if (ret == -1 && errno == ENOSYS)
+    process_vm_unusable = 1;
+
+  return ret;
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
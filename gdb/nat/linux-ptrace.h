@@ -196,4 +196,19 @@ extern int linux_ptrace_get_extended_event (int wstat);
 extern int linux_is_extended_waitstatus (int wstat);
 extern int linux_wstatus_maybe_breakpoint (int wstat);
 
+/* Transfer LEN bytes between ADDR in the memory of process PID and
+   READBUF or WRITEBUF, exactly one of which is non-NULL, using
+   process_vm_readv or process_vm_writev.  This moves the whole range
+   with a single system call, without opening /proc/PID/mem.  Return
+   the number of bytes transferred, which is less than LEN if the
+   range runs into memory the call cannot access (for instance, a
+   write to a read-only page), or -1 with errno set if nothing could
+   be transferred.  Callers should then fall back to /proc/PID/mem or
+   ptrace for the rest of the range.  Once the calls have failed with
+   ENOSYS, they are not tried again.  */
+
+extern ssize_t linux_process_vm_xfer (pid_t pid, CORE_ADDR addr,
+				      gdb_byte *readbuf,
+				      const gdb_byte *writebuf, size_t len);
+
 #endif /* COMMON_LINUX_PTRACE_H */
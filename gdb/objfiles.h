@@ -242,6 +242,13 @@ struct objfile_per_bfd_storage
   minimal_symbol *msymbols = NULL;
   int minimal_symbol_count = 0;
 
+  /* The addresses of the minimal symbols above, in the same order.
+     They are copied here so that looking up a symbol by address
+     searches a compact array.  Also allocated on the storage
+     obstack.  */
+
+  CORE_ADDR *msymbol_addresses = NULL;
+
   /* The number of minimal symbols read, before any minimal symbol
      de-duplication is applied.  Note in particular that this has only
      a passing relationship with the actual size of the table above;
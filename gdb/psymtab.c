@@ -1120,6 +1120,11 @@ psym_expand_all_symtabs (struct objfile *objfile)
 {
   struct partial_symtab *psymtab;
 
+  /* The DWARF reader can read its CUs with worker threads; expand the
+     rest of the psymtabs here.  */
+  require_partial_symbols (objfile, 1);
+  dwarf2_expand_all_psymtabs (objfile);
+
   ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, psymtab)
     {
       psymtab_to_symtab (objfile, psymtab);
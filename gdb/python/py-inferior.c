@@ -29,6 +29,8 @@
 #include "gdb_signals.h"
 #include "py-event.h"
 #include "py-stopevent.h"
+#include "common/byte-vector.h"
+#include "common/function-view.h"
 
 struct threadlist_entry {
   thread_object *thread_obj;
@@ -62,6 +64,13 @@ typedef struct {
   /* These are kept just for mbpy_str.  */
   CORE_ADDR addr;
   CORE_ADDR length;
+
+  /* The elements of BUFFER: their format, as for the struct module,
+     their size and their number.  A buffer returned by
+     Inferior.read_memory holds LENGTH elements of format "c".  */
+  const char *format;
+  Py_ssize_t itemsize;
+  Py_ssize_t count;
 } membuf_object;
 
 extern PyTypeObject membuf_object_type
@@ -491,6 +500,38 @@ gdbpy_inferiors (PyObject *unused, PyObject *unused2)
 
 /* Membuf and memory manipulation.  */
 
+/* Return a Python buffer object for BUFFER, which holds COUNT elements
+   of ITEMSIZE bytes and struct module format FORMAT, read starting at
+   ADDR.  The buffer object takes ownership of BUFFER, even on error.
+   Returns NULL on error, with a python exception set.  */
+
+static PyObject *
+membuf_to_python (gdb_byte *buffer, CORE_ADDR addr, CORE_ADDR count,
+		  const char *format, Py_ssize_t itemsize)
+{
+  gdbpy_ref<membuf_object> membuf_obj (PyObject_New (membuf_object,
+						     &membuf_object_type));
+  if (membuf_obj == NULL)
+    {
+      xfree (buffer);
+      return NULL;
+    }
+
+  membuf_obj->buffer = buffer;
+  membuf_obj->addr = addr;
+  membuf_obj->length = count * itemsize;
+  membuf_obj->format = format;
+  membuf_obj->itemsize = itemsize;
+  membuf_obj->count = count;
+
+#ifdef IS_PY3K
+  return PyMemoryView_FromObject ((PyObject *) membuf_obj.get ());
+#else
+  return PyBuffer_FromReadWriteObject ((PyObject *) membuf_obj.get (), 0,
+				       Py_END_OF_BUFFER);
+#endif
+}
+
 /* Implementation of Inferior.read_memory (address, length).
    Returns a Python buffer object with LENGTH bytes of the inferior's
    memory at ADDRESS.  Both arguments are integers.  Returns NULL on error,
@@ -500,7 +541,7 @@ infpy_read_memory (PyObject *self, PyObject *args, PyObject *kw)
 {
   CORE_ADDR addr, length;
   gdb_byte *buffer = NULL;
-  PyObject *addr_obj, *length_obj, *result;
+  PyObject *addr_obj, *length_obj;
   static const char *keywords[] = { "address", "length", NULL };
 
   if (!gdb_PyArg_ParseTupleAndKeywords (args, kw, "OO", keywords,
@@ -524,26 +565,283 @@ infpy_read_memory (PyObject *self, PyObject *args, PyObject *kw)
     }
   END_CATCH
 
-  gdbpy_ref<membuf_object> membuf_obj (PyObject_New (membuf_object,
-						     &membuf_object_type));
-  if (membuf_obj == NULL)
+  return membuf_to_python (buffer, addr, length, "c", 1);
+}
+
+/* The largest block of memory read_elements reads at once.  */
+#define READ_ELEMENTS_BLOCK_SIZE 65536
+
+/* Read COUNT elements of SIZE bytes into BUFFER, one after the other.
+   ADDRESS_OF returns the address of each element.  Elements close
+   enough to each other are read together, with one target read for
+   each block of up to READ_ELEMENTS_BLOCK_SIZE bytes.  If SWAP, the
+   bytes of each element are reversed.  Throws an error if some
+   element can't be read.  */
+
+static void
+read_elements (gdb_byte *buffer, ULONGEST count, int size,
+	       gdb::function_view<CORE_ADDR (ULONGEST)> address_of,
+	       bool swap)
+{
+  gdb::byte_vector block;
+  ULONGEST i = 0;
+
+  while (i < count)
     {
-      xfree (buffer);
-      return NULL;
+      CORE_ADDR start = address_of (i);
+      CORE_ADDR end = start + size;
+      ULONGEST j;
+
+      /* Extend the block with the following elements, as long as they
+	 fit in it.  */
+      for (j = i + 1; j < count; j++)
+	{
+	  CORE_ADDR addr = address_of (j);
+
+	  if (addr < start || addr - start > READ_ELEMENTS_BLOCK_SIZE - size)
+	    break;
+	  end = std::max (end, addr + size);
+	}
+
+      bool block_read = false;
+      if (j > i + 1)
+	{
+	  block.resize (end - start);
+
+	  /* The memory between the elements need not be readable; if
+	     it is not, read the elements one by one.  */
+	  TRY
+	    {
+	      read_memory (start, block.data (), end - start);
+	      block_read = true;
+	    }
+	  CATCH (except, RETURN_MASK_ERROR)
+	    {
+	      if (except.error != MEMORY_ERROR)
+		throw_exception (except);
+	    }
+	  END_CATCH
+	}
+
+      for (; i < j; i++)
+	{
+	  gdb_byte *elt = buffer + i * size;
+
+	  if (block_read)
+	    memcpy (elt, block.data () + (address_of (i) - start), size);
+	  else
+	    read_memory (address_of (i), elt, size);
+
+	  if (swap)
+	    std::reverse (elt, elt + size);
+	}
     }
+}
 
-  membuf_obj->buffer = buffer;
-  membuf_obj->addr = addr;
-  membuf_obj->length = length;
+/* Return the struct module format of the elements of an array of TYPE
+   read by Inferior.read_array or Inferior.read_scattered.  Returns NULL
+   if there is no such format, with a python exception set.  */
 
-#ifdef IS_PY3K
-  result = PyMemoryView_FromObject ((PyObject *) membuf_obj.get ());
+static const char *
+element_format (struct type *type)
+{
+  type = check_typedef (type);
+
+  switch (TYPE_CODE (type))
+    {
+    case TYPE_CODE_INT:
+    case TYPE_CODE_CHAR:
+    case TYPE_CODE_BOOL:
+    case TYPE_CODE_ENUM:
+    case TYPE_CODE_PTR:
+      {
+	bool is_unsigned = (TYPE_UNSIGNED (type)
+			    || TYPE_CODE (type) == TYPE_CODE_PTR);
+
+	switch (TYPE_LENGTH (type))
+	  {
+	  case 1:
+	    return is_unsigned ? "B" : "b";
+	  case 2:
+	    return is_unsigned ? "H" : "h";
+	  case 4:
+	    return is_unsigned ? "I" : "i";
+	  case 8:
+	    return is_unsigned ? "Q" : "q";
+	  }
+      }
+      break;
+
+    case TYPE_CODE_FLT:
+      {
+	enum bfd_endian byte_order = gdbarch_byte_order (get_type_arch (type));
+	const struct floatformat *fmt = floatformat_from_type (type);
+
+	if (fmt == floatformats_ieee_single[byte_order])
+	  return "f";
+	if (fmt == floatformats_ieee_double[byte_order])
+	  return "d";
+      }
+      break;
+    }
+
+  PyErr_SetString (PyExc_TypeError,
+		   _("Type must be an integer, character, boolean, enum or "
+		     "pointer type of 1, 2, 4 or 8 bytes, or an IEEE float "
+		     "type."));
+  return NULL;
+}
+
+/* Parse TYPE_OBJ, the type argument of Inferior.read_array or
+   Inferior.read_scattered.  Set *TYPE to the type, *FORMAT to the
+   format of the elements and *SWAP to whether their bytes are to be
+   reversed for the host.  Returns -1 on error, with a python exception
+   set.  */
+
+static int
+parse_element_type (PyObject *type_obj, struct type **type,
+		    const char **format, bool *swap)
+{
+  *type = type_object_to_type (type_obj);
+  if (*type == NULL)
+    {
+      PyErr_SetString (PyExc_TypeError, _("Argument must be a type."));
+      return -1;
+    }
+
+  TRY
+    {
+      *format = element_format (*type);
+      *swap = (gdbarch_byte_order (get_type_arch (*type))
+#if WORDS_BIGENDIAN
+	       == BFD_ENDIAN_LITTLE
 #else
-  result = PyBuffer_FromReadWriteObject ((PyObject *) membuf_obj.get (), 0,
-					 Py_END_OF_BUFFER);
+	       == BFD_ENDIAN_BIG
 #endif
+	       );
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      GDB_PY_SET_HANDLE_EXCEPTION (except);
+    }
+  END_CATCH
 
-  return result;
+  return *format == NULL ? -1 : 0;
+}
+
+/* Implementation of
+   Inferior.read_array (address, type, count [, stride]).
+   Returns a Python buffer object with the COUNT elements of TYPE at
+   ADDRESS, ADDRESS + STRIDE, and so on, in the host's byte order.
+   STRIDE defaults to the size of TYPE.  Returns NULL on error, with a
+   python exception set.  */
+
+static PyObject *
+infpy_read_array (PyObject *self, PyObject *args, PyObject *kw)
+{
+  PyObject *addr_obj, *type_obj, *count_obj, *stride_obj = NULL;
+  static const char *keywords[] = { "address", "type", "count", "stride",
+				    NULL };
+  CORE_ADDR addr, count, stride;
+  struct type *type;
+  const char *format;
+  bool swap;
+
+  if (!gdb_PyArg_ParseTupleAndKeywords (args, kw, "OOO|O", keywords,
+					&addr_obj, &type_obj, &count_obj,
+					&stride_obj))
+    return NULL;
+
+  if (get_addr_from_python (addr_obj, &addr) < 0
+      || parse_element_type (type_obj, &type, &format, &swap) < 0
+      || get_addr_from_python (count_obj, &count) < 0)
+    return NULL;
+
+  int size = TYPE_LENGTH (check_typedef (type));
+  if (stride_obj == NULL)
+    stride = size;
+  else if (get_addr_from_python (stride_obj, &stride) < 0)
+    return NULL;
+
+  if (count > PY_SSIZE_T_MAX / size)
+    {
+      PyErr_SetString (PyExc_ValueError, _("Count is too large."));
+      return NULL;
+    }
+
+  gdb_byte *buffer = (gdb_byte *) xmalloc (count * size);
+
+  TRY
+    {
+      read_elements (buffer, count, size,
+		     [=] (ULONGEST i) { return addr + i * stride; }, swap);
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      xfree (buffer);
+      GDB_PY_HANDLE_EXCEPTION (except);
+    }
+  END_CATCH
+
+  return membuf_to_python (buffer, addr, count, format, size);
+}
+
+/* Implementation of Inferior.read_scattered (addresses, type).
+   Returns a Python buffer object with the elements of TYPE at each of
+   the addresses of the sequence ADDRESSES, in the host's byte order.
+   Returns NULL on error, with a python exception set.  */
+
+static PyObject *
+infpy_read_scattered (PyObject *self, PyObject *args, PyObject *kw)
+{
+  PyObject *addrs_obj, *type_obj;
+  static const char *keywords[] = { "addresses", "type", NULL };
+  struct type *type;
+  const char *format;
+  bool swap;
+
+  if (!gdb_PyArg_ParseTupleAndKeywords (args, kw, "OO", keywords,
+					&addrs_obj, &type_obj))
+    return NULL;
+
+  if (parse_element_type (type_obj, &type, &format, &swap) < 0)
+    return NULL;
+
+  gdbpy_ref<> seq (PySequence_Fast (addrs_obj,
+				    _("Addresses must be a sequence.")));
+  if (seq == NULL)
+    return NULL;
+
+  Py_ssize_t count = PySequence_Fast_GET_SIZE (seq.get ());
+  std::vector<CORE_ADDR> addrs (count);
+  for (Py_ssize_t i = 0; i < count; i++)
+    if (get_addr_from_python (PySequence_Fast_GET_ITEM (seq.get (), i),
+			      &addrs[i]) < 0)
+      return NULL;
+
+  int size = TYPE_LENGTH (check_typedef (type));
+  if (count > PY_SSIZE_T_MAX / size)
+    {
+      PyErr_SetString (PyExc_ValueError, _("Too many addresses."));
+      return NULL;
+    }
+
+  gdb_byte *buffer = (gdb_byte *) xmalloc (count * size);
+
+  TRY
+    {
+      read_elements (buffer, count, size,
+		     [&] (ULONGEST i) { return addrs[i]; }, swap);
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      xfree (buffer);
+      GDB_PY_HANDLE_EXCEPTION (except);
+    }
+  END_CATCH
+
+  return membuf_to_python (buffer, count > 0 ? addrs[0] : 0, count,
+			   format, size);
 }
 
 /* Implementation of Inferior.write_memory (address, buffer [, length]).
@@ -637,17 +935,23 @@ static int
 get_buffer (PyObject *self, Py_buffer *buf, int flags)
 {
   membuf_object *membuf_obj = (membuf_object *) self;
-  int ret;
 
-  ret = PyBuffer_FillInfo (buf, self, membuf_obj->buffer,
-			   membuf_obj->length, 0,
-			   PyBUF_CONTIG);
+  if (PyBuffer_FillInfo (buf, self, membuf_obj->buffer,
+			 membuf_obj->length, 0, flags) < 0)
+    return -1;
 
+  /* PyBuffer_FillInfo describes the memory as bytes.  Describe it as
+     an array of elements instead, but only in the fields the consumer
+     asked for.  */
+  buf->itemsize = membuf_obj->itemsize;
+  if ((flags & PyBUF_ND) == PyBUF_ND)
+    buf->shape = &membuf_obj->count;
   /* Despite the documentation saying this field is a "const char *",
      in Python 3.4 at least, it's really a "char *".  */
-  buf->format = (char *) "c";
+  if ((flags & PyBUF_FORMAT) == PyBUF_FORMAT)
+    buf->format = (char *) membuf_obj->format;
 
-  return ret;
+  return 0;
 }
 
 #else
@@ -968,6 +1272,16 @@ Return true if this inferior is valid, false if not." },
     METH_VARARGS | METH_KEYWORDS,
     "read_memory (address, length) -> buffer\n\
 Return a buffer object for reading from the inferior's memory." },
+  { "read_array", (PyCFunction) infpy_read_array,
+    METH_VARARGS | METH_KEYWORDS,
+    "read_array (address, type, count [, stride]) -> buffer\n\
+Return a buffer object with COUNT elements of the scalar TYPE read from\n\
+the inferior's memory, STRIDE bytes apart." },
+  { "read_scattered", (PyCFunction) infpy_read_scattered,
+    METH_VARARGS | METH_KEYWORDS,
+    "read_scattered (addresses, type) -> buffer\n\
+Return a buffer object with the element of the scalar TYPE read from\n\
+the inferior's memory at each of the ADDRESSES." },
   { "write_memory", (PyCFunction) infpy_write_memory,
     METH_VARARGS | METH_KEYWORDS,
     "write_memory (address, buffer [, length])\n\
@@ -26,6 +26,10 @@
 #include "python.h"
 #include "python-internal.h"
 #include "py-ref.h"
+#include "gdbcmd.h"
+#include "observable.h"
+#include <chrono>
+#include <unordered_map>
 
 /* Return type of print_string_repr.  */
 
@@ -39,14 +43,62 @@ enum string_repr_result
     string_repr_ok
   };
 
-/* Helper function for find_pretty_printer which iterates over a list,
+/* Whether the pretty-printer lookup cache is used.  */
+
+static int pretty_printer_cache_enabled = 1;
+
+/* The pretty-printer lookup cache.  A Python printer printing a big
+   container asks for a printer for each of its elements, and each of
+   those lookups calls every registered lookup function in turn.  This
+   maps the type of an element to the lookup function which
+   recognized it, or to Py_None if none did, so that the next element
+   of the same type is handled at once.
+
+   The cache is only used while a Python printer is printing, and is
+   emptied when the outermost one returns.  Printers can therefore be
+   registered, enabled or disabled between two commands without the
+   cache getting in the way; only a lookup function whose answer
+   depends on more than the type of the value could be fooled.  */
+
+static std::unordered_map<struct type *, gdbpy_ref<>> pretty_printer_cache;
+
+/* The number of Python printers currently printing a value.  */
+
+static int pretty_printer_depth;
+
+/* Statistics, shown by "maint print python-pretty-printer-statistics".  */
+
+struct pretty_printer_statistics
+{
+  /* The number of times a printer was looked up for a value.  */
+  unsigned long lookups;
+
+  /* How many of those lookups were answered by the cache.  */
+  unsigned long cache_hits;
+
+  /* The number of calls to Python lookup functions.  */
+  unsigned long lookup_function_calls;
+
+  /* Time spent looking printers up.  */
+  std::chrono::steady_clock::duration lookup_time;
+
+  /* Time spent printing values with Python printers, including the
+     printing of their children.  */
+  std::chrono::steady_clock::duration print_time;
+};
+
+static pretty_printer_statistics pretty_printer_stats;
+
+/* Helper function for search_pretty_printers which iterates over a list,
    calls each function and inspects output.  This will return a
-   printer object if one recognizes VALUE.  If no printer is found, it
+   printer object if one recognizes VALUE, and set *LOOKUP_FUNCTION
+   to the function which returned it.  If no printer is found, it
    will return None.  On error, it will set the Python error and
    return NULL.  */
 
 static PyObject *
-search_pp_list (PyObject *list, PyObject *value)
+search_pp_list (PyObject *list, PyObject *value,
+		gdbpy_ref<> *lookup_function)
 {
   Py_ssize_t pp_list_size, list_index;
 
@@ -73,25 +125,30 @@ search_pp_list (PyObject *list, PyObject *value)
 	    continue;
 	}
 
+      ++pretty_printer_stats.lookup_function_calls;
       gdbpy_ref<> printer (PyObject_CallFunctionObjArgs (function, value,
 							 NULL));
       if (printer == NULL)
 	return NULL;
       else if (printer != Py_None)
-	return printer.release ();
+	{
+	  *lookup_function = gdbpy_ref<>::new_reference (function);
+	  return printer.release ();
+	}
     }
 
   Py_RETURN_NONE;
 }
 
-/* Subroutine of find_pretty_printer to simplify it.
+/* Subroutine of search_pretty_printers to simplify it.
    Look for a pretty-printer to print VALUE in all objfiles.
    The result is NULL if there's an error and the search should be terminated.
    The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
    Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
 
 static PyObject *
-find_pretty_printer_from_objfiles (PyObject *value)
+find_pretty_printer_from_objfiles (PyObject *value,
+				   gdbpy_ref<> *lookup_function)
 {
   struct objfile *obj;
 
@@ -106,7 +163,8 @@ find_pretty_printer_from_objfiles (PyObject *value)
       }
 
     gdbpy_ref<> pp_list (objfpy_get_printers (objf, NULL));
-    gdbpy_ref<> function (search_pp_list (pp_list.get (), value));
+    gdbpy_ref<> function (search_pp_list (pp_list.get (), value,
+					  lookup_function));
 
     /* If there is an error in any objfile list, abort the search and exit.  */
     if (function == NULL)
@@ -119,31 +177,32 @@ find_pretty_printer_from_objfiles (PyObject *value)
   Py_RETURN_NONE;
 }
 
-/* Subroutine of find_pretty_printer to simplify it.
+/* Subroutine of search_pretty_printers to simplify it.
    Look for a pretty-printer to print VALUE in the current program space.
    The result is NULL if there's an error and the search should be terminated.
    The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
    Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
 
 static PyObject *
-find_pretty_printer_from_progspace (PyObject *value)
+find_pretty_printer_from_progspace (PyObject *value,
+				    gdbpy_ref<> *lookup_function)
 {
   PyObject *obj = pspace_to_pspace_object (current_program_space);
 
   if (!obj)
     return NULL;
   gdbpy_ref<> pp_list (pspy_get_printers (obj, NULL));
-  return search_pp_list (pp_list.get (), value);
+  return search_pp_list (pp_list.get (), value, lookup_function);
 }
 
-/* Subroutine of find_pretty_printer to simplify it.
+/* Subroutine of search_pretty_printers to simplify it.
    Look for a pretty-printer to print VALUE in the gdb module.
    The result is NULL if there's an error and the search should be terminated.
    The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
    Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
 
 static PyObject *
-find_pretty_printer_from_gdb (PyObject *value)
+find_pretty_printer_from_gdb (PyObject *value, gdbpy_ref<> *lookup_function)
 {
   /* Fetch the global pretty printer list.  */
   if (gdb_python_module == NULL
@@ -154,31 +213,137 @@ find_pretty_printer_from_gdb (PyObject *value)
   if (pp_list == NULL || ! PyList_Check (pp_list.get ()))
     Py_RETURN_NONE;
 
-  return search_pp_list (pp_list.get (), value);
+  return search_pp_list (pp_list.get (), value, lookup_function);
 }
 
 /* Find the pretty-printing constructor function for VALUE.  If no
    pretty-printer exists, return None.  If one exists, return a new
-   reference.  On error, set the Python error and return NULL.  */
+   reference, and set *LOOKUP_FUNCTION to the lookup function which
+   recognized VALUE.  On error, set the Python error and return
+   NULL.  */
 
 static PyObject *
-find_pretty_printer (PyObject *value)
+search_pretty_printers (PyObject *value, gdbpy_ref<> *lookup_function)
 {
   /* Look at the pretty-printer list for each objfile
      in the current program-space.  */
-  gdbpy_ref<> function (find_pretty_printer_from_objfiles (value));
+  gdbpy_ref<> function (find_pretty_printer_from_objfiles (value,
+							   lookup_function));
   if (function == NULL || function != Py_None)
     return function.release ();
 
   /* Look at the pretty-printer list for the current program-space.  */
-  function.reset (find_pretty_printer_from_progspace (value));
+  function.reset (find_pretty_printer_from_progspace (value,
+						      lookup_function));
   if (function == NULL || function != Py_None)
     return function.release ();
 
   /* Look at the pretty-printer list in the gdb module.  */
-  return find_pretty_printer_from_gdb (value);
+  return find_pretty_printer_from_gdb (value, lookup_function);
+}
+
+/* Find the pretty-printing constructor function for VALUE, whose type
+   is TYPE.  This is like search_pretty_printers, but while a Python
+   printer is printing, the lookup cache is used and updated.  TYPE
+   may be NULL to bypass the cache.  */
+
+static PyObject *
+find_pretty_printer_1 (PyObject *value, struct type *type)
+{
+  bool use_cache = (type != NULL && pretty_printer_depth > 0
+		    && pretty_printer_cache_enabled);
+
+  if (use_cache)
+    {
+      auto iter = pretty_printer_cache.find (type);
+
+      if (iter != pretty_printer_cache.end ())
+	{
+	  ++pretty_printer_stats.cache_hits;
+	  if (iter->second == Py_None)
+	    Py_RETURN_NONE;
+
+	  /* Calling the function may print other values, and update the
+	     cache behind our back; hold onto it.  */
+	  gdbpy_ref<> function = iter->second;
+
+	  ++pretty_printer_stats.lookup_function_calls;
+	  gdbpy_ref<> printer (PyObject_CallFunctionObjArgs (function.get (),
+							     value, NULL));
+	  if (printer == NULL || printer != Py_None)
+	    return printer.release ();
+
+	  /* The function does not want this value after all.  Forget
+	     about it, and do a full search.  */
+	  pretty_printer_cache.erase (type);
+	}
+    }
+
+  gdbpy_ref<> lookup_function;
+  gdbpy_ref<> printer (search_pretty_printers (value, &lookup_function));
+
+  if (use_cache && printer != NULL)
+    {
+      if (printer == Py_None)
+	pretty_printer_cache[type] = gdbpy_ref<>::new_reference (Py_None);
+      else
+	pretty_printer_cache[type] = std::move (lookup_function);
+    }
+
+  return printer.release ();
+}
+
+/* Wrapper of find_pretty_printer_1 which keeps the statistics.  */
+
+static PyObject *
+find_pretty_printer (PyObject *value, struct type *type)
+{
+  using namespace std::chrono;
+  steady_clock::time_point start = steady_clock::now ();
+
+  ++pretty_printer_stats.lookups;
+  PyObject *printer = find_pretty_printer_1 (value, type);
+  pretty_printer_stats.lookup_time += steady_clock::now () - start;
+
+  return printer;
 }
 
+/* Keep track of the Python printers currently printing, and of the
+   time they take.  The lookup cache is emptied when the outermost
+   one is done.  */
+
+class scoped_pretty_printer_depth
+{
+public:
+  scoped_pretty_printer_depth ()
+  {
+    if (pretty_printer_depth++ == 0)
+      {
+	m_start = std::chrono::steady_clock::now ();
+	m_prompt_wait = get_prompt_for_continue_wait_time ();
+      }
+  }
+
+  ~scoped_pretty_printer_depth ()
+  {
+    if (--pretty_printer_depth == 0)
+      {
+	pretty_printer_cache.clear ();
+
+	/* Don't count the time the user took to answer the pager.  */
+	pretty_printer_stats.print_time
+	  += (std::chrono::steady_clock::now () - m_start
+	      - (get_prompt_for_continue_wait_time () - m_prompt_wait));
+      }
+  }
+
+  DISABLE_COPY_AND_ASSIGN (scoped_pretty_printer_depth);
+
+private:
+  std::chrono::steady_clock::time_point m_start;
+  std::chrono::steady_clock::duration m_prompt_wait;
+};
+
 /* Pretty-print a single value, via the printer object PRINTER.
    If the function returns a string, a PyObject containing the string
    is returned.  If the function returns Py_NONE that means the pretty
@@ -504,6 +669,10 @@ print_children (PyObject *printer, const char *hint,
       PyObject *py_v;
       const char *name;
 
+      /* Free the values made while printing this child, so that the
+	 value chain does not grow with the number of children.  */
+      scoped_value_mark free_values;
+
       gdbpy_ref<> item (PyIter_Next (iter.get ()));
       if (item == NULL)
 	{
@@ -671,6 +840,20 @@ gdbpy_apply_val_pretty_printer (const struct extension_language_defn *extlang,
   if (!gdb_python_initialized)
     return EXT_LANG_RC_NOP;
 
+  /* Most elements of a big container have no printer of their own;
+     when the cache knows so, don't bother creating a Python value.  */
+  if (pretty_printer_depth > 0 && pretty_printer_cache_enabled)
+    {
+      auto iter = pretty_printer_cache.find (type);
+
+      if (iter != pretty_printer_cache.end () && iter->second == Py_None)
+	{
+	  ++pretty_printer_stats.lookups;
+	  ++pretty_printer_stats.cache_hits;
+	  return EXT_LANG_RC_NOP;
+	}
+    }
+
   gdbpy_enter enter_py (gdbarch, language);
 
   /* Instantiate the printer.  */
@@ -684,7 +867,7 @@ gdbpy_apply_val_pretty_printer (const struct extension_language_defn *extlang,
     }
 
   /* Find the constructor.  */
-  gdbpy_ref<> printer (find_pretty_printer (val_obj.get ()));
+  gdbpy_ref<> printer (find_pretty_printer (val_obj.get (), type));
   if (printer == NULL)
     {
       print_stack_unless_memory_error (stream);
@@ -694,6 +877,8 @@ gdbpy_apply_val_pretty_printer (const struct extension_language_defn *extlang,
   if (printer == Py_None)
     return EXT_LANG_RC_NOP;
 
+  scoped_pretty_printer_depth printing;
+
   /* If we are printing a map, we want some special formatting.  */
   gdb::unique_xmalloc_ptr<char> hint (gdbpy_get_display_hint (printer.get ()));
 
@@ -756,7 +941,7 @@ gdbpy_get_varobj_pretty_printer (struct value *value)
   if (val_obj == NULL)
     return NULL;
 
-  return find_pretty_printer (val_obj.get ());
+  return find_pretty_printer (val_obj.get (), NULL);
 }
 
 /* A Python function which wraps find_pretty_printer and instantiates
@@ -780,6 +965,73 @@ gdbpy_default_visualizer (PyObject *self, PyObject *args)
       return NULL;
     }
 
-  cons = find_pretty_printer (val_obj);
+  cons = find_pretty_printer (val_obj, NULL);
   return cons;
 }
+
+/* The "maint print python-pretty-printer-statistics" command.  */
+
+static void
+maintenance_print_pretty_printer_statistics (const char *args, int from_tty)
+{
+  using namespace std::chrono;
+  const pretty_printer_statistics &stats = pretty_printer_stats;
+
+  printf_filtered (_("Python pretty-printer statistics:\n"));
+  printf_filtered (_("  lookups:               %lu\n"), stats.lookups);
+  printf_filtered (_("  cache hits:            %lu\n"), stats.cache_hits);
+  printf_filtered (_("  lookup function calls: %lu\n"),
+		   stats.lookup_function_calls);
+  printf_filtered (_("  lookup time:           %.6f\n"),
+		   duration<double> (stats.lookup_time).count ());
+  printf_filtered (_("  printing time:         %.6f\n"),
+		   duration<double> (stats.print_time).count ());
+}
+
+/* This module's 'new_objfile' and 'free_objfile' observer.  A freed
+   type's address could be reused by another one, and a new objfile
+   may come with printers of its own.  */
+
+static void
+pretty_printer_objfile_observer (struct objfile *objfile)
+{
+  if (!gdb_python_initialized || pretty_printer_cache.empty ())
+    return;
+
+  /* Clearing the cache releases references to Python objects, which
+     requires holding the GIL.  */
+  gdbpy_enter enter_py (objfile != NULL
+			? get_objfile_arch (objfile)
+			: target_gdbarch (),
+			current_language);
+
+  pretty_printer_cache.clear ();
+}
+
+/* Initialize the pretty-printer lookup cache and its commands.  */
+
+int
+gdbpy_initialize_prettyprint (void)
+{
+  add_setshow_boolean_cmd ("python-pretty-printer-cache", class_maintenance,
+			   &pretty_printer_cache_enabled, _("\
+Set whether Python pretty-printer lookups are cached."), _("\
+Show whether Python pretty-printer lookups are cached."), _("\
+When on, the pretty-printer found for a type is reused for the\n\
+following values of the same type printed by the same Python\n\
+pretty-printer, such as the elements of a container.  Turn this off\n\
+if a lookup function recognizes values by more than their type."),
+			   NULL, NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
+  add_cmd ("python-pretty-printer-statistics", class_maintenance,
+	   maintenance_print_pretty_printer_statistics,
+	   _("Print statistics about Python pretty-printer lookups."),
+	   &maintenanceprintlist);
+
+  gdb::observers::new_objfile.attach (pretty_printer_objfile_observer);
+  gdb::observers::free_objfile.attach (pretty_printer_objfile_observer);
+
+  return 0;
+}
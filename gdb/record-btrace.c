@@ -40,6 +40,7 @@
 #include "inf-loop.h"
 #include "vec.h"
 #include <algorithm>
+#include <forward_list>
 
 static const target_info record_btrace_target_info = {
   "record-btrace",
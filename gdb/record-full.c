@@ -378,6 +378,104 @@ static struct cmd_list_element *record_full_cmdlist;
 static void record_full_goto_insn (struct record_full_entry *entry,
 				   enum exec_direction_kind dir);
 
+/* The entries of the execution log are carved out of chunks of
+   RECORD_FULL_CHUNK_ENTRIES entries instead of being allocated one at
+   a time, and the released entries are kept on a free list for reuse:
+   once the log is full, every new instruction reuses the entries of
+   the oldest one.  */
+
+#define RECORD_FULL_CHUNK_ENTRIES 4096
+
+struct record_full_chunk
+{
+  struct record_full_chunk *next;
+  struct record_full_entry entries[RECORD_FULL_CHUNK_ENTRIES];
+};
+
+/* The chunks allocated so far, newest first.  */
+static struct record_full_chunk *record_full_chunks;
+
+/* Number of entries of the newest chunk handed out so far.  */
+static unsigned int record_full_chunk_used = RECORD_FULL_CHUNK_ENTRIES;
+
+/* Released entries, linked through their NEXT field.  */
+static struct record_full_entry *record_full_free_entries;
+
+/* Number of bytes used by the entries in use and by the values they
+   hold out of line.  */
+static ULONGEST record_full_log_bytes;
+
+/* The "end" entry of the last instruction record_full_message added
+   to the log, or NULL if that entry has been released since.  */
+static struct record_full_entry *record_full_last_message_end;
+
+/* The thread whose instruction that was.  */
+static ptid_t record_full_last_message_ptid;
+
+/* Return a new, cleared, entry of type TYPE.  */
+
+static struct record_full_entry *
+record_full_entry_alloc (enum record_full_type type)
+{
+  struct record_full_entry *rec;
+
+  if (record_full_free_entries != NULL)
+    {
+      rec = record_full_free_entries;
+      record_full_free_entries = rec->next;
+    }
+  else
+    {
+      if (record_full_chunk_used == RECORD_FULL_CHUNK_ENTRIES)
+	{
+	  struct record_full_chunk *chunk = XNEW (struct record_full_chunk);
+
+	  chunk->next = record_full_chunks;
+	  record_full_chunks = chunk;
+	  record_full_chunk_used = 0;
+	}
+      rec = &record_full_chunks->entries[record_full_chunk_used++];
+    }
+
+  memset (rec, 0, sizeof (*rec));
+  rec->type = type;
+  record_full_log_bytes += sizeof (*rec);
+
+  return rec;
+}
+
+/* Put REC back on the free list.  */
+
+static void
+record_full_entry_free (struct record_full_entry *rec)
+{
+  if (rec == record_full_last_message_end)
+    record_full_last_message_end = NULL;
+
+  rec->next = record_full_free_entries;
+  record_full_free_entries = rec;
+  record_full_log_bytes -= sizeof (*rec);
+}
+
+/* Free all the chunks.  No entry may be in use anymore.  */
+
+static void
+record_full_free_chunks (void)
+{
+  while (record_full_chunks != NULL)
+    {
+      struct record_full_chunk *chunk = record_full_chunks;
+
+      record_full_chunks = chunk->next;
+      xfree (chunk);
+    }
+
+  record_full_chunk_used = RECORD_FULL_CHUNK_ENTRIES;
+  record_full_free_entries = NULL;
+  record_full_last_message_end = NULL;
+  record_full_log_bytes = 0;
+}
+
 /* Alloc and free functions for record_full_reg, record_full_mem, and
    record_full_end entries.  */
 
@@ -389,12 +487,14 @@ record_full_reg_alloc (struct regcache *regcache, int regnum)
   struct record_full_entry *rec;
   struct gdbarch *gdbarch = regcache->arch ();
 
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_reg;
+  rec = record_full_entry_alloc (record_full_reg);
   rec->u.reg.num = regnum;
   rec->u.reg.len = register_size (gdbarch, regnum);
   if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-    rec->u.reg.u.ptr = (gdb_byte *) xmalloc (rec->u.reg.len);
+    {
+      rec->u.reg.u.ptr = (gdb_byte *) xmalloc (rec->u.reg.len);
+      record_full_log_bytes += rec->u.reg.len;
+    }
 
   return rec;
 }
@@ -406,8 +506,11 @@ record_full_reg_release (struct record_full_entry *rec)
 {
   gdb_assert (rec->type == record_full_reg);
   if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-    xfree (rec->u.reg.u.ptr);
-  xfree (rec);
+    {
+      xfree (rec->u.reg.u.ptr);
+      record_full_log_bytes -= rec->u.reg.len;
+    }
+  record_full_entry_free (rec);
 }
 
 /* Alloc a record_full_mem record entry.  */
@@ -417,12 +520,14 @@ record_full_mem_alloc (CORE_ADDR addr, int len)
 {
   struct record_full_entry *rec;
 
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_mem;
+  rec = record_full_entry_alloc (record_full_mem);
   rec->u.mem.addr = addr;
   rec->u.mem.len = len;
   if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-    rec->u.mem.u.ptr = (gdb_byte *) xmalloc (len);
+    {
+      rec->u.mem.u.ptr = (gdb_byte *) xmalloc (len);
+      record_full_log_bytes += len;
+    }
 
   return rec;
 }
@@ -434,8 +539,11 @@ record_full_mem_release (struct record_full_entry *rec)
 {
   gdb_assert (rec->type == record_full_mem);
   if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-    xfree (rec->u.mem.u.ptr);
-  xfree (rec);
+    {
+      xfree (rec->u.mem.u.ptr);
+      record_full_log_bytes -= rec->u.mem.len;
+    }
+  record_full_entry_free (rec);
 }
 
 /* Alloc a record_full_end record entry.  */
@@ -443,12 +551,7 @@ record_full_mem_release (struct record_full_entry *rec)
 static inline struct record_full_entry *
 record_full_end_alloc (void)
 {
-  struct record_full_entry *rec;
-
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_end;
-
-  return rec;
+  return record_full_entry_alloc (record_full_end);
 }
 
 /* Free a record_full_end record entry.  */
@@ -456,7 +559,7 @@ record_full_end_alloc (void)
 static inline void
 record_full_end_release (struct record_full_entry *rec)
 {
-  xfree (rec);
+  record_full_entry_free (rec);
 }
 
 /* Free one record entry, any type.
@@ -696,6 +799,40 @@ record_full_check_insn_num (void)
     }
 }
 
+/* The last instruction record_full_message added to the log has now
+   been executed.  Remove the entries of the registers it did not
+   change after all, as replaying them would do nothing.  Only the
+   registers REGCACHE already holds are compared, so that this does not
+   read anything from the target.  */
+
+static void
+record_full_drop_unchanged_regs (struct regcache *regcache)
+{
+  struct record_full_entry *rec, *prev;
+
+  if (record_full_last_message_end == NULL
+      || record_full_last_message_end != record_full_list
+      || record_full_last_message_ptid != regcache->ptid ())
+    return;
+
+  for (rec = record_full_list->prev;
+       rec != NULL && rec->type != record_full_end;
+       rec = prev)
+    {
+      prev = rec->prev;
+
+      if (rec->type != record_full_reg
+	  || regcache->get_register_status (rec->u.reg.num) != REG_VALID
+	  || !regcache->raw_compare (rec->u.reg.num,
+				     record_full_get_loc (rec), 0))
+	continue;
+
+      prev->next = rec->next;
+      rec->next->prev = prev;
+      record_full_reg_release (rec);
+    }
+}
+
 /* Before inferior step (when GDB record the running message, inferior
    only can step), GDB will call this function to record the values to
    record_full_list.  This function will call gdbarch_process_record to
@@ -708,6 +845,8 @@ record_full_message (struct regcache *regcache, enum gdb_signal signal)
   int ret;
   struct gdbarch *gdbarch = regcache->arch ();
 
+  record_full_drop_unchanged_regs (regcache);
+
   TRY
     {
       record_full_arch_list_head = NULL;
@@ -776,6 +915,9 @@ record_full_message (struct regcache *regcache, enum gdb_signal signal)
     record_full_list_release_first ();
   else
     record_full_insn_num++;
+
+  record_full_last_message_end = record_full_list;
+  record_full_last_message_ptid = regcache->ptid ();
 }
 
 static bool
@@ -1005,6 +1147,7 @@ record_full_base_target::close ()
     fprintf_unfiltered (gdb_stdlog, "Process record: record_full_close\n");
 
   record_full_list_release (record_full_list);
+  record_full_free_chunks ();
 
   /* Release record_full_core_regbuf.  */
   if (record_full_core_regbuf)
@@ -1943,6 +2086,10 @@ record_full_base_target::info_record ()
       /* Display log count.  */
       printf_filtered (_("Log contains %u instructions.\n"),
 		       record_full_insn_num);
+
+      /* Display the memory the log takes.  */
+      printf_filtered (_("Log uses %s bytes.\n"),
+		       pulongest (record_full_log_bytes));
     }
   else
     printf_filtered (_("No instructions have been logged.\n"));
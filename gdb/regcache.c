@@ -26,7 +26,6 @@
 #include "reggroups.h"
 #include "observable.h"
 #include "regset.h"
-#include <forward_list>
 
 /*
  * DATA STRUCTURE
@@ -354,19 +353,24 @@ reg_buffer::assert_regnum (int regnum) const
    recording if the register values have been changed (eg. by the
    user).  Therefore all registers must be written back to the
    target when appropriate.  */
-std::forward_list<regcache *> regcache::current_regcache;
+std::unordered_multimap<ptid_t, regcache *, hash_ptid>
+  regcache::current_regcache;
 
 struct regcache *
 get_thread_arch_aspace_regcache (ptid_t ptid, struct gdbarch *gdbarch,
 				 struct address_space *aspace)
 {
-  for (const auto &regcache : regcache::current_regcache)
-    if (ptid_equal (regcache->ptid (), ptid) && regcache->arch () == gdbarch)
-      return regcache;
+  /* Look the thread up by ptid rather than walking every regcache;
+     with thousands of threads, a linear search on each thread switch
+     made "thread apply all" quadratic.  */
+  auto range = regcache::current_regcache.equal_range (ptid);
+  for (auto it = range.first; it != range.second; ++it)
+    if (it->second->arch () == gdbarch)
+      return it->second;
 
   regcache *new_regcache = new regcache (gdbarch, aspace);
 
-  regcache::current_regcache.push_front (new_regcache);
+  regcache::current_regcache.insert (std::make_pair (ptid, new_regcache));
   new_regcache->set_ptid (ptid);
 
   return new_regcache;
@@ -422,11 +426,18 @@ regcache_observer_target_changed (struct target_ops *target)
 void
 regcache::regcache_thread_ptid_changed (ptid_t old_ptid, ptid_t new_ptid)
 {
-  for (auto &regcache : regcache::current_regcache)
+  auto range = regcache::current_regcache.equal_range (old_ptid);
+  std::vector<regcache *> moved;
+
+  for (auto it = range.first; it != range.second; ++it)
     {
-      if (ptid_equal (regcache->ptid (), old_ptid))
-	regcache->set_ptid (new_ptid);
+      it->second->set_ptid (new_ptid);
+      moved.push_back (it->second);
     }
+  regcache::current_regcache.erase (range.first, range.second);
+
+  for (struct regcache *rc : moved)
+    regcache::current_regcache.insert (std::make_pair (new_ptid, rc));
 }
 
 /* Low level examining and depositing of registers.
@@ -443,18 +454,17 @@ regcache::regcache_thread_ptid_changed (ptid_t old_ptid, ptid_t new_ptid)
 void
 registers_changed_ptid (ptid_t ptid)
 {
-  for (auto oit = regcache::current_regcache.before_begin (),
-	 it = std::next (oit);
+  for (auto it = regcache::current_regcache.begin ();
        it != regcache::current_regcache.end ();
        )
     {
-      if (ptid_match ((*it)->ptid (), ptid))
+      if (ptid_match (it->first, ptid))
 	{
-	  delete *it;
-	  it = regcache::current_regcache.erase_after (oit);
+	  delete it->second;
+	  it = regcache::current_regcache.erase (it);
 	}
       else
-	oit = it++;
+	++it;
     }
 
   if (ptid_match (current_thread_ptid, ptid))
@@ -1328,8 +1338,7 @@ public:
   static size_t
   current_regcache_size ()
   {
-    return std::distance (regcache::current_regcache.begin (),
-			  regcache::current_regcache.end ());
+    return regcache::current_regcache.size ();
   }
 };
 
@@ -1382,6 +1391,18 @@ current_regcache_test (void)
      current_regcache.  */
   registers_changed_ptid (ptid2);
   SELF_CHECK (regcache_access::current_regcache_size () == 2);
+
+  /* Rename ptid3 to ptid2; its regcache is found under the new ptid,
+     and nothing is added to current_regcache.  */
+  struct regcache *regcache3
+    = get_thread_arch_aspace_regcache (ptid3, target_gdbarch (), NULL);
+  regcache::regcache_thread_ptid_changed (ptid3, ptid2);
+  regcache = get_thread_arch_aspace_regcache (ptid2,
+					      target_gdbarch (),
+					      NULL);
+  SELF_CHECK (regcache == regcache3);
+  SELF_CHECK (regcache->ptid () == ptid2);
+  SELF_CHECK (regcache_access::current_regcache_size () == 2);
 }
 
 class target_ops_no_register : public test_target_ops
@@ -1469,8 +1490,7 @@ cooked_read_test (struct gdbarch *gdbarch)
   mock_inferior.aspace = &mock_aspace;
   thread_info mock_thread (&mock_inferior, mock_ptid);
 
-  scoped_restore restore_thread_list
-    = make_scoped_restore (&thread_list, &mock_thread);
+  scoped_mock_thread_list restore_thread_list (&mock_thread);
 
   /* Add the mock inferior to the inferior list so that look ups by
      target+ptid can find it.  */
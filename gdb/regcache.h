@@ -21,7 +21,7 @@
 #define REGCACHE_H
 
 #include "common-regcache.h"
-#include <forward_list>
+#include <unordered_map>
 
 struct regcache;
 struct regset;
@@ -347,7 +347,9 @@ public:
   static void regcache_thread_ptid_changed (ptid_t old_ptid, ptid_t new_ptid);
 protected:
   regcache (gdbarch *gdbarch, const address_space *aspace_);
-  static std::forward_list<regcache *> current_regcache;
+  /* The register caches of all threads, keyed by thread.  */
+  static std::unordered_multimap<ptid_t, regcache *, hash_ptid>
+    current_regcache;
 
 private:
 
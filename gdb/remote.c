@@ -76,6 +76,7 @@
 #include "environ.h"
 #include "common/byte-vector.h"
 #include <unordered_map>
+#include <zlib.h>
 
 /* The remote target.  */
 
@@ -94,6 +95,7 @@ struct threads_listing_context;
 typedef int (*rmt_thread_action) (threadref *ref, void *context);
 struct protocol_feature;
 struct packet_reg;
+struct remote_thread_info;
 
 struct stop_reply;
 static void stop_reply_xfree (struct stop_reply *);
@@ -278,6 +280,13 @@ public: /* data */
   /* True if we're connected in extended remote mode.  */
   bool extended = false;
 
+  /* True if the last qSupported packet offered the
+     "compressed-replies" feature, which allows the stub to send
+     compressed packets.  This is decided when connecting, so changing
+     "set remote compressed-replies-packet" afterwards has no effect
+     on the current connection.  */
+  bool compressed_replies = false;
+
   /* True if we resumed the target and we're waiting for the target to
      stop.  In the mean time, we can't start another command/query.
      The remote server wouldn't be ready to process it, so we'd
@@ -848,7 +857,7 @@ public: /* Remote specific methods.  */
 
   int fetch_register_using_p (struct regcache *regcache,
 			      packet_reg *reg);
-  int send_g_packet ();
+  int send_g_packet (remote_thread_info *priv = NULL);
   void process_g_packet (struct regcache *regcache);
   void fetch_registers_using_g (struct regcache *regcache);
   int store_register_using_P (const struct regcache *regcache,
@@ -872,6 +881,13 @@ public: /* Remote specific methods.  */
 					 const gdb_byte *myaddr, ULONGEST len,
 					 int unit_size, ULONGEST *xfered_len);
 
+  target_xfer_status remote_read_bytes_pipelined (CORE_ADDR memaddr,
+						 gdb_byte *myaddr,
+						 ULONGEST len_units,
+						 int unit_size,
+						 ULONGEST units_per_packet,
+						 ULONGEST *xfered_len_units);
+
   target_xfer_status remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
 					  ULONGEST len_units,
 					  int unit_size, ULONGEST *xfered_len_units);
@@ -1091,6 +1107,11 @@ struct remote_thread_info : public private_thread_info
   /* Whether this thread was already vCont-resumed on the remote
      side.  */
   int vcont_resumed = 0;
+
+  /* The last reply to a 'g' packet for this thread, in full, if the
+     remote target supports delta 'g' replies.  Such replies list the
+     registers which changed since that one.  */
+  std::string last_g_reply;
 };
 
 remote_state::remote_state ()
@@ -1764,6 +1785,23 @@ remote_target::get_memory_read_packet_size ()
   return size;
 }
 
+/* The maximum number of memory-read packets to send before waiting
+   for the first reply, when the remote target supports it.  See
+   remote_read_bytes_pipelined.  */
+
+static unsigned int remote_memory_read_window = 16;
+
+static void
+show_remote_memory_read_window (struct ui_file *file, int from_tty,
+				struct cmd_list_element *c,
+				const char *value)
+{
+  fprintf_filtered (file,
+		    _("The maximum number of memory-read packets "
+		      "in flight is %s.\n"),
+		    value);
+}
+
 
 
 struct packet_config
@@ -2077,6 +2115,16 @@ enum {
   /* Support TARGET_WAITKIND_NO_RESUMED.  */
   PACKET_no_resumed,
 
+  /* Support for sending memory read packets without waiting for the
+     replies to the previous ones.  */
+  PACKET_pipelined_memory_reads,
+
+  /* Support for compressing the packets the remote stub sends.  */
+  PACKET_compressed_replies,
+
+  /* Support for 'g' replies which only list the changed registers.  */
+  PACKET_delta_registers,
+
   PACKET_MAX
 };
 
@@ -5177,6 +5225,12 @@ static const struct protocol_feature remote_protocol_features[] = {
   { "vContSupported", PACKET_DISABLE, remote_supported_packet, PACKET_vContSupported },
   { "QThreadEvents", PACKET_DISABLE, remote_supported_packet, PACKET_QThreadEvents },
   { "no-resumed", PACKET_DISABLE, remote_supported_packet, PACKET_no_resumed },
+  { "pipelined-memory-reads", PACKET_DISABLE, remote_supported_packet,
+    PACKET_pipelined_memory_reads },
+  { "compressed-replies", PACKET_DISABLE, remote_supported_packet,
+    PACKET_compressed_replies },
+  { "delta-registers", PACKET_DISABLE, remote_supported_packet,
+    PACKET_delta_registers },
 };
 
 static char *remote_support_xml;
@@ -5237,6 +5291,7 @@ remote_target::remote_query_supported ()
      containing no features.  */
 
   rs->buf[0] = 0;
+  rs->compressed_replies = false;
   if (packet_support (PACKET_qSupported) != PACKET_DISABLE)
     {
       std::string q;
@@ -5270,6 +5325,16 @@ remote_target::remote_query_supported ()
       if (packet_set_cmd_state (PACKET_no_resumed) != AUTO_BOOLEAN_FALSE)
 	remote_query_supported_append (&q, "no-resumed+");
 
+      if (packet_set_cmd_state (PACKET_compressed_replies)
+	  != AUTO_BOOLEAN_FALSE)
+	{
+	  remote_query_supported_append (&q, "compressed-replies+");
+	  rs->compressed_replies = true;
+	}
+
+      if (packet_set_cmd_state (PACKET_delta_registers) != AUTO_BOOLEAN_FALSE)
+	remote_query_supported_append (&q, "delta-registers+");
+
       /* Keep this one last to work around a gdbserver <= 7.10 bug in
 	 the qSupported:xmlRegisters=i386 handling.  */
       if (remote_support_xml != NULL
@@ -7977,15 +8042,59 @@ remote_target::fetch_register_using_p (struct regcache *regcache,
   return 1;
 }
 
-/* Fetch the registers included in the target's 'g' packet.  */
+/* Apply DELTA, the contents of a delta 'g' reply after its leading
+   '=', to REGS, the previous full 'g' reply.  */
+
+static void
+apply_g_delta (std::string *regs, const char *delta)
+{
+  const char *p = delta;
+
+  while (*p != '\0')
+    {
+      ULONGEST offset;
+      const char *q = unpack_varlen_hex (p, &offset);
+      size_t len;
+
+      if (q == p || *q != ':')
+	error (_("Malformed delta 'g' packet reply: %s"), delta);
+      q++;
+
+      len = strcspn (q, ";");
+      if (len % 2 != 0 || offset > regs->size () / 2
+	  || offset * 2 + len > regs->size ())
+	error (_("Malformed delta 'g' packet reply: %s"), delta);
+      regs->replace (offset * 2, len, q, len);
+
+      p = q + len;
+      if (*p == ';')
+	p++;
+    }
+}
+
+/* Fetch the registers included in the target's 'g' packet.  If PRIV
+   is not NULL, it is the thread whose registers are fetched, and the
+   remote target may reply with only the registers which changed since
+   PRIV->last_g_reply.  */
 
 int
-remote_target::send_g_packet ()
+remote_target::send_g_packet (remote_thread_info *priv)
 {
   struct remote_state *rs = get_remote_state ();
   int buf_len;
 
-  xsnprintf (rs->buf, get_remote_packet_size (), "g");
+  if (priv != NULL && !priv->last_g_reply.empty ())
+    {
+      /* Send the checksum of our copy of the last reply, so that the
+	 remote target replies in full if it does not match its own.  */
+      unsigned int crc
+	= xcrc32 ((const unsigned char *) priv->last_g_reply.c_str (),
+		  priv->last_g_reply.size (), 0xffffffff);
+
+      xsnprintf (rs->buf, get_remote_packet_size (), "g;delta:%x", crc);
+    }
+  else
+    xsnprintf (rs->buf, get_remote_packet_size (), "g");
   putpkt (rs->buf);
   getpkt (&rs->buf, &rs->buf_size, 0);
   if (packet_check_result (rs->buf) == PACKET_ERROR)
@@ -7998,7 +8107,8 @@ remote_target::send_g_packet ()
   while ((rs->buf[0] < '0' || rs->buf[0] > '9')
 	 && (rs->buf[0] < 'A' || rs->buf[0] > 'F')
 	 && (rs->buf[0] < 'a' || rs->buf[0] > 'f')
-	 && rs->buf[0] != 'x')	/* New: unavailable register value.  */
+	 && rs->buf[0] != 'x'	/* New: unavailable register value.  */
+	 && (rs->buf[0] != '=' || priv == NULL)) /* Delta reply.  */
     {
       if (remote_debug)
 	fprintf_unfiltered (gdb_stdlog,
@@ -8006,6 +8116,22 @@ remote_target::send_g_packet ()
       getpkt (&rs->buf, &rs->buf_size, 0);
     }
 
+  if (rs->buf[0] == '=')
+    {
+      if (priv->last_g_reply.empty ())
+	error (_("Unexpected delta 'g' packet reply: %s"), rs->buf);
+
+      apply_g_delta (&priv->last_g_reply, rs->buf + 1);
+      if (rs->buf_size < priv->last_g_reply.size () + 1)
+	{
+	  rs->buf_size = priv->last_g_reply.size () + 1;
+	  rs->buf = (char *) xrealloc (rs->buf, rs->buf_size);
+	}
+      strcpy (rs->buf, priv->last_g_reply.c_str ());
+    }
+  else if (priv != NULL)
+    priv->last_g_reply = rs->buf;
+
   buf_len = strlen (rs->buf);
 
   /* Sanity check the received packet.  */
@@ -8122,7 +8248,20 @@ remote_target::process_g_packet (struct regcache *regcache)
 void
 remote_target::fetch_registers_using_g (struct regcache *regcache)
 {
-  send_g_packet ();
+  remote_thread_info *priv = NULL;
+
+  /* Delta replies are only used for the live registers of known
+     threads.  */
+  if (packet_support (PACKET_delta_registers) == PACKET_ENABLE
+      && get_traceframe_number () == -1)
+    {
+      thread_info *tp = find_thread_ptid (regcache->ptid ());
+
+      if (tp != NULL)
+	priv = get_remote_thread_info (tp);
+    }
+
+  send_g_packet (priv);
   process_g_packet (regcache);
 }
 
@@ -8747,6 +8886,16 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
   todo_units = std::min (len_units,
 			 (ULONGEST) (buf_size_bytes / unit_size) / 2);
 
+  /* If more than one packet is needed, try to send several at once.
+     Without acks, the replies just come back in order.  */
+  if (todo_units < len_units
+      && rs->noack_mode
+      && remote_memory_read_window > 1
+      && packet_support (PACKET_pipelined_memory_reads) == PACKET_ENABLE)
+    return remote_read_bytes_pipelined (memaddr, myaddr, len_units,
+					unit_size, todo_units,
+					xfered_len_units);
+
   /* Construct "m"<memaddr>","<len>".  */
   memaddr = remote_address_masked (memaddr);
   p = rs->buf;
@@ -8770,6 +8919,78 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
   return (*xfered_len_units != 0) ? TARGET_XFER_OK : TARGET_XFER_EOF;
 }
 
+/* Like remote_read_bytes_1, but send up to remote_memory_read_window
+   "m" packets of UNITS_PER_PACKET units each before reading the
+   replies.  Return the units read up to the first packet which failed
+   or came back short; the replies to the packets after it are read
+   and dropped.  */
+
+target_xfer_status
+remote_target::remote_read_bytes_pipelined (CORE_ADDR memaddr,
+					    gdb_byte *myaddr,
+					    ULONGEST len_units,
+					    int unit_size,
+					    ULONGEST units_per_packet,
+					    ULONGEST *xfered_len_units)
+{
+  struct remote_state *rs = get_remote_state ();
+  ULONGEST n_packets = ((len_units + units_per_packet - 1)
+			/ units_per_packet);
+  ULONGEST done_units = 0;
+  bool failed = false;
+  bool error_first = false;
+
+  n_packets = std::min (n_packets, (ULONGEST) remote_memory_read_window);
+
+  for (ULONGEST i = 0; i < n_packets; i++)
+    {
+      ULONGEST offset = i * units_per_packet;
+      ULONGEST todo_units = std::min (units_per_packet, len_units - offset);
+      char *p = rs->buf;
+
+      /* Construct "m"<memaddr>","<len>".  */
+      *p++ = 'm';
+      p += hexnumstr (p, (ULONGEST) remote_address_masked (memaddr + offset));
+      *p++ = ',';
+      p += hexnumstr (p, todo_units);
+      *p = '\0';
+      putpkt (rs->buf);
+    }
+
+  for (ULONGEST i = 0; i < n_packets; i++)
+    {
+      ULONGEST offset = i * units_per_packet;
+      ULONGEST todo_units = std::min (units_per_packet, len_units - offset);
+      int decoded_bytes;
+
+      /* Read every reply, even after a failure, so that the next
+	 packet gets its own reply.  */
+      getpkt (&rs->buf, &rs->buf_size, 0);
+      if (failed)
+	continue;
+
+      if (rs->buf[0] == 'E'
+	  && isxdigit (rs->buf[1]) && isxdigit (rs->buf[2])
+	  && rs->buf[3] == '\0')
+	{
+	  failed = true;
+	  error_first = (i == 0);
+	  continue;
+	}
+
+      decoded_bytes = hex2bin (rs->buf, myaddr + offset * unit_size,
+			       todo_units * unit_size);
+      done_units += decoded_bytes / unit_size;
+      if (decoded_bytes / unit_size < todo_units)
+	failed = true;
+    }
+
+  *xfered_len_units = done_units;
+  if (done_units != 0)
+    return TARGET_XFER_OK;
+  return error_first ? TARGET_XFER_E_IO : TARGET_XFER_EOF;
+}
+
 /* Using the set of read-only target sections of remote, read live
    read-only memory.
 
@@ -9486,6 +9707,51 @@ remote_target::read_frame (char **buf_p, long *sizeof_buf)
     }
 }
 
+/* If the LEN bytes in *BUF are a compressed packet, "z" followed by
+   the length of the packet in hex, ':' and the binary-escaped zlib
+   stream, replace them with the decompressed packet.  Resize *BUF
+   using xrealloc if necessary, and update *SIZEOF_BUF.  Return the
+   length of the packet now in *BUF.  Throw an error if the packet
+   would decompress to more than MAX_SIZE bytes.  */
+
+static int
+decompress_packet (char **buf, long *sizeof_buf, int len, long max_size)
+{
+  ULONGEST size;
+  const char *p = unpack_varlen_hex (*buf + 1, &size);
+
+  if (p == *buf + 1 || *p != ':')
+    return len;
+  p++;
+
+  if (size > max_size)
+    error (_("Compressed packet from the remote target is too large."));
+
+  int zlen = len - (p - *buf);
+  gdb::byte_vector zbuf (zlen);
+  zlen = remote_unescape_input ((const gdb_byte *) p, zlen,
+				zbuf.data (), zlen);
+
+  if (*sizeof_buf < size + 1)
+    {
+      *sizeof_buf = size + 1;
+      *buf = (char *) xrealloc (*buf, *sizeof_buf);
+    }
+
+  uLongf dest_len = size;
+  if (uncompress ((Bytef *) *buf, &dest_len, zbuf.data (), zlen) != Z_OK
+      || dest_len != size)
+    error (_("Could not decompress a packet from the remote target."));
+  (*buf)[size] = '\0';
+
+  if (remote_debug)
+    fprintf_unfiltered (gdb_stdlog,
+			"Packet decompressed: %d bytes from %d bytes\n",
+			(int) size, len);
+
+  return size;
+}
+
 /* Read a packet from the remote machine, with error checking, and
    store it in *BUF.  Resize *BUF using xrealloc if necessary to hold
    the result, and update *SIZEOF_BUF.  If FOREVER, wait forever
@@ -9627,6 +9893,17 @@ remote_target::getpkt_or_notif_sane_1 (char **buf, long *sizeof_buf,
 	    remote_serial_write ("+", 1);
 	  if (is_notif != NULL)
 	    *is_notif = 0;
+
+	  /* The stub can send a compressed packet as soon as it has
+	     seen "compressed-replies+" in qSupported, which may be
+	     before its reply to qSupported is processed.  The stub
+	     never has to send more than GDB asked for, and GDB asks
+	     for no more than fits in RS->BUF, so a packet which would
+	     decompress to more than that is bogus.  */
+	  if ((*buf)[0] == 'z' && rs->compressed_replies)
+	    val = decompress_packet (buf, sizeof_buf, val,
+				     std::max (rs->buf_size,
+					       get_remote_packet_size ()));
 	  return val;
 	}
 
@@ -14349,6 +14626,19 @@ further restriction and ``limit'' to enable that restriction."),
 	   _("Show the maximum number of bytes per memory-read packet."),
 	   &remote_show_cmdlist);
 
+  add_setshow_zuinteger_cmd ("memory-read-window", no_class,
+			     &remote_memory_read_window, _("\
+Set the maximum number of memory-read packets in flight."), _("\
+Show the maximum number of memory-read packets in flight."), _("\
+When the remote target supports it, GDB sends up to this many packets\n\
+for a large memory read before waiting for the first reply, so that\n\
+the read is not slowed down by one round trip per packet.\n\
+0 or 1 means to wait for the reply to each packet before sending the\n\
+next one."),
+			     NULL,
+			     show_remote_memory_read_window,
+			     &remote_set_cmdlist, &remote_show_cmdlist);
+
   add_setshow_zinteger_cmd ("hardware-watchpoint-limit", no_class,
 			    &remote_hw_watchpoint_limit, _("\
 Set the maximum number of target hardware watchpoints."), _("\
@@ -14643,6 +14933,16 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (&remote_protocol_packets[PACKET_no_resumed],
 			 "N stop reply", "no-resumed-stop-reply", 0);
 
+  add_packet_config_cmd
+    (&remote_protocol_packets[PACKET_pipelined_memory_reads],
+     "pipelined-memory-reads", "pipelined-memory-reads", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_compressed_replies],
+			 "compressed-replies", "compressed-replies", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_delta_registers],
+			 "delta-registers", "delta-registers", 0);
+
   /* Assert that we've registered "set remote foo-packet" commands
      for all packet configs.  */
   {
@@ -65,6 +65,7 @@
 
 
 #include <algorithm>
+#include <forward_list>
 #include "cli/cli-utils.h"
 #include "gdbcmd.h"
 #include "auxv.h"
@@ -612,6 +612,11 @@ extern bool dwarf2_initialize_objfile (struct objfile *objfile,
 				       dw_index_kind *index_kind);
 
 extern void dwarf2_build_psymtabs (struct objfile *);
+
+/* Expand the psymtabs of the DWARF CUs of OBJFILE, reading their DIEs
+   with worker threads.  Do nothing if OBJFILE has no DWARF psymtabs,
+   or if worker threads may not be used.  */
+extern void dwarf2_expand_all_psymtabs (struct objfile *objfile);
 extern void dwarf2_build_frame_info (struct objfile *);
 
 void dwarf2_free_objfile (struct objfile *);
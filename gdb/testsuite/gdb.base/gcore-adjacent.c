@@ -0,0 +1,53 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* Two adjacent mappings with different protections, which the core
+   file holds as two sections, so that reads across the boundary
+   between them take one part from each.  */
+
+unsigned char *buf;
+long page_size;
+
+void
+break_here (void)
+{
+}
+
+int
+main (void)
+{
+  long i;
+
+  page_size = sysconf (_SC_PAGESIZE);
+  buf = (unsigned char *) mmap (NULL, 2 * page_size, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (buf == MAP_FAILED)
+    return 1;
+
+  for (i = 0; i < 2 * page_size; i++)
+    buf[i] = i % 251;
+
+  if (mprotect (buf + page_size, page_size, PROT_READ) != 0)
+    return 1;
+
+  break_here ();
+  return 0;
+}
@@ -0,0 +1,40 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Mostly zeros, with a few bytes set here and there, so that the core
+   file has both blocks left out and blocks written.  */
+
+#define SIZE (4 * 1024 * 1024)
+
+char sparse[SIZE];
+
+void
+break_here (void)
+{
+}
+
+int
+main (void)
+{
+  sparse[0] = 1;
+  sparse[SIZE / 2 - 1] = 2;
+  sparse[SIZE / 2] = 3;
+  sparse[SIZE - 4097] = 4;
+
+  break_here ();
+  return 0;
+}
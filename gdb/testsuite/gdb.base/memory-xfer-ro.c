@@ -0,0 +1,60 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+typedef unsigned char chunk_t[64];
+
+/* Big enough for a read to be done in several transfers.  */
+unsigned char big_buf[65536];
+
+/* The bytes that GDB writes.  */
+chunk_t pattern;
+
+/* Two pages, the second of which is read-only.  */
+unsigned char *split_buf;
+long page_size;
+
+void
+marker (void)
+{
+}
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < sizeof (big_buf); i++)
+    big_buf[i] = i % 251;
+  for (i = 0; i < sizeof (pattern); i++)
+    pattern[i] = 0x80 + i;
+
+  page_size = sysconf (_SC_PAGESIZE);
+  split_buf = mmap (NULL, 2 * page_size, PROT_READ | PROT_WRITE,
+		    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (split_buf == MAP_FAILED)
+    return 1;
+  memset (split_buf, 0x11, 2 * page_size);
+  if (mprotect (split_buf + page_size, page_size, PROT_READ) != 0)
+    return 1;
+
+  marker ();
+  return 0;
+}
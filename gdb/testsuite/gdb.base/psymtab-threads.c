@@ -0,0 +1,35 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "psymtab-threads.h"
+
+int global1 = 1;
+static int static1 = 2;
+
+static int
+func1 (enum shared_enum e)
+{
+  return shared_inline (e) + static1;
+}
+
+int
+main (void)
+{
+  shared_typedef s = { 0 };
+
+  return func1 (SHARED_B) + func2 (&s) + global1;
+}
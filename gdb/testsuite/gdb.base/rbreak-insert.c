@@ -0,0 +1,45 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+volatile int counter;
+
+void
+rbreak_fn_1 (void)
+{
+  counter++;
+}
+
+void
+rbreak_fn_2 (void)
+{
+  counter++;
+}
+
+void
+rbreak_fn_3 (void)
+{
+  counter++;
+}
+
+int
+main (void)
+{
+  rbreak_fn_1 ();
+  rbreak_fn_2 ();
+  rbreak_fn_3 ();
+  return 0;
+}
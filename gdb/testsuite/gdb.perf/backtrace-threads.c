@@ -0,0 +1,79 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <limits.h>
+#include <unistd.h>
+
+#ifndef THREAD_COUNT
+#define THREAD_COUNT 1000
+#endif
+
+static pthread_barrier_t barrier;
+
+/* Block forever, DEPTH calls deep.  */
+
+static void
+recurse (int depth)
+{
+  if (depth > 0)
+    recurse (depth - 1);
+  else
+    {
+      pthread_barrier_wait (&barrier);
+      for (;;)
+	sleep (1);
+    }
+}
+
+static void *
+thread_function (void *arg)
+{
+  recurse ((long) arg % 8);
+
+  return NULL;
+}
+
+void
+breakpt (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_attr_t attr;
+  long i;
+
+  pthread_attr_init (&attr);
+  pthread_attr_setstacksize (&attr, PTHREAD_STACK_MIN);
+  pthread_barrier_init (&barrier, NULL, THREAD_COUNT + 1);
+
+  for (i = 0; i < THREAD_COUNT; i++)
+    {
+      pthread_t thread;
+
+      if (pthread_create (&thread, &attr, thread_function, (void *) i) != 0)
+	return 1;
+    }
+
+  /* Wait until every thread is blocked.  */
+  pthread_barrier_wait (&barrier);
+  breakpt ();
+
+  return 0;
+}
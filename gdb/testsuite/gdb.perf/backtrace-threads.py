@@ -0,0 +1,33 @@
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+class BacktraceThreads (perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, thread_count, backtrace_count):
+        super (BacktraceThreads, self).__init__ ("backtrace-threads")
+        self.thread_count = thread_count
+        self.backtrace_count = backtrace_count
+
+    def _run(self, r):
+        for _ in range(0, r):
+            gdb.execute("thread apply all backtrace", False, True)
+
+    def warm_up(self):
+        self._run(1)
+
+    def execute_test(self):
+        func = lambda: self._run(self.backtrace_count)
+        self.measure.measure(func, self.thread_count)
@@ -0,0 +1,95 @@
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# A TCP proxy which adds latency to a remote protocol connection, for
+# memory-read-pipelined.exp.  It is run by a separate GDB in batch
+# mode, so that it does not need the GIL of the GDB being measured.
+#
+# It accepts one connection on a free port, prints "Listening on port
+# N" once it is ready, and forwards the data to and from the address
+# in the environment variable GDB_PERF_PROXY_TARGET.  The data in each
+# direction is delayed by GDB_PERF_PROXY_LATENCY milliseconds, but
+# data sent in the meantime is not held up any longer, like on a long
+# link.
+
+import os
+import socket
+import sys
+import threading
+import time
+
+try:
+    import queue
+except ImportError:
+    import Queue as queue
+
+def _receive(source, pending, latency):
+    while True:
+        try:
+            data = source.recv (65536)
+        except socket.error:
+            data = b""
+        pending.put ((time.time () + latency, data))
+        if not data:
+            return
+
+def _send(destination, pending):
+    while True:
+        deadline, data = pending.get ()
+        delay = deadline - time.time ()
+        if delay > 0:
+            time.sleep (delay)
+        try:
+            if not data:
+                destination.shutdown (socket.SHUT_WR)
+                return
+            destination.sendall (data)
+        except socket.error:
+            return
+
+def _forward(source, destination, latency):
+    pending = queue.Queue ()
+    threads = [threading.Thread (target=_receive,
+                                 args=(source, pending, latency)),
+               threading.Thread (target=_send,
+                                 args=(destination, pending))]
+    for thread in threads:
+        thread.daemon = True
+        thread.start ()
+    return threads
+
+def proxy(target, latency_ms):
+    host, port = target.rsplit (":", 1)
+    latency = latency_ms / 1000.0
+
+    listener = socket.socket (socket.AF_INET, socket.SOCK_STREAM)
+    listener.bind (("127.0.0.1", 0))
+    listener.listen (1)
+    print ("Listening on port %d" % listener.getsockname ()[1])
+    sys.stdout.flush ()
+
+    client, _ = listener.accept ()
+    listener.close ()
+    server = socket.create_connection ((host or "localhost", int (port)))
+    for sock in (client, server):
+        sock.setsockopt (socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+    threads = (_forward (client, server, latency)
+               + _forward (server, client, latency))
+    for thread in threads:
+        thread.join ()
+
+proxy (os.environ["GDB_PERF_PROXY_TARGET"],
+       int (os.environ["GDB_PERF_PROXY_LATENCY"]))
@@ -0,0 +1,38 @@
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+class MemoryReadPipelined (perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, windows, read_size, read_count):
+        super (MemoryReadPipelined, self).__init__ ("memory-read-pipelined")
+        self.windows = windows
+        self.read_size = read_size
+        self.read_count = read_count
+        self.addr = int (gdb.parse_and_eval ("&buf[0]"))
+
+    def _run(self, window):
+        gdb.execute ("set remote memory-read-window %d" % window)
+        inferior = gdb.selected_inferior ()
+        for _ in range (0, self.read_count):
+            inferior.read_memory (self.addr, self.read_size)
+
+    def warm_up(self):
+        self._run (self.windows[0])
+
+    def execute_test(self):
+        for window in self.windows:
+            func = lambda: self._run (window)
+            self.measure.measure (func, window)
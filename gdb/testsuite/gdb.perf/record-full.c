@@ -0,0 +1,41 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+volatile int flag = 1;
+volatile long sink;
+long buf[64];
+
+void
+marker (void)
+{
+}
+
+int
+main (void)
+{
+  long i = 0;
+
+  while (flag)
+    {
+      buf[i & 63] += i;
+      sink = buf[(i * 7) & 63];
+      i++;
+      if ((i & 255) == 0)
+	marker ();
+    }
+  return 0;
+}
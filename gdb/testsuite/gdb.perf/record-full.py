@@ -0,0 +1,83 @@
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import re
+import time
+
+from perftest import perftest
+from perftest import measure
+from perftest import testresult
+
+def record_log_stats():
+    """Return the number of instructions in the execution log of
+    "record full", and the number of bytes the log uses."""
+    info = gdb.execute("info record", False, True)
+    insns = re.search("Log contains (\d+) instructions", info)
+    size = re.search("Log uses (\d+) bytes", info)
+    return (int(insns.group(1)) if insns else 0,
+            int(size.group(1)) if size else 0)
+
+class MeasurementInsnRate(measure.Measurement):
+    """Measurement on the number of instructions recorded per second."""
+
+    def __init__(self, result):
+        super(MeasurementInsnRate, self).__init__("insns_per_second", result)
+        self.start_insns = 0
+        self.start_time = 0
+
+    def start(self, id):
+        self.start_insns = record_log_stats()[0]
+        self.start_time = time.time()
+
+    def stop(self, id):
+        elapsed = time.time() - self.start_time
+        insns = record_log_stats()[0] - self.start_insns
+        self.result.record(id, insns / elapsed if elapsed > 0 else 0)
+
+class MeasurementLogDensity(measure.Measurement):
+    """Measurement on the bytes the execution log uses per instruction."""
+
+    def __init__(self, result):
+        super(MeasurementLogDensity, self).__init__("bytes_per_insn", result)
+
+    def start(self, id):
+        pass
+
+    def stop(self, id):
+        insns, size = record_log_stats()
+        self.result.record(id, float(size) / insns if insns > 0 else 0)
+
+class RecordFull(perftest.TestCase):
+    def __init__(self, count):
+        result_factory = testresult.SingleStatisticResultFactory()
+        measurements = [measure.MeasurementCpuTime(result_factory.create_result()),
+                        measure.MeasurementWallTime(result_factory.create_result()),
+                        measure.MeasurementVmSize(result_factory.create_result()),
+                        MeasurementInsnRate(result_factory.create_result()),
+                        MeasurementLogDensity(result_factory.create_result())]
+        super(RecordFull, self).__init__("record-full",
+                                         measure.Measure(measurements))
+        self.count = count
+
+    def _run(self, r):
+        for _ in range(0, r):
+            gdb.execute("continue", False, True)
+
+    def execute_test(self):
+        for i in range(1, 5):
+            gdb.execute("record full")
+            func = lambda: self._run(i * self.count)
+            self.measure.measure(func, i * self.count)
+            gdb.execute("record stop", False, True)
@@ -0,0 +1,47 @@
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+class ThreadsStopResume (perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, thread_count, stop_resume_count):
+        super (ThreadsStopResume, self).__init__ ("threads-stop-resume")
+        self.thread_count = thread_count
+        self.stop_resume_count = stop_resume_count
+
+    def _run(self, r):
+        for _ in range(0, r):
+            gdb.execute("continue", False, True)
+
+    def warm_up(self):
+        self._run(self.stop_resume_count)
+
+    def execute_test(self):
+        # Measure with up to five thread counts, each a quarter of the
+        # next one, ending with THREAD_COUNT.
+        counts = []
+        num = self.thread_count
+        while num > 0 and len(counts) < 5:
+            counts.insert(0, num)
+            num = num // 4
+
+        for num in counts:
+            # Let the inferior start the missing threads, and stop at
+            # the breakpoint again.
+            gdb.execute("set variable thread_count = %d" % num)
+            self._run(1)
+
+            func = lambda: self._run(self.stop_resume_count)
+            self.measure.measure(func, num)
@@ -0,0 +1,76 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see  <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <unistd.h>
+
+/* Incremented by the writer thread for as long as it runs.  */
+volatile unsigned long counter;
+
+/* Set by the idle thread once it is about to stop.  */
+volatile int idle_ready;
+
+static void *
+writer (void *arg)
+{
+  while (1)
+    counter++;
+
+  return NULL;
+}
+
+static void
+break_idle (void)
+{
+}
+
+static void *
+idle (void *arg)
+{
+  idle_ready = 1;
+  break_idle ();
+
+  while (1)
+    sleep (1);
+
+  return NULL;
+}
+
+static void
+break_here (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_t writer_thread, idle_thread;
+
+  alarm (300);
+
+  pthread_create (&writer_thread, NULL, writer, NULL);
+  pthread_create (&idle_thread, NULL, idle, NULL);
+
+  /* Wait for the other threads to start.  */
+  while (counter == 0 || !idle_ready)
+    ;
+
+  break_here ();
+
+  pthread_join (writer_thread, NULL);
+  return 0;
+}
@@ -0,0 +1,36 @@
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This file is part of the GDB testsuite.  It reads a variable which a
+# running thread keeps changing, before and after switching threads,
+# all within one command, so that nothing but the thread switch can
+# flush the data cache in between.
+
+import time
+
+import gdb
+
+def read_after_switch (num):
+    before = int (gdb.parse_and_eval ("counter"))
+    for thread in gdb.selected_inferior ().threads ():
+        if thread.num == num:
+            thread.switch ()
+    # Give the writer thread time to change the counter.
+    time.sleep (0.5)
+    after = int (gdb.parse_and_eval ("counter"))
+    if after != before:
+        print ("counter changed")
+    else:
+        print ("counter unchanged")
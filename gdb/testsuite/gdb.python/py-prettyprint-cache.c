@@ -0,0 +1,49 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+struct point
+{
+  int x;
+  int y;
+};
+
+struct item
+{
+  struct point p;
+  int weight;
+};
+
+struct bag
+{
+  int n;
+  struct item *items;
+};
+
+struct item items[4] = {
+  { { 0, 0 }, 10 },
+  { { 1, 2 }, 11 },
+  { { 2, 4 }, 12 },
+  { { 3, 6 }, 13 },
+};
+
+struct bag bag = { 4, items };
+
+int
+main (void)
+{
+  return 0;
+}
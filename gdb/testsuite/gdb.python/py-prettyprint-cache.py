@@ -0,0 +1,74 @@
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This file is part of the GDB testsuite.  It tests the caching of
+# pretty-printer lookups.
+
+import gdb
+
+
+class BagPrinter(object):
+    def __init__(self, val):
+        self.val = val
+
+    def to_string(self):
+        return "bag of %d" % int(self.val['n'])
+
+    def children(self):
+        for i in range(int(self.val['n'])):
+            yield ('[%d]' % i, self.val['items'][i])
+
+    def display_hint(self):
+        return 'array'
+
+
+class PointPrinter(object):
+    def __init__(self, val):
+        self.val = val
+
+    def to_string(self):
+        return "(%d, %d)" % (int(self.val['x']), int(self.val['y']))
+
+
+class ItemPrinter(object):
+    def __init__(self, val):
+        self.val = val
+
+    def to_string(self):
+        return "item %d" % int(self.val['weight'])
+
+
+lookup_calls = 0
+
+
+def lookup_function(val):
+    global lookup_calls
+    lookup_calls += 1
+
+    tag = val.type.strip_typedefs().tag
+    if tag == 'bag':
+        return BagPrinter(val)
+    if tag == 'point':
+        return PointPrinter(val)
+    return None
+
+
+def item_lookup_function(val):
+    if val.type.strip_typedefs().tag == 'item':
+        return ItemPrinter(val)
+    return None
+
+
+gdb.pretty_printers.append(lookup_function)
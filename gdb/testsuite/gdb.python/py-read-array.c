@@ -0,0 +1,76 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdlib.h>
+
+#define NINTS 100000
+
+int ints[NINTS];
+double doubles[3] = { 1.5, -2.25, 1e100 };
+
+struct item
+{
+  long key;
+  short tag;
+  char pad[20];
+};
+
+struct item items[10];
+
+struct node
+{
+  struct node *next;
+  int value;
+};
+
+struct node *head;
+
+enum color { RED, GREEN, BLUE };
+
+enum color colors[3] = { BLUE, RED, GREEN };
+
+static void
+break_here (void)
+{
+}
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < NINTS; i++)
+    ints[i] = i * 3 - 7;
+
+  for (i = 0; i < 10; i++)
+    {
+      items[i].key = i * 1000;
+      items[i].tag = -i;
+    }
+
+  for (i = 0; i < 5; i++)
+    {
+      struct node *n = (struct node *) malloc (sizeof (struct node));
+
+      n->value = i * i;
+      n->next = head;
+      head = n;
+    }
+
+  break_here ();
+  return 0;
+}
@@ -0,0 +1,33 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#define BUF_SIZE (64 * 1024)
+
+unsigned char buf[BUF_SIZE];
+
+int
+main (void)
+{
+  int i;
+
+  /* Something zlib can compress, with all the byte values which need
+     escaping.  */
+  for (i = 0; i < BUF_SIZE; i++)
+    buf[i] = (unsigned char) (i % 64 == 0 ? i / 64 : i % 7);
+
+  return 0; /* break here */
+}
@@ -0,0 +1,47 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define BUF_SIZE (256 * 1024)
+
+unsigned char buf[BUF_SIZE];
+
+/* The number of pages mapped at EDGE.  The page which follows them
+   is unmapped.  */
+#define EDGE_PAGES 16
+
+unsigned char *edge;
+long page_size;
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < BUF_SIZE; i++)
+    buf[i] = (unsigned char) (i * 7 + i / 251);
+
+  page_size = sysconf (_SC_PAGESIZE);
+  edge = mmap (NULL, (EDGE_PAGES + 1) * page_size, PROT_READ | PROT_WRITE,
+	       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  munmap (edge + EDGE_PAGES * page_size, page_size);
+  edge[EDGE_PAGES * page_size - 1] = 0x5a;
+
+  return 0; /* break here */
+}
@@ -44,6 +44,7 @@
 #include "thread-fsm.h"
 #include "tid-parse.h"
 #include <algorithm>
+#include <unordered_map>
 #include "common/gdb_optional.h"
 
 /* Definition of struct thread_info exported to gdbthread.h.  */
@@ -53,6 +54,22 @@
 struct thread_info *thread_list = NULL;
 static int highest_thread_num;
 
+/* The last thread of THREAD_LIST, after which new threads are
+   linked.  */
+static struct thread_info *thread_list_tail = NULL;
+
+/* Index of THREAD_LIST by ptid, so that looking a thread up does not
+   need to walk the whole list, which is slow with many threads.  Each
+   ptid maps to the first thread in the list with that ptid.  There
+   can be more than one, since a thread that exited but is still
+   referenced stays in the list until it can be deleted, and the OS
+   may reuse its id meanwhile.  */
+static std::unordered_map<ptid_t, thread_info *, hash_ptid> thread_ptid_map;
+
+/* The number of threads in THREAD_LIST.  While it equals the size of
+   THREAD_PTID_MAP, no two threads share a ptid.  */
+static size_t thread_list_length;
+
 /* True if any thread is, or may be executing.  We need to track this
    separately because until we fully sync the thread list, we won't
    know whether the target is fully stopped, even if we see stop
@@ -217,6 +234,47 @@ set_thread_exited (thread_info *tp, int silent)
     }
 }
 
+/* Point the entry of PTID in THREAD_PTID_MAP to the first thread of
+   the thread list with that ptid, or remove the entry if there is no
+   such thread.  */
+
+static void
+update_thread_ptid_map (ptid_t ptid)
+{
+  struct thread_info *tp;
+
+  for (tp = thread_list; tp; tp = tp->next)
+    if (tp->ptid == ptid)
+      {
+	thread_ptid_map[ptid] = tp;
+	return;
+      }
+
+  thread_ptid_map.erase (ptid);
+}
+
+/* Change the ptid of thread TP to PTID, keeping THREAD_PTID_MAP up to
+   date.  */
+
+static void
+set_thread_ptid (struct thread_info *tp, ptid_t ptid)
+{
+  ptid_t old_ptid = tp->ptid;
+
+  tp->ptid = ptid;
+
+  auto it = thread_ptid_map.find (old_ptid);
+  if (it != thread_ptid_map.end () && it->second == tp)
+    update_thread_ptid_map (old_ptid);
+
+  /* If another thread already has PTID, whichever comes first in the
+     list wins.  */
+  if (thread_ptid_map.find (ptid) == thread_ptid_map.end ())
+    thread_ptid_map[ptid] = tp;
+  else
+    update_thread_ptid_map (ptid);
+}
+
 void
 init_thread_list (void)
 {
@@ -237,9 +295,38 @@ init_thread_list (void)
     }
 
   thread_list = NULL;
+  thread_list_tail = NULL;
+  thread_ptid_map.clear ();
+  thread_list_length = 0;
   threads_executing = 0;
 }
 
+/* See gdbthread.h.  */
+
+scoped_mock_thread_list::scoped_mock_thread_list (struct thread_info *thread)
+  : m_saved_list (thread_list),
+    m_saved_tail (thread_list_tail),
+    m_saved_length (thread_list_length)
+{
+  m_saved_map.swap (thread_ptid_map);
+
+  thread->next = NULL;
+  thread_list = thread;
+  thread_list_tail = thread;
+  thread_list_length = 1;
+  thread_ptid_map.emplace (thread->ptid, thread);
+}
+
+/* See gdbthread.h.  */
+
+scoped_mock_thread_list::~scoped_mock_thread_list ()
+{
+  thread_list = m_saved_list;
+  thread_list_tail = m_saved_tail;
+  thread_list_length = m_saved_length;
+  thread_ptid_map.swap (m_saved_map);
+}
+
 /* Allocate a new thread of inferior INF with target id PTID and add
    it to the thread list.  */
 
@@ -251,13 +338,13 @@ new_thread (struct inferior *inf, ptid_t ptid)
   if (thread_list == NULL)
     thread_list = tp;
   else
-    {
-      struct thread_info *last;
+    thread_list_tail->next = tp;
+  thread_list_tail = tp;
+  thread_list_length++;
 
-      for (last = thread_list; last->next != NULL; last = last->next)
-	;
-      last->next = tp;
-    }
+  /* Since TP is last, it only becomes the indexed thread of PTID if
+     there is no other one.  */
+  thread_ptid_map.emplace (ptid, tp);
 
   return tp;
 }
@@ -295,7 +382,7 @@ add_thread_silent (ptid_t ptid)
 	  delete_thread (ptid);
 
 	  /* Now reset its ptid, and reswitch inferior_ptid to it.  */
-	  tp->ptid = ptid;
+	  set_thread_ptid (tp, ptid);
 	  tp->state = THREAD_STOPPED;
 	  switch_to_thread (ptid);
 
@@ -443,12 +530,7 @@ delete_thread_1 (ptid_t ptid, int silent)
 {
   struct thread_info *tp, *tpprev;
 
-  tpprev = NULL;
-
-  for (tp = thread_list; tp; tpprev = tp, tp = tp->next)
-    if (tp->ptid == ptid)
-      break;
-
+  tp = find_thread_ptid (ptid);
   if (!tp)
     return;
 
@@ -460,10 +542,28 @@ delete_thread_1 (ptid_t ptid, int silent)
        return;
      }
 
+  /* The list is only singly linked, so look for the thread before
+     TP.  */
+  tpprev = NULL;
+  if (tp != thread_list)
+    for (tpprev = thread_list; tpprev->next != tp; tpprev = tpprev->next)
+      ;
+
   if (tpprev)
     tpprev->next = tp->next;
   else
     thread_list = tp->next;
+  if (tp == thread_list_tail)
+    thread_list_tail = tpprev;
+  thread_list_length--;
+
+  /* Only look for another thread with the same ptid if there may be
+     one; walking the list for each thread made deleting all the
+     threads of an inferior quadratic.  */
+  if (thread_list_length >= thread_ptid_map.size ())
+    update_thread_ptid_map (ptid);
+  else
+    thread_ptid_map.erase (ptid);
 
   delete tp;
 }
@@ -513,13 +613,11 @@ find_thread_id (struct inferior *inf, int thr_num)
 struct thread_info *
 find_thread_ptid (ptid_t ptid)
 {
-  struct thread_info *tp;
+  auto it = thread_ptid_map.find (ptid);
 
-  for (tp = thread_list; tp; tp = tp->next)
-    if (tp->ptid == ptid)
-      return tp;
-
-  return NULL;
+  if (it == thread_ptid_map.end ())
+    return NULL;
+  return it->second;
 }
 
 /* See gdbthread.h.  */
@@ -604,11 +702,10 @@ valid_global_thread_id (int global_id)
 int
 ptid_to_global_thread_id (ptid_t ptid)
 {
-  struct thread_info *tp;
+  struct thread_info *tp = find_thread_ptid (ptid);
 
-  for (tp = thread_list; tp; tp = tp->next)
-    if (tp->ptid == ptid)
-      return tp->global_num;
+  if (tp != NULL)
+    return tp->global_num;
 
   return 0;
 }
@@ -627,11 +724,8 @@ global_thread_id_to_ptid (int global_id)
 int
 in_thread_list (ptid_t ptid)
 {
-  struct thread_info *tp;
-
-  for (tp = thread_list; tp; tp = tp->next)
-    if (tp->ptid == ptid)
-      return 1;
+  if (find_thread_ptid (ptid) != NULL)
+    return 1;
 
   return 0;			/* Never heard of 'im.  */
 }
@@ -819,7 +913,7 @@ thread_change_ptid (ptid_t old_ptid, ptid_t new_ptid)
   inf->pid = ptid_get_pid (new_ptid);
 
   tp = find_thread_ptid (old_ptid);
-  tp->ptid = new_ptid;
+  set_thread_ptid (tp, new_ptid);
 
   gdb::observers::thread_ptid_changed.notify (old_ptid, new_ptid);
 }
@@ -1638,7 +1732,7 @@ thread_apply_all_command (const char *cmd, int from_tty)
       for (thread_info *thr : thr_list_cpy)
 	if (thread_alive (thr))
 	  {
-	    switch_to_thread (thr->ptid);
+	    switch_to_thread (thr);
 	    printf_filtered (_("\nThread %s (%s):\n"),
 			     print_thread_id (thr),
 			     target_pid_to_str (inferior_ptid));
@@ -1595,12 +1595,26 @@ value_decref (struct value *val)
     }
 }
 
+/* Return an iterator to MARK in all_values, or all_values.end () if
+   it is not on the chain.  Marks are almost always close to the end
+   of the chain, which can grow very long while a big value is
+   printed, so search backwards.  */
+
+static std::vector<value_ref_ptr>::iterator
+find_value_mark (const struct value *mark)
+{
+  auto iter = std::find (all_values.rbegin (), all_values.rend (), mark);
+  if (iter == all_values.rend ())
+    return all_values.end ();
+  return iter.base () - 1;
+}
+
 /* Free all values allocated since MARK was obtained by value_mark
    (except for those released).  */
 void
 value_free_to_mark (const struct value *mark)
 {
-  auto iter = std::find (all_values.begin (), all_values.end (), mark);
+  auto iter = find_value_mark (mark);
   if (iter == all_values.end ())
     all_values.clear ();
   else
@@ -1640,7 +1654,7 @@ value_release_to_mark (const struct value *mark)
 {
   std::vector<value_ref_ptr> result;
 
-  auto iter = std::find (all_values.begin (), all_values.end (), mark);
+  auto iter = find_value_mark (mark);
   if (iter == all_values.end ())
     std::swap (result, all_values);
   else
@@ -0,0 +1,1826 @@
+// dedup_debug_output.cc -- remove duplicate debug type definitions
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+#include "md5.h"
+
+#include "elfcpp_swap.h"
+#include "dwarf.h"
+#include "parameters.h"
+#include "target.h"
+#include "int_encoding.h"
+#include "dedup_debug_output.h"
+
+namespace gold
+{
+
+namespace
+{
+
+// The size of a compilation unit header in 32-bit DWARF versions 2
+// to 4.
+
+const unsigned int unit_header_size = 11;
+
+// The deepest chain of unnamed types we follow when computing the
+// checksum of a type definition.
+
+const int max_reference_depth = 16;
+
+// Read an unsigned LEB128 value from the SIZE bytes at P.  Return the
+// number of bytes read, or 0 if the value runs past the end.  This is
+// also used to skip signed LEB128 values.
+
+size_t
+read_leb(const unsigned char* p, uint64_t size, uint64_t* value)
+{
+  uint64_t result = 0;
+  unsigned int shift = 0;
+  for (uint64_t i = 0; i < size; ++i)
+    {
+      unsigned char byte = p[i];
+      if (shift < 64)
+	result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      shift += 7;
+      if ((byte & 0x80) == 0)
+	{
+	  *value = result;
+	  return i + 1;
+	}
+    }
+  return 0;
+}
+
+// Write VALUE as an unsigned LEB128 value padded to SIZE bytes.  The
+// value always fits, as offsets only ever get smaller.
+
+void
+write_padded_leb(unsigned char* p, unsigned int size, uint64_t value)
+{
+  for (unsigned int i = 0; i + 1 < size; ++i)
+    {
+      p[i] = (value & 0x7f) | 0x80;
+      value >>= 7;
+    }
+  gold_assert(value < 0x80);
+  p[size - 1] = value;
+}
+
+// Add VALUE to the checksum.
+
+void
+hash_value(md5_ctx* ctx, uint64_t value)
+{
+  md5_process_bytes(&value, sizeof value, ctx);
+}
+
+// Compare an offset with the offset of a unit, stub or DIE, for
+// binary searches.
+
+struct Offset_less
+{
+  template<typename T>
+  bool
+  operator()(uint64_t offset, const T& t) const
+  { return offset < t.offset; }
+};
+
+// Whether TAG is a type which we may replace with a declaration.
+
+bool
+is_aggregate_tag(unsigned int tag)
+{
+  return (tag == elfcpp::DW_TAG_structure_type
+	  || tag == elfcpp::DW_TAG_class_type
+	  || tag == elfcpp::DW_TAG_union_type
+	  || tag == elfcpp::DW_TAG_enumeration_type);
+}
+
+// Whether TAG is a type which we follow when computing the checksum
+// of a type definition which refers to it.
+
+bool
+is_type_tag(unsigned int tag)
+{
+  switch (tag)
+    {
+    case elfcpp::DW_TAG_array_type:
+    case elfcpp::DW_TAG_class_type:
+    case elfcpp::DW_TAG_enumeration_type:
+    case elfcpp::DW_TAG_pointer_type:
+    case elfcpp::DW_TAG_reference_type:
+    case elfcpp::DW_TAG_string_type:
+    case elfcpp::DW_TAG_structure_type:
+    case elfcpp::DW_TAG_subroutine_type:
+    case elfcpp::DW_TAG_typedef:
+    case elfcpp::DW_TAG_union_type:
+    case elfcpp::DW_TAG_ptr_to_member_type:
+    case elfcpp::DW_TAG_subrange_type:
+    case elfcpp::DW_TAG_base_type:
+    case elfcpp::DW_TAG_const_type:
+    case elfcpp::DW_TAG_volatile_type:
+    case elfcpp::DW_TAG_restrict_type:
+    case elfcpp::DW_TAG_unspecified_type:
+    case elfcpp::DW_TAG_rvalue_reference_type:
+    case elfcpp::DW_TAG_atomic_type:
+      return true;
+    default:
+      return false;
+    }
+}
+
+} // End anonymous namespace.
+
+Debug_type_dedup::Debug_type_dedup()
+  : big_endian_(false), finalized_(false), unchanged_(true),
+    abbrev_tables_(), units_(), candidates_(), global_refs_(),
+    patched_location_lists_(), info_(), abbrev_(), abbrev_shifts_(),
+    stub_count_(0),
+    removed_bytes_(0)
+{
+  for (int i = 0; i < DEBUG_SECTION_COUNT; ++i)
+    {
+      this->sections_[i] = NULL;
+      this->contents_[i] = NULL;
+      this->sizes_[i] = 0;
+    }
+}
+
+// Return the kind of the debug section NAME.
+
+Debug_type_dedup::Section_kind
+Debug_type_dedup::section_kind(const char* name)
+{
+  static const struct
+  {
+    const char* name;
+    Section_kind kind;
+  } sections[] =
+  {
+    { ".debug_info", DEBUG_INFO },
+    { ".debug_abbrev", DEBUG_ABBREV },
+    { ".debug_types", DEBUG_TYPES },
+    { ".debug_aranges", DEBUG_ARANGES },
+    { ".debug_pubnames", DEBUG_PUBNAMES },
+    { ".debug_pubtypes", DEBUG_PUBTYPES },
+    { ".debug_gnu_pubnames", DEBUG_GNU_PUBNAMES },
+    { ".debug_gnu_pubtypes", DEBUG_GNU_PUBTYPES },
+    { ".debug_loc", DEBUG_LOC },
+    { ".debug_names", DEBUG_NAMES },
+  };
+  for (size_t i = 0; i < sizeof(sections) / sizeof(sections[0]); ++i)
+    if (strcmp(name, sections[i].name) == 0)
+      return sections[i].kind;
+  return DEBUG_SECTION_COUNT;
+}
+
+// Give up, and copy the sections unchanged.
+
+void
+Debug_type_dedup::failed(const char* reason)
+{
+  gold_warning(_("%s; not removing duplicate debug types"), reason);
+  this->unchanged_ = true;
+}
+
+// Read a SIZE byte value at P.
+
+uint64_t
+Debug_type_dedup::read_value(const unsigned char* p, unsigned int size) const
+{
+  switch (size)
+    {
+    case 1:
+      return *p;
+    case 2:
+      return (this->big_endian_
+	      ? elfcpp::Swap_unaligned<16, true>::readval(p)
+	      : elfcpp::Swap_unaligned<16, false>::readval(p));
+    case 4:
+      return (this->big_endian_
+	      ? elfcpp::Swap_unaligned<32, true>::readval(p)
+	      : elfcpp::Swap_unaligned<32, false>::readval(p));
+    case 8:
+      return (this->big_endian_
+	      ? elfcpp::Swap_unaligned<64, true>::readval(p)
+	      : elfcpp::Swap_unaligned<64, false>::readval(p));
+    default:
+      gold_unreachable();
+    }
+}
+
+// Write VALUE as a SIZE byte value at P.
+
+void
+Debug_type_dedup::write_value(unsigned char* p, unsigned int size,
+			      uint64_t value) const
+{
+  switch (size)
+    {
+    case 1:
+      gold_assert(value < 0x100);
+      *p = value;
+      break;
+    case 2:
+      gold_assert(value < 0x10000);
+      if (this->big_endian_)
+	elfcpp::Swap_unaligned<16, true>::writeval(p, value);
+      else
+	elfcpp::Swap_unaligned<16, false>::writeval(p, value);
+      break;
+    case 4:
+      if (this->big_endian_)
+	elfcpp::Swap_unaligned<32, true>::writeval(p, value);
+      else
+	elfcpp::Swap_unaligned<32, false>::writeval(p, value);
+      break;
+    case 8:
+      if (this->big_endian_)
+	elfcpp::Swap_unaligned<64, true>::writeval(p, value);
+      else
+	elfcpp::Swap_unaligned<64, false>::writeval(p, value);
+      break;
+    default:
+      gold_unreachable();
+    }
+}
+
+// Read the abbreviation table at OFFSET in .debug_abbrev.  Return
+// NULL if it is invalid.
+
+const Debug_type_dedup::Abbrev_table*
+Debug_type_dedup::read_abbrev_table(uint64_t offset)
+{
+  Unordered_map<uint64_t, Abbrev_table>::const_iterator p =
+    this->abbrev_tables_.find(offset);
+  if (p != this->abbrev_tables_.end())
+    return &p->second;
+
+  const unsigned char* buffer = this->contents_[DEBUG_ABBREV];
+  uint64_t size = this->sizes_[DEBUG_ABBREV];
+  Abbrev_table table;
+  table.max_code = 0;
+  uint64_t off = offset;
+  for (;;)
+    {
+      if (off >= size)
+	return NULL;
+      uint64_t code;
+      size_t len = read_leb(buffer + off, size - off, &code);
+      if (len == 0)
+	return NULL;
+      if (code == 0)
+	{
+	  table.end = off;
+	  break;
+	}
+      off += len;
+
+      if (table.abbrevs.find(code) != table.abbrevs.end())
+	return NULL;
+      Abbrev& abbrev(table.abbrevs[code]);
+      uint64_t tag;
+      len = read_leb(buffer + off, size - off, &tag);
+      if (len == 0)
+	return NULL;
+      off += len;
+      if (off >= size)
+	return NULL;
+      abbrev.tag = tag;
+      abbrev.has_children = buffer[off] != elfcpp::DW_CHILDREN_no;
+      ++off;
+
+      for (;;)
+	{
+	  uint64_t attr;
+	  uint64_t form;
+	  len = read_leb(buffer + off, size - off, &attr);
+	  if (len == 0)
+	    return NULL;
+	  off += len;
+	  len = read_leb(buffer + off, size - off, &form);
+	  if (len == 0)
+	    return NULL;
+	  off += len;
+	  if (attr == 0 && form == 0)
+	    break;
+	  abbrev.attributes.push_back(std::make_pair(attr, form));
+	}
+
+      if (code > table.max_code)
+	table.max_code = code;
+    }
+
+  Abbrev_table& entry(this->abbrev_tables_[offset]);
+  entry = table;
+  return &entry;
+}
+
+// Set *SIZE to the size of the attribute value of form FORM at
+// OFFSET in .debug_info.  Return false if the form is not supported
+// or the value extends beyond the end of UNIT.
+
+bool
+Debug_type_dedup::attribute_size(const Unit& unit, unsigned int form,
+				 uint64_t offset, uint64_t* size) const
+{
+  const unsigned char* p = this->contents_[DEBUG_INFO] + offset;
+  uint64_t avail = unit.end - offset;
+  uint64_t value;
+  size_t len;
+  uint64_t s;
+  switch (form)
+    {
+    case elfcpp::DW_FORM_flag_present:
+      s = 0;
+      break;
+    case elfcpp::DW_FORM_data1:
+    case elfcpp::DW_FORM_ref1:
+    case elfcpp::DW_FORM_flag:
+      s = 1;
+      break;
+    case elfcpp::DW_FORM_data2:
+    case elfcpp::DW_FORM_ref2:
+      s = 2;
+      break;
+    case elfcpp::DW_FORM_data4:
+    case elfcpp::DW_FORM_ref4:
+    case elfcpp::DW_FORM_strp:
+    case elfcpp::DW_FORM_sec_offset:
+    case elfcpp::DW_FORM_GNU_ref_alt:
+    case elfcpp::DW_FORM_GNU_strp_alt:
+      s = 4;
+      break;
+    case elfcpp::DW_FORM_data8:
+    case elfcpp::DW_FORM_ref8:
+    case elfcpp::DW_FORM_ref_sig8:
+      s = 8;
+      break;
+    case elfcpp::DW_FORM_addr:
+      s = unit.address_size;
+      break;
+    case elfcpp::DW_FORM_ref_addr:
+      s = unit.version == 2 ? unit.address_size : 4;
+      break;
+    case elfcpp::DW_FORM_sdata:
+    case elfcpp::DW_FORM_udata:
+    case elfcpp::DW_FORM_ref_udata:
+    case elfcpp::DW_FORM_GNU_addr_index:
+    case elfcpp::DW_FORM_GNU_str_index:
+      s = read_leb(p, avail, &value);
+      if (s == 0)
+	return false;
+      break;
+    case elfcpp::DW_FORM_string:
+      {
+	const void* nul = memchr(p, 0, avail);
+	if (nul == NULL)
+	  return false;
+	s = static_cast<const unsigned char*>(nul) - p + 1;
+      }
+      break;
+    case elfcpp::DW_FORM_block1:
+      if (avail < 1)
+	return false;
+      s = 1 + *p;
+      break;
+    case elfcpp::DW_FORM_block2:
+      if (avail < 2)
+	return false;
+      s = 2 + this->read_value(p, 2);
+      break;
+    case elfcpp::DW_FORM_block4:
+      if (avail < 4)
+	return false;
+      s = 4 + this->read_value(p, 4);
+      break;
+    case elfcpp::DW_FORM_block:
+    case elfcpp::DW_FORM_exprloc:
+      len = read_leb(p, avail, &value);
+      if (len == 0)
+	return false;
+      s = len + value;
+      break;
+    default:
+      return false;
+    }
+  if (s > avail)
+    return false;
+  *size = s;
+  return true;
+}
+
+// Whether FORM is a reference to another DIE in .debug_info.
+
+bool
+Debug_type_dedup::is_ref_form(unsigned int form)
+{
+  return (form == elfcpp::DW_FORM_ref1
+	  || form == elfcpp::DW_FORM_ref2
+	  || form == elfcpp::DW_FORM_ref4
+	  || form == elfcpp::DW_FORM_ref8
+	  || form == elfcpp::DW_FORM_ref_udata
+	  || form == elfcpp::DW_FORM_ref_addr);
+}
+
+// Whether a block value of ATTR holds a DWARF expression in DWARF
+// versions before 4, which have no DW_FORM_exprloc.
+
+bool
+Debug_type_dedup::is_location_attribute(unsigned int attr)
+{
+  switch (attr)
+    {
+    case elfcpp::DW_AT_location:
+    case elfcpp::DW_AT_string_length:
+    case elfcpp::DW_AT_return_addr:
+    case elfcpp::DW_AT_frame_base:
+    case elfcpp::DW_AT_segment:
+    case elfcpp::DW_AT_static_link:
+    case elfcpp::DW_AT_use_location:
+    case elfcpp::DW_AT_data_member_location:
+    case elfcpp::DW_AT_vtable_elem_location:
+    case elfcpp::DW_AT_lower_bound:
+    case elfcpp::DW_AT_upper_bound:
+    case elfcpp::DW_AT_count:
+    case elfcpp::DW_AT_byte_size:
+    case elfcpp::DW_AT_bit_size:
+    case elfcpp::DW_AT_byte_stride:
+    case elfcpp::DW_AT_bit_stride:
+    case elfcpp::DW_AT_data_location:
+    case elfcpp::DW_AT_allocated:
+    case elfcpp::DW_AT_associated:
+    case elfcpp::DW_AT_GNU_call_site_value:
+    case elfcpp::DW_AT_GNU_call_site_data_value:
+    case elfcpp::DW_AT_GNU_call_site_target:
+    case elfcpp::DW_AT_GNU_call_site_target_clobbered:
+      return true;
+    default:
+      return false;
+    }
+}
+
+// Whether attribute ATTR of form FORM holds a DWARF expression.
+
+bool
+Debug_type_dedup::is_expression(const Unit& unit, unsigned int attr,
+				unsigned int form) const
+{
+  if (form == elfcpp::DW_FORM_exprloc)
+    return true;
+  if (unit.version >= 4)
+    return false;
+  return ((form == elfcpp::DW_FORM_block1
+	   || form == elfcpp::DW_FORM_block2
+	   || form == elfcpp::DW_FORM_block4
+	   || form == elfcpp::DW_FORM_block)
+	  && is_location_attribute(attr));
+}
+
+// Whether attribute ATTR of form FORM is an offset in .debug_loc.
+
+bool
+Debug_type_dedup::is_location_list(const Unit& unit, unsigned int attr,
+				   unsigned int form) const
+{
+  switch (attr)
+    {
+    case elfcpp::DW_AT_location:
+    case elfcpp::DW_AT_string_length:
+    case elfcpp::DW_AT_return_addr:
+    case elfcpp::DW_AT_frame_base:
+    case elfcpp::DW_AT_segment:
+    case elfcpp::DW_AT_static_link:
+    case elfcpp::DW_AT_use_location:
+      break;
+    default:
+      return false;
+    }
+  if (unit.version >= 4)
+    return form == elfcpp::DW_FORM_sec_offset;
+  return form == elfcpp::DW_FORM_data4 || form == elfcpp::DW_FORM_data8;
+}
+
+// Set *DATA_OFFSET and *DATA_SIZE to the contents of the block value
+// of form FORM at OFFSET.
+
+bool
+Debug_type_dedup::block_contents(const Unit& unit, unsigned int form,
+				 uint64_t offset, uint64_t* data_offset,
+				 uint64_t* data_size) const
+{
+  uint64_t size;
+  if (!this->attribute_size(unit, form, offset, &size))
+    return false;
+  uint64_t len;
+  switch (form)
+    {
+    case elfcpp::DW_FORM_block1:
+      len = 1;
+      break;
+    case elfcpp::DW_FORM_block2:
+      len = 2;
+      break;
+    case elfcpp::DW_FORM_block4:
+      len = 4;
+      break;
+    default:
+      {
+	uint64_t value;
+	len = read_leb(this->contents_[DEBUG_INFO] + offset, size, &value);
+      }
+      break;
+    }
+  *data_offset = offset + len;
+  *data_size = size - len;
+  return true;
+}
+
+// Find the DIE references in the DWARF expression EXPR of SIZE bytes,
+// and add them to REFS.  Return false if the expression uses an
+// operation we do not know.
+
+bool
+Debug_type_dedup::read_expression(const Unit& unit, const unsigned char* expr,
+				  size_t size,
+				  std::vector<Expr_ref>* refs) const
+{
+  unsigned int ref_size = unit.version == 2 ? unit.address_size : 4;
+  size_t i = 0;
+  while (i < size)
+    {
+      unsigned int op = expr[i++];
+      uint64_t value;
+      size_t len;
+
+      if ((op >= elfcpp::DW_OP_lit0 && op <= elfcpp::DW_OP_lit31)
+	  || (op >= elfcpp::DW_OP_reg0 && op <= elfcpp::DW_OP_reg31))
+	continue;
+      if (op >= elfcpp::DW_OP_breg0 && op <= elfcpp::DW_OP_breg31)
+	{
+	  len = read_leb(expr + i, size - i, &value);
+	  if (len == 0)
+	    return false;
+	  i += len;
+	  continue;
+	}
+
+      // The number of fixed size operand bytes, and the number of
+      // LEB128 operands, which follow any reference.
+      uint64_t fixed = 0;
+      int lebs = 0;
+      // A reference operand, if any.
+      unsigned int ref_bytes = 0;
+      bool ref_is_leb = false;
+      bool ref_is_section_offset = false;
+
+      switch (op)
+	{
+	case elfcpp::DW_OP_deref:
+	case elfcpp::DW_OP_dup:
+	case elfcpp::DW_OP_drop:
+	case elfcpp::DW_OP_over:
+	case elfcpp::DW_OP_swap:
+	case elfcpp::DW_OP_rot:
+	case elfcpp::DW_OP_xderef:
+	case elfcpp::DW_OP_abs:
+	case elfcpp::DW_OP_and:
+	case elfcpp::DW_OP_div:
+	case elfcpp::DW_OP_minus:
+	case elfcpp::DW_OP_mod:
+	case elfcpp::DW_OP_mul:
+	case elfcpp::DW_OP_neg:
+	case elfcpp::DW_OP_not:
+	case elfcpp::DW_OP_or:
+	case elfcpp::DW_OP_plus:
+	case elfcpp::DW_OP_shl:
+	case elfcpp::DW_OP_shr:
+	case elfcpp::DW_OP_shra:
+	case elfcpp::DW_OP_xor:
+	case elfcpp::DW_OP_eq:
+	case elfcpp::DW_OP_ge:
+	case elfcpp::DW_OP_gt:
+	case elfcpp::DW_OP_le:
+	case elfcpp::DW_OP_lt:
+	case elfcpp::DW_OP_ne:
+	case elfcpp::DW_OP_nop:
+	case elfcpp::DW_OP_push_object_address:
+	case elfcpp::DW_OP_form_tls_address:
+	case elfcpp::DW_OP_call_frame_cfa:
+	case elfcpp::DW_OP_stack_value:
+	case elfcpp::DW_OP_GNU_push_tls_address:
+	case elfcpp::DW_OP_GNU_uninit:
+	  break;
+
+	case elfcpp::DW_OP_addr:
+	  fixed = unit.address_size;
+	  break;
+
+	case elfcpp::DW_OP_const1u:
+	case elfcpp::DW_OP_const1s:
+	case elfcpp::DW_OP_pick:
+	case elfcpp::DW_OP_deref_size:
+	case elfcpp::DW_OP_xderef_size:
+	  fixed = 1;
+	  break;
+
+	case elfcpp::DW_OP_const2u:
+	case elfcpp::DW_OP_const2s:
+	case elfcpp::DW_OP_bra:
+	case elfcpp::DW_OP_skip:
+	  fixed = 2;
+	  break;
+
+	case elfcpp::DW_OP_const4u:
+	case elfcpp::DW_OP_const4s:
+	  fixed = 4;
+	  break;
+
+	case elfcpp::DW_OP_const8u:
+	case elfcpp::DW_OP_const8s:
+	  fixed = 8;
+	  break;
+
+	case elfcpp::DW_OP_constu:
+	case elfcpp::DW_OP_consts:
+	case elfcpp::DW_OP_plus_uconst:
+	case elfcpp::DW_OP_regx:
+	case elfcpp::DW_OP_fbreg:
+	case elfcpp::DW_OP_piece:
+	case elfcpp::DW_OP_addrx:
+	case elfcpp::DW_OP_constx:
+	case elfcpp::DW_OP_GNU_addr_index:
+	case elfcpp::DW_OP_GNU_const_index:
+	  lebs = 1;
+	  break;
+
+	case elfcpp::DW_OP_bregx:
+	case elfcpp::DW_OP_bit_piece:
+	  lebs = 2;
+	  break;
+
+	case elfcpp::DW_OP_implicit_value:
+	  len = read_leb(expr + i, size - i, &value);
+	  if (len == 0)
+	    return false;
+	  i += len;
+	  fixed = value;
+	  break;
+
+	case elfcpp::DW_OP_call2:
+	  ref_bytes = 2;
+	  break;
+
+	case elfcpp::DW_OP_call4:
+	case elfcpp::DW_OP_GNU_parameter_ref:
+	  ref_bytes = 4;
+	  break;
+
+	case elfcpp::DW_OP_call_ref:
+	case elfcpp::DW_OP_GNU_variable_value:
+	  ref_bytes = ref_size;
+	  ref_is_section_offset = true;
+	  break;
+
+	case elfcpp::DW_OP_implicit_pointer:
+	case elfcpp::DW_OP_GNU_implicit_pointer:
+	  ref_bytes = ref_size;
+	  ref_is_section_offset = true;
+	  lebs = 1;
+	  break;
+
+	case elfcpp::DW_OP_entry_value:
+	case elfcpp::DW_OP_GNU_entry_value:
+	  {
+	    len = read_leb(expr + i, size - i, &value);
+	    if (len == 0 || value > size - i - len)
+	      return false;
+	    i += len;
+	    std::vector<Expr_ref> sub_refs;
+	    if (!this->read_expression(unit, expr + i, value, &sub_refs))
+	      return false;
+	    for (size_t j = 0; j < sub_refs.size(); ++j)
+	      {
+		sub_refs[j].offset += i;
+		refs->push_back(sub_refs[j]);
+	      }
+	    i += value;
+	  }
+	  continue;
+
+	case elfcpp::DW_OP_const_type:
+	case elfcpp::DW_OP_GNU_const_type:
+	  {
+	    Expr_ref ref;
+	    len = read_leb(expr + i, size - i, &value);
+	    if (len == 0 || i + len >= size)
+	      return false;
+	    ref.offset = i;
+	    ref.size = len;
+	    ref.is_leb = true;
+	    ref.is_section_offset = false;
+	    ref.value = value;
+	    refs->push_back(ref);
+	    i += len;
+	    fixed = 1 + expr[i];
+	  }
+	  break;
+
+	case elfcpp::DW_OP_regval_type:
+	case elfcpp::DW_OP_GNU_regval_type:
+	  len = read_leb(expr + i, size - i, &value);
+	  if (len == 0)
+	    return false;
+	  i += len;
+	  ref_is_leb = true;
+	  break;
+
+	case elfcpp::DW_OP_deref_type:
+	case elfcpp::DW_OP_GNU_deref_type:
+	case elfcpp::DW_OP_xderef_type:
+	  if (i >= size)
+	    return false;
+	  ++i;
+	  ref_is_leb = true;
+	  break;
+
+	case elfcpp::DW_OP_convert:
+	case elfcpp::DW_OP_GNU_convert:
+	case elfcpp::DW_OP_reinterpret:
+	case elfcpp::DW_OP_GNU_reinterpret:
+	  ref_is_leb = true;
+	  break;
+
+	default:
+	  return false;
+	}
+
+      if (ref_bytes != 0 || ref_is_leb)
+	{
+	  Expr_ref ref;
+	  ref.offset = i;
+	  ref.is_leb = ref_is_leb;
+	  ref.is_section_offset = ref_is_section_offset;
+	  if (ref_is_leb)
+	    {
+	      len = read_leb(expr + i, size - i, &value);
+	      if (len == 0)
+		return false;
+	      ref.size = len;
+	    }
+	  else
+	    {
+	      if (size - i < ref_bytes)
+		return false;
+	      value = this->read_value(expr + i, ref_bytes);
+	      ref.size = ref_bytes;
+	    }
+	  ref.value = value;
+	  // A zero type offset in DW_OP_convert and DW_OP_reinterpret
+	  // means the generic type.
+	  if (!ref_is_leb || value != 0)
+	    refs->push_back(ref);
+	  i += ref.size;
+	}
+
+      for (int j = 0; j < lebs; ++j)
+	{
+	  len = read_leb(expr + i, size - i, &value);
+	  if (len == 0)
+	    return false;
+	  i += len;
+	}
+
+      if (fixed > size - i)
+	return false;
+      i += fixed;
+    }
+  return true;
+}
+
+// Find the DIE references in the location list at OFFSET in
+// .debug_loc, and add them to REFS.  The offsets in REFS are offsets
+// in .debug_loc.
+
+bool
+Debug_type_dedup::read_location_list(const Unit& unit, uint64_t offset,
+				     std::vector<Expr_ref>* refs) const
+{
+  const unsigned char* loc = this->contents_[DEBUG_LOC];
+  uint64_t size = this->sizes_[DEBUG_LOC];
+  unsigned int address_size = unit.address_size;
+  if (loc == NULL)
+    return false;
+  uint64_t base_address_selection = (address_size == 4
+				     ? 0xffffffff
+				     : static_cast<uint64_t>(-1));
+  for (;;)
+    {
+      if (offset > size || size - offset < 2 * address_size)
+	return false;
+      uint64_t begin = this->read_value(loc + offset, address_size);
+      uint64_t end = this->read_value(loc + offset + address_size,
+				      address_size);
+      offset += 2 * address_size;
+      if (begin == 0 && end == 0)
+	return true;
+      if (begin == base_address_selection)
+	continue;
+
+      if (size - offset < 2)
+	return false;
+      uint64_t len = this->read_value(loc + offset, 2);
+      offset += 2;
+      if (size - offset < len)
+	return false;
+      std::vector<Expr_ref> expr_refs;
+      if (!this->read_expression(unit, loc + offset, len, &expr_refs))
+	return false;
+      for (size_t i = 0; i < expr_refs.size(); ++i)
+	{
+	  expr_refs[i].offset += offset;
+	  refs->push_back(expr_refs[i]);
+	}
+      offset += len;
+    }
+}
+
+// Record the DIE reference REF, found in the DIE at SOURCE.
+// References within UNIT go in REFS, others in global_refs_.
+
+void
+Debug_type_dedup::add_reference(const Unit& unit, const Expr_ref& ref,
+				uint64_t source, std::vector<Reference>* refs)
+{
+  uint64_t target = (ref.is_section_offset
+		     ? ref.value
+		     : unit.offset + ref.value);
+  if (target >= unit.offset && target < unit.end)
+    refs->push_back(Reference(target, source));
+  else
+    this->global_refs_.push_back(Reference(target, source));
+}
+
+// Scan the DIEs in a compilation unit.  Record the references between
+// DIEs, and the type definitions which we may replace.  Return false
+// if we find something we do not understand.
+
+bool
+Debug_type_dedup::scan_unit(size_t unit_index)
+{
+  const Unit& unit(this->units_[unit_index]);
+  const unsigned char* info = this->contents_[DEBUG_INFO];
+
+  std::vector<Die> dies;
+  std::vector<int> parents;
+  std::vector<Reference> refs;
+  std::vector<Expr_ref> expr_refs;
+
+  uint64_t offset = unit.offset + unit_header_size;
+  while (offset < unit.end)
+    {
+      uint64_t die_offset = offset;
+      uint64_t code;
+      size_t len = read_leb(info + offset, unit.end - offset, &code);
+      if (len == 0)
+	return false;
+      offset += len;
+      if (code == 0)
+	{
+	  // A null entry ends a list of children.  At the top level it
+	  // is padding.
+	  if (!parents.empty())
+	    {
+	      dies[parents.back()].end = offset;
+	      parents.pop_back();
+	    }
+	  continue;
+	}
+
+      Unordered_map<uint64_t, Abbrev>::const_iterator p =
+	unit.abbrevs->abbrevs.find(code);
+      if (p == unit.abbrevs->abbrevs.end())
+	return false;
+
+      Die die;
+      die.offset = die_offset;
+      die.end = 0;
+      die.parent = parents.empty() ? -1 : parents.back();
+      die.abbrev = &p->second;
+      die.name_offset = 0;
+      die.name_size = 0;
+      die.name_form = 0;
+      die.is_declaration = false;
+
+      const std::vector<std::pair<unsigned int, unsigned int> >& attributes =
+	die.abbrev->attributes;
+      for (size_t i = 0; i < attributes.size(); ++i)
+	{
+	  unsigned int attr = attributes[i].first;
+	  unsigned int form = attributes[i].second;
+	  uint64_t size;
+	  if (!this->attribute_size(unit, form, offset, &size))
+	    return false;
+
+	  if (attr == elfcpp::DW_AT_name
+	      && (form == elfcpp::DW_FORM_string
+		  || form == elfcpp::DW_FORM_strp))
+	    {
+	      die.name_offset = offset;
+	      die.name_size = size;
+	      die.name_form = form;
+	    }
+	  else if (attr == elfcpp::DW_AT_declaration)
+	    die.is_declaration = (form == elfcpp::DW_FORM_flag_present
+				  || info[offset] != 0);
+
+	  if (is_ref_form(form))
+	    {
+	      Expr_ref ref;
+	      if (form == elfcpp::DW_FORM_ref_udata)
+		{
+		  if (read_leb(info + offset, size, &ref.value) == 0)
+		    return false;
+		}
+	      else
+		ref.value = this->read_value(info + offset, size);
+	      ref.is_section_offset = form == elfcpp::DW_FORM_ref_addr;
+	      this->add_reference(unit, ref, die_offset, &refs);
+	    }
+	  else if (this->is_expression(unit, attr, form))
+	    {
+	      uint64_t data_offset;
+	      uint64_t data_size;
+	      expr_refs.clear();
+	      if (!this->block_contents(unit, form, offset, &data_offset,
+					&data_size)
+		  || !this->read_expression(unit, info + data_offset,
+					    data_size, &expr_refs))
+		return false;
+	      for (size_t j = 0; j < expr_refs.size(); ++j)
+		this->add_reference(unit, expr_refs[j], die_offset, &refs);
+	    }
+	  else if (this->is_location_list(unit, attr, form))
+	    {
+	      expr_refs.clear();
+	      if (!this->read_location_list(unit,
+					    this->read_value(info + offset,
+							     size),
+					    &expr_refs))
+		return false;
+	      for (size_t j = 0; j < expr_refs.size(); ++j)
+		this->add_reference(unit, expr_refs[j], die_offset, &refs);
+	    }
+
+	  offset += size;
+	}
+
+      int index = dies.size();
+      dies.push_back(die);
+      if (die.abbrev->has_children)
+	parents.push_back(index);
+      else
+	dies[index].end = offset;
+    }
+  while (!parents.empty())
+    {
+      dies[parents.back()].end = unit.end;
+      parents.pop_back();
+    }
+
+  // Look for type definitions at namespace scope.
+  size_t first_candidate = this->candidates_.size();
+  for (size_t i = 0; i < dies.size(); ++i)
+    {
+      const Die& die(dies[i]);
+      if (!is_aggregate_tag(die.abbrev->tag)
+	  || !die.abbrev->has_children
+	  || die.name_offset == 0
+	  || die.is_declaration
+	  || die.parent < 0)
+	continue;
+
+      bool at_namespace_scope = true;
+      for (int parent = die.parent;
+	   dies[parent].parent >= 0;
+	   parent = dies[parent].parent)
+	{
+	  if (dies[parent].abbrev->tag != elfcpp::DW_TAG_namespace
+	      || dies[parent].name_offset == 0)
+	    {
+	      at_namespace_scope = false;
+	      break;
+	    }
+	}
+      if (!at_namespace_scope)
+	continue;
+
+      md5_ctx ctx;
+      md5_init_ctx(&ctx);
+      if (!this->hash_scope(&ctx, dies, i)
+	  || !this->hash_subtree(&ctx, unit, dies, die.offset, die.end, 0))
+	continue;
+      unsigned char checksum[16];
+      md5_finish_ctx(&ctx, checksum);
+
+      Candidate candidate;
+      candidate.unit = unit_index;
+      candidate.offset = die.offset;
+      candidate.end = die.end;
+      candidate.name_offset = die.name_offset;
+      candidate.name_size = die.name_size;
+      candidate.tag = die.abbrev->tag;
+      candidate.name_form = die.name_form;
+      candidate.eligible = true;
+      candidate.key.assign(reinterpret_cast<const char*>(checksum),
+			   sizeof checksum);
+      this->candidates_.push_back(candidate);
+    }
+
+  this->check_references(&refs, first_candidate);
+  return true;
+}
+
+// A definition can only be replaced if nothing outside it refers to
+// its children.  Check REFS against the candidates starting at
+// FIRST_CANDIDATE.
+
+void
+Debug_type_dedup::check_references(std::vector<Reference>* refs,
+				   size_t first_candidate)
+{
+  std::sort(refs->begin(), refs->end());
+  for (size_t i = first_candidate; i < this->candidates_.size(); ++i)
+    {
+      Candidate& candidate(this->candidates_[i]);
+      std::vector<Reference>::const_iterator p =
+	std::upper_bound(refs->begin(), refs->end(),
+			 Reference(candidate.offset, -1ULL));
+      for (; p != refs->end() && p->first < candidate.end; ++p)
+	{
+	  if (p->second < candidate.offset || p->second >= candidate.end)
+	    {
+	      candidate.eligible = false;
+	      break;
+	    }
+	}
+    }
+}
+
+// Add the tags and names of the DIE at INDEX and its enclosing scopes
+// to the checksum.  Return false if one of them has no name, or is not
+// a namespace or type.
+
+bool
+Debug_type_dedup::hash_scope(md5_ctx* ctx, const std::vector<Die>& dies,
+			     int index) const
+{
+  const unsigned char* info = this->contents_[DEBUG_INFO];
+  for (bool first = true;
+       dies[index].parent >= 0;
+       index = dies[index].parent, first = false)
+    {
+      const Die& die(dies[index]);
+      if (die.name_offset == 0)
+	return false;
+      if (!first
+	  && die.abbrev->tag != elfcpp::DW_TAG_namespace
+	  && !is_aggregate_tag(die.abbrev->tag))
+	return false;
+      hash_value(ctx, die.abbrev->tag);
+      hash_value(ctx, die.name_form);
+      md5_process_bytes(info + die.name_offset, die.name_size, ctx);
+    }
+  return true;
+}
+
+// Add the DIEs between OFFSET and END to the checksum.  References
+// within the range are added as relative offsets, and references to
+// other DIEs by following them.  DW_AT_decl_file is omitted, as the
+// file numbers depend on the compilation unit.  Return false if the
+// DIEs can not be compared.
+
+bool
+Debug_type_dedup::hash_subtree(md5_ctx* ctx, const Unit& unit,
+			       const std::vector<Die>& dies, uint64_t offset,
+			       uint64_t end, int depth) const
+{
+  const unsigned char* info = this->contents_[DEBUG_INFO];
+  std::vector<Expr_ref> expr_refs;
+  uint64_t p = offset;
+  while (p < end)
+    {
+      uint64_t code;
+      size_t len = read_leb(info + p, end - p, &code);
+      if (len == 0)
+	return false;
+      p += len;
+      if (code == 0)
+	{
+	  hash_value(ctx, 0);
+	  continue;
+	}
+
+      Unordered_map<uint64_t, Abbrev>::const_iterator a =
+	unit.abbrevs->abbrevs.find(code);
+      gold_assert(a != unit.abbrevs->abbrevs.end());
+      const Abbrev& abbrev(a->second);
+      hash_value(ctx, abbrev.tag * 2 + (abbrev.has_children ? 1 : 0));
+
+      for (size_t i = 0; i < abbrev.attributes.size(); ++i)
+	{
+	  unsigned int attr = abbrev.attributes[i].first;
+	  unsigned int form = abbrev.attributes[i].second;
+	  uint64_t size;
+	  if (!this->attribute_size(unit, form, p, &size))
+	    return false;
+
+	  if (attr == elfcpp::DW_AT_sibling || attr == elfcpp::DW_AT_decl_file)
+	    {
+	      p += size;
+	      continue;
+	    }
+
+	  hash_value(ctx, attr);
+	  if (is_ref_form(form))
+	    {
+	      uint64_t target = 0;
+	      if (form == elfcpp::DW_FORM_ref_udata)
+		{
+		  if (read_leb(info + p, size, &target) == 0)
+		    return false;
+		  target += unit.offset;
+		}
+	      else if (form == elfcpp::DW_FORM_ref_addr)
+		target = this->read_value(info + p, size);
+	      else
+		target = unit.offset + this->read_value(info + p, size);
+
+	      if (target >= offset && target < end)
+		{
+		  hash_value(ctx, 'i');
+		  hash_value(ctx, target - offset);
+		}
+	      else
+		{
+		  hash_value(ctx, 'x');
+		  if (!this->hash_reference(ctx, unit, dies, target, depth + 1))
+		    return false;
+		}
+	    }
+	  else if (this->is_location_list(unit, attr, form)
+		   || form == elfcpp::DW_FORM_sec_offset)
+	    return false;
+	  else
+	    {
+	      if (this->is_expression(unit, attr, form))
+		{
+		  uint64_t data_offset;
+		  uint64_t data_size;
+		  expr_refs.clear();
+		  if (!this->block_contents(unit, form, p, &data_offset,
+					    &data_size)
+		      || !this->read_expression(unit, info + data_offset,
+						data_size, &expr_refs)
+		      || !expr_refs.empty())
+		    return false;
+		}
+	      hash_value(ctx, form);
+	      md5_process_bytes(info + p, size, ctx);
+	    }
+	  p += size;
+	}
+    }
+  return true;
+}
+
+// Add the DIE at TARGET, which is referred to from a type definition,
+// to the checksum.  Named structures, classes, unions and enumerations
+// are identified by their qualified name; other types are added in
+// full.
+
+bool
+Debug_type_dedup::hash_reference(md5_ctx* ctx, const Unit& unit,
+				 const std::vector<Die>& dies, uint64_t target,
+				 int depth) const
+{
+  if (depth > max_reference_depth
+      || target < unit.offset
+      || target >= unit.end)
+    return false;
+
+  std::vector<Die>::const_iterator p =
+    std::upper_bound(dies.begin(), dies.end(), target, Offset_less());
+  if (p == dies.begin())
+    return false;
+  --p;
+  if (p->offset != target)
+    return false;
+
+  unsigned int tag = p->abbrev->tag;
+  if (p->name_offset != 0 && is_aggregate_tag(tag))
+    {
+      hash_value(ctx, 'n');
+      return this->hash_scope(ctx, dies, p - dies.begin());
+    }
+  if (!is_type_tag(tag))
+    return false;
+  hash_value(ctx, 'd');
+  return this->hash_subtree(ctx, unit, dies, p->offset, p->end, depth);
+}
+
+// Decide which type definitions to replace.  We keep the first
+// definition of each type, and replace each later identical
+// definition if nothing outside it refers to its children.  The
+// abbreviations for the declarations are added to the end of the
+// abbreviation tables of their units.  Return false if the tables can
+// not be extended.
+
+bool
+Debug_type_dedup::add_stubs()
+{
+  Unordered_set<std::string> keys;
+  // The declaration abbreviations to add to each table, identified by
+  // tag and name form.
+  typedef std::vector<std::pair<unsigned int, unsigned int> > Stub_abbrevs;
+  std::map<uint64_t, Stub_abbrevs> new_abbrevs;
+
+  for (size_t i = 0; i < this->candidates_.size(); ++i)
+    {
+      const Candidate& candidate(this->candidates_[i]);
+      if (keys.insert(candidate.key).second || !candidate.eligible)
+	continue;
+
+      Unit& unit(this->units_[candidate.unit]);
+      Stub_abbrevs& abbrevs(new_abbrevs[unit.abbrev_offset]);
+      std::pair<unsigned int, unsigned int> abbrev(candidate.tag,
+						   candidate.name_form);
+      Stub_abbrevs::const_iterator p = std::find(abbrevs.begin(),
+						 abbrevs.end(), abbrev);
+      uint64_t code = unit.abbrevs->max_code + 1 + (p - abbrevs.begin());
+      if (p == abbrevs.end())
+	abbrevs.push_back(abbrev);
+
+      Stub stub;
+      stub.offset = candidate.offset;
+      stub.end = candidate.end;
+      stub.name_offset = candidate.name_offset;
+      stub.name_size = candidate.name_size;
+      stub.tag = candidate.tag;
+      stub.name_form = candidate.name_form;
+      stub.code = code;
+      // The declaration has DW_AT_name and DW_AT_declaration.  We use
+      // DW_FORM_flag, which unlike DW_FORM_flag_present is valid in
+      // all DWARF versions.
+      stub.size = get_length_as_unsigned_LEB_128(code) + stub.name_size + 1;
+      stub.removed_before = 0;
+      if (stub.size < stub.end - stub.offset)
+	unit.stubs.push_back(stub);
+    }
+
+  if (new_abbrevs.empty())
+    return true;
+
+  // Add the declaration abbreviations to the end of each table, and
+  // record how far that moves the tables which follow.
+  const unsigned char* abbrev = this->contents_[DEBUG_ABBREV];
+  uint64_t copied = 0;
+  for (std::map<uint64_t, Stub_abbrevs>::const_iterator p =
+	 new_abbrevs.begin();
+       p != new_abbrevs.end();
+       ++p)
+    {
+      const Abbrev_table* table = &this->abbrev_tables_.find(p->first)->second;
+      // Two tables could share their ends, but compilers do not do
+      // that.
+      if (copied != 0 && table->end <= copied)
+	return false;
+      this->abbrev_.insert(this->abbrev_.end(), abbrev + copied,
+			   abbrev + table->end);
+      copied = table->end;
+      for (size_t i = 0; i < p->second.size(); ++i)
+	{
+	  write_unsigned_LEB_128(&this->abbrev_, table->max_code + 1 + i);
+	  write_unsigned_LEB_128(&this->abbrev_, p->second[i].first);
+	  this->abbrev_.push_back(elfcpp::DW_CHILDREN_no);
+	  write_unsigned_LEB_128(&this->abbrev_, elfcpp::DW_AT_name);
+	  write_unsigned_LEB_128(&this->abbrev_, p->second[i].second);
+	  write_unsigned_LEB_128(&this->abbrev_, elfcpp::DW_AT_declaration);
+	  write_unsigned_LEB_128(&this->abbrev_, elfcpp::DW_FORM_flag);
+	  this->abbrev_.push_back(0);
+	  this->abbrev_.push_back(0);
+	}
+      this->abbrev_shifts_.push_back(std::make_pair(copied,
+						    (this->abbrev_.size()
+						     - copied)));
+    }
+  this->abbrev_.insert(this->abbrev_.end(), abbrev + copied,
+		       abbrev + this->sizes_[DEBUG_ABBREV]);
+
+  // Lay out the units.
+  uint64_t new_offset = 0;
+  for (size_t i = 0; i < this->units_.size(); ++i)
+    {
+      Unit& unit(this->units_[i]);
+      uint64_t removed = 0;
+      for (size_t j = 0; j < unit.stubs.size(); ++j)
+	{
+	  Stub& stub(unit.stubs[j]);
+	  stub.removed_before = removed;
+	  removed += stub.end - stub.offset - stub.size;
+	}
+      unit.new_offset = new_offset;
+      unit.new_abbrev_offset = this->map_abbrev_offset(unit.abbrev_offset);
+      new_offset += unit.end - unit.offset - removed;
+      this->stub_count_ += unit.stubs.size();
+      this->removed_bytes_ += removed;
+    }
+  return true;
+}
+
+// Return the new offset in .debug_info of the DIE at OFFSET.  An
+// offset within a replaced definition is mapped to its declaration.
+
+uint64_t
+Debug_type_dedup::map_offset(uint64_t offset) const
+{
+  std::vector<Unit>::const_iterator u =
+    std::upper_bound(this->units_.begin(), this->units_.end(), offset,
+		     Offset_less());
+  if (u == this->units_.begin())
+    return offset;
+  --u;
+
+  uint64_t removed = 0;
+  std::vector<Stub>::const_iterator s =
+    std::upper_bound(u->stubs.begin(), u->stubs.end(), offset,
+		     Offset_less());
+  if (s != u->stubs.begin())
+    {
+      --s;
+      if (offset < s->end)
+	return u->new_offset + (s->offset - u->offset) - s->removed_before;
+      removed = s->removed_before + (s->end - s->offset - s->size);
+    }
+  return u->new_offset + (offset - u->offset) - removed;
+}
+
+// Return the new offset in .debug_abbrev of the abbreviation table at
+// OFFSET.
+
+uint64_t
+Debug_type_dedup::map_abbrev_offset(uint64_t offset) const
+{
+  std::vector<std::pair<uint64_t, uint64_t> >::const_iterator p =
+    std::lower_bound(this->abbrev_shifts_.begin(), this->abbrev_shifts_.end(),
+		     std::make_pair(offset, static_cast<uint64_t>(0)));
+  if (p == this->abbrev_shifts_.begin())
+    return offset;
+  --p;
+  return offset + p->second;
+}
+
+// Append the new contents of UNIT to info_.
+
+void
+Debug_type_dedup::write_unit(const Unit& unit)
+{
+  const unsigned char* info = this->contents_[DEBUG_INFO];
+  size_t start = this->info_.size();
+  this->info_.insert(this->info_.end(), info + unit.offset,
+		     info + unit.offset + unit_header_size);
+  uint64_t removed = 0;
+  if (!unit.stubs.empty())
+    {
+      const Stub& last(unit.stubs.back());
+      removed = last.removed_before + (last.end - last.offset - last.size);
+    }
+  this->write_value(&this->info_[start], 4,
+		    unit.end - unit.offset - 4 - removed);
+  this->write_value(&this->info_[start + 6], 4, unit.new_abbrev_offset);
+
+  size_t next_stub = 0;
+  uint64_t offset = unit.offset + unit_header_size;
+  while (offset < unit.end)
+    {
+      if (next_stub < unit.stubs.size()
+	  && unit.stubs[next_stub].offset == offset)
+	{
+	  const Stub& stub(unit.stubs[next_stub]);
+	  write_unsigned_LEB_128(&this->info_, stub.code);
+	  this->info_.insert(this->info_.end(), info + stub.name_offset,
+			     info + stub.name_offset + stub.name_size);
+	  this->info_.push_back(1);
+	  offset = stub.end;
+	  ++next_stub;
+	  continue;
+	}
+
+      uint64_t code;
+      size_t len = read_leb(info + offset, unit.end - offset, &code);
+      gold_assert(len != 0);
+      this->info_.insert(this->info_.end(), info + offset,
+			 info + offset + len);
+      offset += len;
+      if (code == 0)
+	continue;
+
+      const Abbrev& abbrev(unit.abbrevs->abbrevs.find(code)->second);
+      for (size_t i = 0; i < abbrev.attributes.size(); ++i)
+	{
+	  unsigned int attr = abbrev.attributes[i].first;
+	  unsigned int form = abbrev.attributes[i].second;
+	  uint64_t size;
+	  bool ok = this->attribute_size(unit, form, offset, &size);
+	  gold_assert(ok);
+	  size_t out = this->info_.size();
+	  this->info_.insert(this->info_.end(), info + offset,
+			     info + offset + size);
+
+	  if (form == elfcpp::DW_FORM_ref_addr)
+	    this->write_value(&this->info_[out], size,
+			      this->map_offset(this->read_value(info + offset,
+								size)));
+	  else if (form == elfcpp::DW_FORM_ref_udata)
+	    {
+	      uint64_t value = 0;
+	      size_t value_len = read_leb(info + offset, size, &value);
+	      gold_assert(value_len != 0);
+	      write_padded_leb(&this->info_[out], size,
+			       (this->map_offset(unit.offset + value)
+				- unit.new_offset));
+	    }
+	  else if (is_ref_form(form))
+	    {
+	      uint64_t value = this->read_value(info + offset, size);
+	      this->write_value(&this->info_[out], size,
+				(this->map_offset(unit.offset + value)
+				 - unit.new_offset));
+	    }
+	  else if (this->is_expression(unit, attr, form))
+	    {
+	      uint64_t data_offset;
+	      uint64_t data_size;
+	      this->block_contents(unit, form, offset, &data_offset,
+				   &data_size);
+	      this->patch_expression(unit,
+				     &this->info_[out + data_offset - offset],
+				     data_size);
+	    }
+	  else if (this->is_location_list(unit, attr, form))
+	    this->patch_location_list(unit,
+				      this->read_value(info + offset, size));
+
+	  offset += size;
+	}
+    }
+  gold_assert(next_stub == unit.stubs.size());
+}
+
+// Rewrite the DIE references in the DWARF expression EXPR of SIZE
+// bytes, which appears in UNIT.
+
+void
+Debug_type_dedup::patch_expression(const Unit& unit, unsigned char* expr,
+				   size_t size) const
+{
+  std::vector<Expr_ref> refs;
+  bool ok = this->read_expression(unit, expr, size, &refs);
+  gold_assert(ok);
+  for (size_t i = 0; i < refs.size(); ++i)
+    {
+      const Expr_ref& ref(refs[i]);
+      uint64_t value;
+      if (ref.is_section_offset)
+	value = this->map_offset(ref.value);
+      else
+	value = this->map_offset(unit.offset + ref.value) - unit.new_offset;
+      if (ref.is_leb)
+	write_padded_leb(expr + ref.offset, ref.size, value);
+      else
+	this->write_value(expr + ref.offset, ref.size, value);
+    }
+}
+
+// Rewrite the DIE references in the location list at OFFSET in
+// .debug_loc, which is used by UNIT.
+
+void
+Debug_type_dedup::patch_location_list(const Unit& unit, uint64_t offset)
+{
+  if (!this->patched_location_lists_.insert(offset).second)
+    return;
+
+  unsigned char* loc = this->contents_[DEBUG_LOC];
+  std::vector<Expr_ref> refs;
+  bool ok = this->read_location_list(unit, offset, &refs);
+  gold_assert(ok);
+  for (size_t i = 0; i < refs.size(); ++i)
+    {
+      const Expr_ref& ref(refs[i]);
+      uint64_t value;
+      if (ref.is_section_offset)
+	value = this->map_offset(ref.value);
+      else
+	value = this->map_offset(unit.offset + ref.value) - unit.new_offset;
+      if (ref.is_leb)
+	write_padded_leb(loc + ref.offset, ref.size, value);
+      else
+	this->write_value(loc + ref.offset, ref.size, value);
+    }
+}
+
+// Rewrite the .debug_abbrev offsets in the type unit headers in
+// .debug_types.
+
+void
+Debug_type_dedup::patch_types()
+{
+  unsigned char* types = this->contents_[DEBUG_TYPES];
+  uint64_t size = this->sizes_[DEBUG_TYPES];
+  uint64_t offset = 0;
+  while (size - offset >= 10)
+    {
+      uint64_t length = this->read_value(types + offset, 4);
+      if (length >= 0xfffffff0 || length < 6 || size - offset - 4 < length)
+	break;
+      uint64_t abbrev_offset = this->read_value(types + offset + 6, 4);
+      this->write_value(types + offset + 6, 4,
+			this->map_abbrev_offset(abbrev_offset));
+      offset += 4 + length;
+    }
+}
+
+// Rewrite the .debug_info offsets in .debug_aranges.
+
+void
+Debug_type_dedup::patch_aranges()
+{
+  unsigned char* aranges = this->contents_[DEBUG_ARANGES];
+  uint64_t size = this->sizes_[DEBUG_ARANGES];
+  uint64_t offset = 0;
+  while (size - offset >= 10)
+    {
+      uint64_t length = this->read_value(aranges + offset, 4);
+      if (length >= 0xfffffff0 || length < 6 || size - offset - 4 < length)
+	break;
+      uint64_t info_offset = this->read_value(aranges + offset + 6, 4);
+      this->write_value(aranges + offset + 6, 4,
+			this->map_offset(info_offset));
+      offset += 4 + length;
+    }
+}
+
+// Rewrite the .debug_info offsets in .debug_pubnames, .debug_pubtypes,
+// or their GNU variants, which have an extra flag byte in each entry.
+
+void
+Debug_type_dedup::patch_pubnames(Section_kind kind)
+{
+  unsigned char* pubnames = this->contents_[kind];
+  uint64_t size = this->sizes_[kind];
+  bool is_gnu = kind == DEBUG_GNU_PUBNAMES || kind == DEBUG_GNU_PUBTYPES;
+  uint64_t offset = 0;
+  while (size - offset >= 14)
+    {
+      uint64_t length = this->read_value(pubnames + offset, 4);
+      if (length >= 0xfffffff0 || length < 10 || size - offset - 4 < length)
+	break;
+      uint64_t set_end = offset + 4 + length;
+      uint64_t info_offset = this->read_value(pubnames + offset + 6, 4);
+      uint64_t info_size = this->read_value(pubnames + offset + 10, 4);
+      uint64_t new_info_offset = this->map_offset(info_offset);
+      this->write_value(pubnames + offset + 6, 4, new_info_offset);
+      this->write_value(pubnames + offset + 10, 4,
+			(this->map_offset(info_offset + info_size)
+			 - new_info_offset));
+
+      uint64_t p = offset + 14;
+      while (set_end - p >= 4)
+	{
+	  uint64_t die_offset = this->read_value(pubnames + p, 4);
+	  if (die_offset == 0)
+	    break;
+	  this->write_value(pubnames + p, 4,
+			    (this->map_offset(info_offset + die_offset)
+			     - new_info_offset));
+	  p += is_gnu ? 5 : 4;
+	  if (p >= set_end)
+	    break;
+	  const void* nul = memchr(pubnames + p, 0, set_end - p);
+	  if (nul == NULL)
+	    break;
+	  p = static_cast<const unsigned char*>(nul) - pubnames + 1;
+	}
+      offset = set_end;
+    }
+}
+
+// Find the duplicate type definitions and compute the new section
+// contents.
+
+void
+Debug_type_dedup::finalize()
+{
+  if (this->finalized_)
+    return;
+  this->finalized_ = true;
+
+  this->big_endian_ = parameters->target().is_big_endian();
+  for (int i = 0; i < DEBUG_SECTION_COUNT; ++i)
+    {
+      if (this->sections_[i] != NULL)
+	{
+	  this->contents_[i] = this->sections_[i]->contents();
+	  this->sizes_[i] = this->sections_[i]->contents_size();
+	}
+    }
+
+  if (this->sections_[DEBUG_INFO] == NULL
+      || this->sections_[DEBUG_ABBREV] == NULL)
+    return;
+  if (this->sections_[DEBUG_NAMES] != NULL)
+    {
+      this->failed(_(".debug_names is not supported"));
+      return;
+    }
+
+  // Read the compilation unit headers.
+  const unsigned char* info = this->contents_[DEBUG_INFO];
+  uint64_t size = this->sizes_[DEBUG_INFO];
+  uint64_t offset = 0;
+  while (offset < size)
+    {
+      if (size - offset < unit_header_size)
+	{
+	  this->failed(_("truncated compilation unit in .debug_info"));
+	  return;
+	}
+      uint64_t length = this->read_value(info + offset, 4);
+      if (length >= 0xfffffff0)
+	{
+	  this->failed(_("64-bit DWARF is not supported"));
+	  return;
+	}
+      if (length < unit_header_size - 4 || length > size - offset - 4)
+	{
+	  this->failed(_("truncated compilation unit in .debug_info"));
+	  return;
+	}
+
+      Unit unit;
+      unit.offset = offset;
+      unit.end = offset + 4 + length;
+      unit.version = this->read_value(info + offset + 4, 2);
+      unit.abbrev_offset = this->read_value(info + offset + 6, 4);
+      unit.address_size = info[offset + 10];
+      if (unit.version < 2 || unit.version > 4)
+	{
+	  this->failed(_("only DWARF versions 2 to 4 are supported"));
+	  return;
+	}
+      if (unit.address_size != 4 && unit.address_size != 8)
+	{
+	  this->failed(_("unsupported address size in .debug_info"));
+	  return;
+	}
+      unit.abbrevs = this->read_abbrev_table(unit.abbrev_offset);
+      if (unit.abbrevs == NULL)
+	{
+	  this->failed(_("invalid abbreviation table in .debug_abbrev"));
+	  return;
+	}
+      unit.new_offset = offset;
+      unit.new_abbrev_offset = unit.abbrev_offset;
+      this->units_.push_back(unit);
+      offset = unit.end;
+    }
+
+  for (size_t i = 0; i < this->units_.size(); ++i)
+    {
+      if (!this->scan_unit(i))
+	{
+	  this->failed(_("unsupported DWARF in .debug_info"));
+	  return;
+	}
+    }
+  this->check_references(&this->global_refs_, 0);
+
+  if (!this->add_stubs())
+    {
+      this->failed(_("overlapping abbreviation tables in .debug_abbrev"));
+      return;
+    }
+  if (this->stub_count_ == 0)
+    return;
+
+  this->unchanged_ = false;
+  this->info_.reserve(size - this->removed_bytes_);
+  for (size_t i = 0; i < this->units_.size(); ++i)
+    this->write_unit(this->units_[i]);
+  gold_assert(this->info_.size() == size - this->removed_bytes_);
+
+  if (this->contents_[DEBUG_TYPES] != NULL)
+    this->patch_types();
+  if (this->contents_[DEBUG_ARANGES] != NULL)
+    this->patch_aranges();
+  static const Section_kind pubnames[] =
+  {
+    DEBUG_PUBNAMES, DEBUG_PUBTYPES, DEBUG_GNU_PUBNAMES, DEBUG_GNU_PUBTYPES
+  };
+  for (size_t i = 0; i < sizeof(pubnames) / sizeof(pubnames[0]); ++i)
+    if (this->contents_[pubnames[i]] != NULL)
+      this->patch_pubnames(pubnames[i]);
+
+  // We no longer need the analysis.
+  std::vector<Candidate>().swap(this->candidates_);
+  std::vector<Reference>().swap(this->global_refs_);
+}
+
+// Return the final size of section KIND.
+
+uint64_t
+Debug_type_dedup::section_size(Section_kind kind) const
+{
+  gold_assert(this->finalized_);
+  if (this->unchanged_)
+    return this->sizes_[kind];
+  if (kind == DEBUG_INFO)
+    return this->info_.size();
+  if (kind == DEBUG_ABBREV)
+    return this->abbrev_.size();
+  return this->sizes_[kind];
+}
+
+// Write the final contents of section KIND to VIEW.
+
+void
+Debug_type_dedup::write_section(Section_kind kind, unsigned char* view) const
+{
+  if (!this->unchanged_ && kind == DEBUG_INFO)
+    memcpy(view, &this->info_.front(), this->info_.size());
+  else if (!this->unchanged_ && kind == DEBUG_ABBREV)
+    memcpy(view, &this->abbrev_.front(), this->abbrev_.size());
+  else
+    memcpy(view, this->contents_[kind], this->sizes_[kind]);
+}
+
+// Print statistics to stderr.
+
+void
+Debug_type_dedup::print_stats() const
+{
+  fprintf(stderr, _("%s: debug type definitions replaced: %zu\n"),
+	  program_name, this->stub_count_);
+  fprintf(stderr, _("%s: debug type bytes removed: %llu\n"),
+	  program_name, static_cast<unsigned long long>(this->removed_bytes_));
+}
+
+// Output_dedup_debug_section methods.
+
+// Set the final data size, once all relocations have been applied.
+
+void
+Output_dedup_debug_section::set_final_data_size()
+{
+  this->dedup_->finalize();
+  this->set_data_size(this->dedup_->section_size(this->kind_));
+}
+
+// Write out the rewritten section.
+
+void
+Output_dedup_debug_section::do_write(Output_file* of)
+{
+  off_t offset = this->offset();
+  off_t data_size = this->data_size();
+  unsigned char* view = of->get_output_view(offset, data_size);
+  this->dedup_->write_section(this->kind_, view);
+  of->write_output_view(offset, data_size, view);
+}
+
+} // End namespace gold.
@@ -0,0 +1,374 @@
+// dedup_debug_output.h -- remove duplicate debug type definitions  -*- C++ -*-
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// Reduce the size of the debug sections by removing duplicate type
+// definitions.  Every compilation unit which uses a C++ class carries
+// its own copy of the definition in .debug_info.  When the definition
+// of a namespace scope structure, class, union or enumeration type is
+// identical to one in an earlier compilation unit, we replace it with
+// a declaration, which debuggers resolve to the remaining definition
+// by name.  Removing DIEs moves the DIEs which follow them, so the
+// references to .debug_info offsets in the other debug sections are
+// rewritten as well.  Only 32-bit DWARF versions 2 to 4 are handled;
+// if any compilation unit uses another format, such as DWARF 5, we
+// warn once and copy the debug sections unchanged.
+
+#ifndef GOLD_DEDUP_DEBUG_OUTPUT_H
+#define GOLD_DEDUP_DEBUG_OUTPUT_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "output.h"
+
+struct md5_ctx;
+
+namespace gold
+{
+
+class Output_dedup_debug_section;
+
+// This class finds the duplicate type definitions and computes the
+// new contents of the debug sections.  There is one instance per
+// link, shared by all the Output_dedup_debug_section sections.
+
+class Debug_type_dedup
+{
+ public:
+  // The debug sections which we rewrite.
+  enum Section_kind
+  {
+    DEBUG_INFO,
+    DEBUG_ABBREV,
+    DEBUG_TYPES,
+    DEBUG_ARANGES,
+    DEBUG_PUBNAMES,
+    DEBUG_PUBTYPES,
+    DEBUG_GNU_PUBNAMES,
+    DEBUG_GNU_PUBTYPES,
+    DEBUG_LOC,
+    // .debug_names refers to .debug_info offsets, but we do not know
+    // how to rewrite it.  If it is present we leave everything alone.
+    DEBUG_NAMES,
+    DEBUG_SECTION_COUNT
+  };
+
+  Debug_type_dedup();
+
+  // Return the kind of the debug section NAME, or DEBUG_SECTION_COUNT
+  // if it is not a section we handle.
+  static Section_kind
+  section_kind(const char* name);
+
+  // Record the output section for KIND.
+  void
+  set_section(Section_kind kind, Output_dedup_debug_section* os)
+  { this->sections_[kind] = os; }
+
+  // Find the duplicate type definitions and compute the new section
+  // contents.  This is called from set_final_data_size of each
+  // section, after all relocations have been applied, and only does
+  // any work the first time.
+  void
+  finalize();
+
+  // Return the final size of section KIND.
+  uint64_t
+  section_size(Section_kind kind) const;
+
+  // Write the final contents of section KIND to VIEW.
+  void
+  write_section(Section_kind kind, unsigned char* view) const;
+
+  // Print statistics to stderr.  This is used for --stats.
+  void
+  print_stats() const;
+
+ private:
+  // An abbreviation.
+  struct Abbrev
+  {
+    unsigned int tag;
+    bool has_children;
+    // The attributes and their forms.
+    std::vector<std::pair<unsigned int, unsigned int> > attributes;
+  };
+
+  // An abbreviation table in .debug_abbrev.
+  struct Abbrev_table
+  {
+    Unordered_map<uint64_t, Abbrev> abbrevs;
+    // The largest abbreviation code in the table.
+    uint64_t max_code;
+    // The offset of the terminating zero code.
+    uint64_t end;
+  };
+
+  // A declaration replacing a duplicate type definition.
+  struct Stub
+  {
+    // The offset of the definition in .debug_info, and the offset
+    // following its last child.
+    uint64_t offset;
+    uint64_t end;
+    // The offset and size of the DW_AT_name value of the definition.
+    uint64_t name_offset;
+    uint64_t name_size;
+    unsigned int tag;
+    unsigned int name_form;
+    // The abbreviation code of the declaration.
+    uint64_t code;
+    // The size of the declaration.
+    uint64_t size;
+    // The number of bytes removed from the unit by earlier stubs.
+    uint64_t removed_before;
+  };
+
+  // A compilation unit in .debug_info.
+  struct Unit
+  {
+    uint64_t offset;
+    uint64_t end;
+    unsigned int version;
+    unsigned int address_size;
+    uint64_t abbrev_offset;
+    const Abbrev_table* abbrevs;
+    // The stubs to emit, in order of offset.
+    std::vector<Stub> stubs;
+    uint64_t new_offset;
+    uint64_t new_abbrev_offset;
+  };
+
+  // A DIE in the compilation unit being scanned.
+  struct Die
+  {
+    uint64_t offset;
+    // The offset following the DIE and its children.
+    uint64_t end;
+    // The index of the parent DIE, or -1.
+    int parent;
+    const Abbrev* abbrev;
+    // The offset of the DW_AT_name value, or 0 if there is none.
+    uint64_t name_offset;
+    uint64_t name_size;
+    unsigned int name_form;
+    bool is_declaration;
+  };
+
+  // A type definition which we may be able to replace.
+  struct Candidate
+  {
+    size_t unit;
+    uint64_t offset;
+    uint64_t end;
+    uint64_t name_offset;
+    uint64_t name_size;
+    unsigned int tag;
+    unsigned int name_form;
+    // Whether nothing outside the definition refers to its children.
+    bool eligible;
+    // The MD5 checksum of the definition.
+    std::string key;
+  };
+
+  // A reference from one .debug_info offset to another.
+  typedef std::pair<uint64_t, uint64_t> Reference;
+
+  // A DIE reference found in a DWARF expression.
+  struct Expr_ref
+  {
+    // The offset of the operand in the expression.
+    size_t offset;
+    // The size of the operand.
+    unsigned int size;
+    // Whether the operand is a ULEB128.
+    bool is_leb;
+    // Whether the operand is a .debug_info offset rather than an
+    // offset from the start of the compilation unit.
+    bool is_section_offset;
+    uint64_t value;
+  };
+
+  void
+  failed(const char* reason);
+
+  uint64_t
+  read_value(const unsigned char* p, unsigned int size) const;
+
+  void
+  write_value(unsigned char* p, unsigned int size, uint64_t value) const;
+
+  const Abbrev_table*
+  read_abbrev_table(uint64_t offset);
+
+  bool
+  attribute_size(const Unit&, unsigned int form, uint64_t offset,
+		 uint64_t* size) const;
+
+  static bool
+  is_ref_form(unsigned int form);
+
+  static bool
+  is_location_attribute(unsigned int attr);
+
+  bool
+  is_expression(const Unit&, unsigned int attr, unsigned int form) const;
+
+  bool
+  is_location_list(const Unit&, unsigned int attr, unsigned int form) const;
+
+  bool
+  block_contents(const Unit&, unsigned int form, uint64_t offset,
+		 uint64_t* data_offset, uint64_t* data_size) const;
+
+  bool
+  read_expression(const Unit&, const unsigned char* expr, size_t size,
+		  std::vector<Expr_ref>* refs) const;
+
+  bool
+  read_location_list(const Unit&, uint64_t offset,
+		     std::vector<Expr_ref>* refs) const;
+
+  void
+  add_reference(const Unit&, const Expr_ref&, uint64_t source,
+		std::vector<Reference>* refs);
+
+  bool
+  scan_unit(size_t unit_index);
+
+  void
+  check_references(std::vector<Reference>* refs, size_t first_candidate);
+
+  bool
+  hash_subtree(md5_ctx*, const Unit&, const std::vector<Die>&,
+	       uint64_t offset, uint64_t end, int depth) const;
+
+  bool
+  hash_reference(md5_ctx*, const Unit&, const std::vector<Die>&,
+		 uint64_t target, int depth) const;
+
+  bool
+  hash_scope(md5_ctx*, const std::vector<Die>&, int index) const;
+
+  bool
+  add_stubs();
+
+  uint64_t
+  map_offset(uint64_t offset) const;
+
+  uint64_t
+  map_abbrev_offset(uint64_t offset) const;
+
+  void
+  write_unit(const Unit&);
+
+  void
+  patch_expression(const Unit&, unsigned char* expr, size_t size) const;
+
+  void
+  patch_location_list(const Unit&, uint64_t offset);
+
+  void
+  patch_pubnames(Section_kind kind);
+
+  void
+  patch_types();
+
+  void
+  patch_aranges();
+
+  // The output sections, indexed by kind.
+  Output_dedup_debug_section* sections_[DEBUG_SECTION_COUNT];
+  // The relocated contents of the sections and their sizes.
+  unsigned char* contents_[DEBUG_SECTION_COUNT];
+  uint64_t sizes_[DEBUG_SECTION_COUNT];
+  // Whether the target is big-endian.
+  bool big_endian_;
+  // Whether finalize has run.
+  bool finalized_;
+  // Whether we are copying the sections unchanged.
+  bool unchanged_;
+  // The abbreviation tables, indexed by offset.
+  Unordered_map<uint64_t, Abbrev_table> abbrev_tables_;
+  // The compilation units.
+  std::vector<Unit> units_;
+  // The type definitions we found.
+  std::vector<Candidate> candidates_;
+  // References which cross compilation units.
+  std::vector<Reference> global_refs_;
+  // Location lists we have already rewritten.
+  Unordered_set<uint64_t> patched_location_lists_;
+  // The new contents of .debug_info.
+  std::vector<unsigned char> info_;
+  // The new contents of .debug_abbrev.
+  std::vector<unsigned char> abbrev_;
+  // The offsets in .debug_abbrev where we added abbreviations, with
+  // the total number of bytes added up to that point.
+  std::vector<std::pair<uint64_t, uint64_t> > abbrev_shifts_;
+  // The number of definitions replaced by declarations.
+  size_t stub_count_;
+  // The number of bytes removed from .debug_info.
+  uint64_t removed_bytes_;
+};
+
+// An output section which is rewritten by Debug_type_dedup.
+
+class Output_dedup_debug_section : public Output_section
+{
+ public:
+  Output_dedup_debug_section(const char* name, elfcpp::Elf_Word type,
+			     elfcpp::Elf_Xword flags, Debug_type_dedup* dedup,
+			     Debug_type_dedup::Section_kind kind)
+    : Output_section(name, type, flags), dedup_(dedup), kind_(kind)
+  {
+    this->set_requires_postprocessing();
+    dedup->set_section(kind, this);
+  }
+
+  // Return the relocated input data.
+  unsigned char*
+  contents() const
+  { return this->postprocessing_buffer(); }
+
+  // Return the size of the relocated input data.  This is only valid
+  // until the final data size is set.
+  uint64_t
+  contents_size() const
+  { return this->postprocessing_buffer_size(); }
+
+ protected:
+  // Set the final data size.
+  void
+  set_final_data_size();
+
+  // Write out the rewritten section.
+  void
+  do_write(Output_file*);
+
+ private:
+  Debug_type_dedup* dedup_;
+  Debug_type_dedup::Section_kind kind_;
+};
+
+} // End namespace gold.
+
+#endif // !defined(GOLD_DEDUP_DEBUG_OUTPUT_H)
@@ -230,6 +230,13 @@ queue_initial_tasks(const General_options& options,
   Task_token* this_blocker = NULL;
   if (ibase == NULL)
     {
+      // Start reading the input files into the page cache.  These
+      // tasks are queued first so that they get ahead of the
+      // Read_symbols tasks.
+      if (options.readahead_inputs() > 0)
+	Readahead_inputs::queue_tasks(workqueue, &search_path, cmdline,
+				      options.readahead_inputs());
+
       // Normal link.  Queue a Read_symbols task for each input file
       // on the command line.
       for (Command_line::const_iterator p = cmdline.begin();
@@ -1909,13 +1909,12 @@ class Global_symbol_visitor_got_plt
   operator()(const Sized_symbol<size>* sym)
   {
     typedef Global_got_offset_visitor<size, big_endian> Got_visitor;
-    const Got_offset_list* got_offsets = sym->got_offset_list();
-    if (got_offsets != NULL)
+    if (sym->has_got_offsets())
       {
 	this->info_.sym_index = sym->symtab_index();
 	this->info_.input_index = 0;
 	Got_visitor v(this->info_);
-	got_offsets->for_all_got_offsets(&v);
+	sym->for_all_got_offsets(&v);
       }
     if (sym->has_plt_offset())
       {
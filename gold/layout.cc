@@ -42,6 +42,7 @@
 #include "parameters.h"
 #include "options.h"
 #include "mapfile.h"
+#include "size_report.h"
 #include "script.h"
 #include "script-sections.h"
 #include "output.h"
@@ -51,6 +52,7 @@
 #include "gdb-index.h"
 #include "compressed_output.h"
 #include "reduced_debug_output.h"
+#include "dedup_debug_output.h"
 #include "object.h"
 #include "reloc.h"
 #include "descriptors.h"
@@ -386,6 +388,13 @@ Layout_task_runner::run(Workqueue* workqueue, const Task* task)
       layout->print_to_mapfile(this->mapfile_);
     }
 
+  if (this->options_.user_set_size_report())
+    {
+      Size_report size_report;
+      if (size_report.open(this->options_.size_report()))
+	size_report.print(task, this->input_objects_, this->symtab_, layout);
+    }
+
   Output_file* of;
   if (layout->incremental_base() == NULL)
     {
@@ -451,6 +460,7 @@ Layout::Layout(int number_of_input_files, Script_options* script_options)
     build_id_note_(NULL),
     debug_abbrev_(NULL),
     debug_info_(NULL),
+    debug_type_dedup_(NULL),
     group_signatures_(),
     output_file_size_(-1),
     have_added_input_section_(false),
@@ -1716,6 +1726,17 @@ Layout::make_output_section(const char* name, elfcpp::Elf_Word type,
       if (this->debug_abbrev_)
 	this->debug_info_->set_abbreviations(this->debug_abbrev_);
     }
+  else if ((flags & elfcpp::SHF_ALLOC) == 0
+	   && parameters->options().dedup_debug_types()
+	   && (Debug_type_dedup::section_kind(name)
+	       != Debug_type_dedup::DEBUG_SECTION_COUNT))
+    {
+      if (this->debug_type_dedup_ == NULL)
+	this->debug_type_dedup_ = new Debug_type_dedup();
+      os = new Output_dedup_debug_section(name, type, flags,
+					  this->debug_type_dedup_,
+					  Debug_type_dedup::section_kind(name));
+    }
   else
     {
       // Sometimes .init_array*, .preinit_array* and .fini_array* do
@@ -5686,6 +5707,9 @@ Layout::print_stats() const
        p != this->section_list_.end();
        ++p)
     (*p)->print_merge_stats();
+
+  if (this->debug_type_dedup_ != NULL)
+    this->debug_type_dedup_->print_stats();
 }
 
 // Write_sections_task methods.
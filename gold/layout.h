@@ -57,6 +57,7 @@ class Output_data_dynamic;
 class Output_symtab_xindex;
 class Output_reduced_debug_abbrev_section;
 class Output_reduced_debug_info_section;
+class Debug_type_dedup;
 class Eh_frame;
 class Gdb_index;
 class Target;
@@ -1415,6 +1416,9 @@ class Layout
   Output_reduced_debug_abbrev_section* debug_abbrev_;
   // The output section containing the dwarf debug info tree
   Output_reduced_debug_info_section* debug_info_;
+  // The state shared by the debug sections rewritten by
+  // --dedup-debug-types.
+  Debug_type_dedup* debug_type_dedup_;
   // A list of group sections and their signatures.
   Group_signatures group_signatures_;
   // The size of the output file.
@@ -290,6 +290,25 @@ main(int argc, char** argv)
               elapsed.sys / 1000, (elapsed.sys % 1000) * 1000,
               elapsed.wall / 1000, (elapsed.wall % 1000) * 1000);
 
+#ifdef HAVE_GETRUSAGE
+      elapsed = timer.get_pass_time(0);
+      fprintf(stderr,
+	      _("%s: initial tasks page faults: (minor: %ld major: %ld)\n"),
+	      program_name, elapsed.minor_faults, elapsed.major_faults);
+      elapsed = timer.get_pass_time(1);
+      fprintf(stderr,
+	      _("%s: middle tasks page faults: (minor: %ld major: %ld)\n"),
+	      program_name, elapsed.minor_faults, elapsed.major_faults);
+      elapsed = timer.get_pass_time(2);
+      fprintf(stderr,
+	      _("%s: final tasks page faults: (minor: %ld major: %ld)\n"),
+	      program_name, elapsed.minor_faults, elapsed.major_faults);
+      elapsed = timer.get_elapsed_time();
+      fprintf(stderr,
+	      _("%s: total page faults: (minor: %ld major: %ld)\n"),
+	      program_name, elapsed.minor_faults, elapsed.major_faults);
+#endif
+
 #ifdef HAVE_MALLINFO
       struct mallinfo m = mallinfo();
       fprintf(stderr, _("%s: total space allocated by malloc: %d bytes\n"),
@@ -216,6 +216,12 @@ class Output_merge_base : public Output_section_data
     gold_assert(this->first_relobj_ != NULL);
     return this->first_shndx_;
   }
+
+  // Return the number of bytes of input data which were merged into
+  // this section.
+  uint64_t
+  input_size() const
+  { return this->do_input_size(); }
  
   // Set of merged input sections.
   typedef Unordered_set<Section_id, Section_id_hash> Input_sections;
@@ -243,6 +249,10 @@ class Output_merge_base : public Output_section_data
 		   section_offset_type offset,
 		   section_offset_type* poutput) const;
 
+  // Return the number of input bytes.  Implemented by the child class.
+  virtual uint64_t
+  do_input_size() const = 0;
+
   // This may be overridden by the child class.
   virtual bool
   do_is_string()
@@ -309,6 +319,11 @@ class Output_merge_data : public Output_merge_base
   void
   do_print_merge_stats(const char* section_name);
 
+  // Return the number of input bytes.
+  uint64_t
+  do_input_size() const
+  { return this->input_count_ * this->entsize(); }
+
   // Set keeps-input-sections flag.
   void
   do_set_keeps_input_sections()
@@ -438,6 +453,11 @@ class Output_merge_string : public Output_merge_base
   void
   do_print_merge_stats(const char* section_name);
 
+  // Return the number of input bytes.
+  uint64_t
+  do_input_size() const
+  { return this->input_size_; }
+
   // Writes the stringpool to a buffer.
   void
   stringpool_to_buffer(unsigned char* buffer, section_size_type buffer_size)
@@ -1360,6 +1360,12 @@ General_options::finalize()
 	  gold_warning(_("ignoring --icf for an incremental link"));
 	  this->set_icf_status(ICF_NONE);
 	}
+      if (this->dedup_debug_types())
+	{
+	  gold_warning(_("ignoring --dedup-debug-types for an incremental "
+			 "link"));
+	  this->set_dedup_debug_types(false);
+	}
       if (strcmp(this->compress_debug_sections(), "none") != 0)
 	{
 	  gold_warning(_("ignoring --compress-debug-sections for an "
@@ -1368,6 +1374,24 @@ General_options::finalize()
 	}
     }
 
+  if (this->dedup_debug_types())
+    {
+      if (this->relocatable())
+	gold_fatal(_("--dedup-debug-types is not compatible with -r"));
+      if (this->emit_relocs())
+	gold_fatal(_("--dedup-debug-types is not compatible with "
+		     "--emit-relocs"));
+      if (this->gdb_index())
+	gold_fatal(_("--dedup-debug-types is not compatible with "
+		     "--gdb-index"));
+      if (strcmp(this->compress_debug_sections(), "none") != 0)
+	gold_fatal(_("--dedup-debug-types is not compatible with "
+		     "--compress-debug-sections"));
+      if (this->strip_debug_non_line())
+	gold_fatal(_("--dedup-debug-types is not compatible with "
+		     "--strip-debug-non-line"));
+    }
+
   // --rosegment-gap implies --rosegment.
   if (this->user_set_rosegment_gap())
     this->set_rosegment(true);
@@ -790,6 +790,11 @@ class General_options
 		N_("Turn on debugging"),
 		N_("[all,files,script,task][,...]"));
 
+  DEFINE_bool(dedup_debug_types, options::TWO_DASHES, '\0', false,
+	      N_("Replace duplicate debug type definitions with declarations "
+		 "(DWARF versions 2 to 4 only)"),
+	      N_("Do not replace duplicate debug type definitions (default)"));
+
   DEFINE_special(defsym, options::TWO_DASHES, '\0',
 		 N_("Define a symbol"), N_("SYMBOL=EXPRESSION"));
 
@@ -1137,6 +1142,10 @@ class General_options
 	      N_("Use posix_fallocate to reserve space in the output file"),
 	      N_("Use fallocate or ftruncate to reserve space"));
 
+  DEFINE_bool(prefault_output_file, options::TWO_DASHES, '\0', false,
+	      N_("Fault in the output file mapping before writing to it"),
+	      N_("Fault in the output file mapping as it is written (default)"));
+
   DEFINE_bool(preread_archive_symbols, options::TWO_DASHES, '\0', false,
 	      N_("Preread archive symbols when multi-threaded"), NULL);
 
@@ -1170,6 +1179,10 @@ class General_options
 
   // r
 
+  DEFINE_uint(readahead_inputs, options::TWO_DASHES, '\0', 0,
+	      N_("Read ahead input files with COUNT tasks (default 0, none)"),
+	      N_("COUNT"));
+
   DEFINE_bool(relocatable, options::EXACTLY_ONE_DASH, 'r', false,
 	      N_("Generate relocatable output"), NULL);
 
@@ -1225,6 +1238,10 @@ class General_options
   DEFINE_bool(secure_plt, options::TWO_DASHES , '\0', true,
 	      N_("(PowerPC only) Use new-style PLT"), NULL);
 
+  DEFINE_string(size_report, options::TWO_DASHES, '\0', NULL,
+		N_("Write a report attributing output size to inputs"),
+		N_("FILENAME"));
+
   DEFINE_optional_string(sort_common, options::TWO_DASHES, '\0', NULL,
 			 N_("Sort common symbols by alignment"),
 			 N_("[={ascending,descending}]"));
@@ -152,6 +152,39 @@ gold_fallocate(int o, off_t offset, off_t len)
   return 0;
 }
 
+// If --prefault-output-file is used, fault in the LEN bytes of the
+// output buffer at BASE for writing now, rather than one page at a
+// time as the output sections are written by several threads.  An
+// anonymous buffer is also backed with transparent huge pages if
+// possible.  A read fault is not enough for a shared file mapping,
+// since the first write to each page would still fault to make it
+// writable, so if the kernel does not support MADV_POPULATE_WRITE we
+// write to each page ourselves, storing back the byte already there.
+
+static void
+prefault_output_map(void* base, size_t len, bool is_anonymous)
+{
+  if (!parameters->options().prefault_output_file() || len == 0)
+    return;
+
+#ifdef MADV_HUGEPAGE
+  if (is_anonymous)
+    ::madvise(base, len, MADV_HUGEPAGE);
+#else
+  (void) is_anonymous;
+#endif
+
+#ifdef MADV_POPULATE_WRITE
+  if (::madvise(base, len, MADV_POPULATE_WRITE) == 0)
+    return;
+#endif
+
+  volatile unsigned char* p = static_cast<unsigned char*>(base);
+  size_t pagesize = getpagesize();
+  for (size_t off = 0; off < len; off += pagesize)
+    p[off] = p[off];
+}
+
 // Output_data variables.
 
 bool Output_data::allocated_sizes_are_fixed;
@@ -2570,6 +2603,7 @@ Output_section::add_input_section(Layout* layout,
       || this->may_sort_attached_input_sections()
       || this->must_sort_attached_input_sections()
       || parameters->options().user_set_Map()
+      || parameters->options().user_set_size_report()
       || parameters->target().may_relax()
       || layout->is_section_ordering_specified())
     {
@@ -5155,6 +5189,7 @@ Output_file::resize(off_t file_size)
 			  MREMAP_MAYMOVE);
 	  if (base == MAP_FAILED)
 	    gold_fatal(_("%s: mremap: %s"), this->name_, strerror(errno));
+	  prefault_output_map(base, file_size, true);
 	}
       else
 	{
@@ -5193,6 +5228,8 @@ Output_file::map_anonymous()
       memset(base, 0, this->file_size_);
       this->map_is_allocated_ = true;
     }
+  else
+    prefault_output_map(base, this->file_size_, true);
   this->base_ = static_cast<unsigned char*>(base);
   this->map_is_anonymous_ = true;
   return true;
@@ -5243,6 +5280,9 @@ Output_file::map_no_anonymous(bool writable)
   if (base == MAP_FAILED)
     return false;
 
+  if (writable)
+    prefault_output_map(base, this->file_size_, false);
+
   this->map_is_anonymous_ = false;
   this->base_ = static_cast<unsigned char*>(base);
   return true;
@@ -23,7 +23,10 @@
 #include "gold.h"
 
 #include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
 
+#include "filenames.h"
 #include "elfcpp.h"
 #include "options.h"
 #include "dirsearch.h"
@@ -943,4 +946,148 @@ Read_script::get_name() const
   return ret;
 }
 
+// Class Readahead_inputs.
+
+// Queue COUNT tasks which read ahead the input files in CMDLINE.  The
+// files are dealt out to the tasks in turn, so that the tasks work
+// through the command line together, in order.
+
+void
+Readahead_inputs::queue_tasks(Workqueue* workqueue, Dirsearch* dirpath,
+			      const Command_line& cmdline, unsigned int count)
+{
+  std::vector<const Input_file_argument*> files;
+  for (Command_line::const_iterator p = cmdline.begin();
+       p != cmdline.end();
+       ++p)
+    Readahead_inputs::add_files(&*p, &files);
+
+  if (count > files.size())
+    count = files.size();
+  if (count == 0)
+    return;
+
+  std::vector<Readahead_inputs*> tasks;
+  tasks.reserve(count);
+  for (unsigned int i = 0; i < count; ++i)
+    tasks.push_back(new Readahead_inputs(dirpath));
+  for (size_t i = 0; i < files.size(); ++i)
+    tasks[i % count]->files_.push_back(files[i]);
+  for (unsigned int i = 0; i < count; ++i)
+    workqueue->queue(tasks[i]);
+}
+
+// Add the files named by INPUT_ARGUMENT to FILES.
+
+void
+Readahead_inputs::add_files(const Input_argument* input_argument,
+			    std::vector<const Input_file_argument*>* files)
+{
+  if (input_argument->is_file())
+    files->push_back(&input_argument->file());
+  else if (input_argument->is_group())
+    {
+      const Input_file_group* group = input_argument->group();
+      for (Input_file_group::const_iterator p = group->begin();
+	   p != group->end();
+	   ++p)
+	Readahead_inputs::add_files(&*p, files);
+    }
+  else
+    {
+      gold_assert(input_argument->is_lib());
+      const Input_file_lib* lib = input_argument->lib();
+      for (Input_file_lib::const_iterator p = lib->begin();
+	   p != lib->end();
+	   ++p)
+	Readahead_inputs::add_files(&*p, files);
+    }
+}
+
+// We need the directory cache to find libraries.
+
+Task_token*
+Readahead_inputs::is_runnable()
+{
+  if (this->dirpath_->token()->is_blocked())
+    return this->dirpath_->token();
+  return NULL;
+}
+
+// We don't lock anything.
+
+void
+Readahead_inputs::locks(Task_locker*)
+{
+}
+
+// Find the file to read for FILE.  This follows Input_file::find_file,
+// except that it does not report errors, and it does not look in the
+// extra search path used for files named in linker scripts.
+
+bool
+Readahead_inputs::find(const Input_file_argument* file,
+		       std::string* name) const
+{
+  if (IS_ABSOLUTE_PATH(file->name())
+      || (!file->is_lib()
+	  && !file->is_searched_file()
+	  && file->extra_search_path() == NULL))
+    {
+      *name = file->name();
+      return true;
+    }
+
+  if (!file->is_lib() && !file->is_searched_file())
+    return false;
+
+  std::vector<std::string> names;
+  if (file->is_lib())
+    {
+      std::string prefix = "lib";
+      prefix += file->name();
+      if (parameters->options().is_static()
+	  || !file->options().Bdynamic())
+	names.push_back(prefix + ".a");
+      else
+	{
+	  names.push_back(prefix + ".so");
+	  names.push_back(prefix + ".a");
+	}
+    }
+  else
+    names.push_back(file->name());
+
+  bool is_in_sysroot;
+  int index = 0;
+  std::string found_name;
+  *name = this->dirpath_->find(names, &is_in_sysroot, &index, &found_name);
+  return !name->empty();
+}
+
+// Ask the kernel to read each file into the page cache.  This does
+// not wait for the reads to complete.  If we have no way to give the
+// advice, this does nothing.
+
+void
+Readahead_inputs::run(Workqueue*)
+{
+#ifdef HAVE_POSIX_FADVISE
+  for (std::vector<const Input_file_argument*>::const_iterator p =
+	 this->files_.begin();
+       p != this->files_.end();
+       ++p)
+    {
+      std::string name;
+      if (!this->find(*p, &name))
+	continue;
+      int o = ::open(name.c_str(), O_RDONLY);
+      if (o < 0)
+	continue;
+      ::posix_fadvise(o, 0, 0, POSIX_FADV_WILLNEED);
+      ::close(o);
+    }
+#endif
+}
+
 } // End namespace gold.
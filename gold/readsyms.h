@@ -486,6 +486,56 @@ class Read_script : public Task
   Task_token* next_blocker_;
 };
 
+// This Task asks the kernel to start reading input files named on the
+// command line into the page cache, so that the I/O for later files
+// overlaps with reading the symbols of earlier ones.  It only gives
+// advice: files it cannot find are skipped, and the Read_symbols
+// task for the file reports any error.
+
+class Readahead_inputs : public Task
+{
+ public:
+  Readahead_inputs(Dirsearch* dirpath)
+    : dirpath_(dirpath), files_()
+  { }
+
+  // Queue COUNT tasks which read ahead the input files in CMDLINE.
+  static void
+  queue_tasks(Workqueue*, Dirsearch*, const Command_line&,
+	      unsigned int count);
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const
+  { return "Readahead_inputs"; }
+
+ private:
+  // Add the files named by INPUT_ARGUMENT to the list of files to read
+  // ahead.
+  static void
+  add_files(const Input_argument* input_argument,
+	    std::vector<const Input_file_argument*>* files);
+
+  // Find the file to read for FILE.  Return false if it is not found.
+  bool
+  find(const Input_file_argument* file, std::string* name) const;
+
+  // The search path for libraries.
+  Dirsearch* dirpath_;
+  // The files this task reads ahead, in command line order.
+  std::vector<const Input_file_argument*> files_;
+};
+
 } // end namespace gold
 
 #endif // !defined(GOLD_READSYMS_H)
@@ -0,0 +1,438 @@
+// size_report.cc -- size attribution report for gold
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include "symtab.h"
+#include "object.h"
+#include "output.h"
+#include "merge.h"
+#include "layout.h"
+#include "gc.h"
+#include "icf.h"
+#include "size_report.h"
+
+// This file holds the code for writing the --size-report file.  The
+// report is a tab separated text file meant to be read by scripts.
+// Each line is a record with the following fields:
+//
+//   KIND  OUTPUT-SECTION  OFFSET  SIZE  FILE  MEMBER  SECTION  EXTRA
+//
+// KIND is one of:
+//   section  an output section; OFFSET is its address.
+//   input    an input section; OFFSET is relative to the output section.
+//   symbol   a global symbol; OFFSET is its value.  EXTRA is its name.
+//   linker   data created by the linker, such as the PLT.
+//   padding  alignment padding in front of the following record, or
+//            at the end of the output section.
+//   merge    merged SHF_MERGE data; EXTRA is the number of input bytes.
+//   icf      an input section folded by --icf; EXTRA names the kept
+//            section.
+//   gc       an input section removed by --gc-sections.
+//   discard  any other input section which was not included.
+//   total    a summary line; OUTPUT-SECTION names the category.
+// Fields which do not apply are written as "*".  Offsets and
+// addresses are written in hex, sizes in decimal.
+
+namespace gold
+{
+
+// Size_report constructor.
+
+Size_report::Size_report()
+  : file_(NULL), input_bytes_(0), linker_bytes_(0), padding_bytes_(0),
+    merge_saved_bytes_(0), icf_saved_bytes_(0), gc_removed_bytes_(0),
+    discarded_bytes_(0)
+{
+}
+
+// Size_report destructor.
+
+Size_report::~Size_report()
+{
+  if (this->file_ != NULL)
+    this->close();
+}
+
+// Open the report file.
+
+bool
+Size_report::open(const char* filename)
+{
+  if (strcmp(filename, "-") == 0)
+    this->file_ = stdout;
+  else
+    {
+      this->file_ = ::fopen(filename, "w");
+      if (this->file_ == NULL)
+	{
+	  gold_error(_("cannot open size report file %s: %s"), filename,
+		     strerror(errno));
+	  return false;
+	}
+    }
+  return true;
+}
+
+// Close the report file.
+
+void
+Size_report::close()
+{
+  if (fclose(this->file_) != 0)
+    gold_error(_("cannot close size report file: %s"), strerror(errno));
+  this->file_ = NULL;
+}
+
+// Write the whole report.  This is called single-threaded from
+// Layout_task_runner after the layout has been finalized.
+
+void
+Size_report::print(const Task* task, const Input_objects* input_objects,
+		   const Symbol_table* symtab, const Layout* layout)
+{
+  fprintf(this->file_, "# gold size report\n");
+  fprintf(this->file_,
+	  "# kind\toutput\toffset\tsize\tfile\tmember\tsection\textra\n");
+
+  this->bucket_section_symbols(input_objects);
+
+  const Layout::Section_list& sections(layout->section_list());
+  for (Layout::Section_list::const_iterator p = sections.begin();
+       p != sections.end();
+       ++p)
+    this->print_output_section(*p);
+
+  this->print_removed_sections(task, input_objects, symtab);
+
+  static const struct
+  {
+    const char* name;
+    uint64_t Size_report::* field;
+  } totals[] =
+  {
+    { "input", &Size_report::input_bytes_ },
+    { "linker", &Size_report::linker_bytes_ },
+    { "padding", &Size_report::padding_bytes_ },
+    { "merge-saved", &Size_report::merge_saved_bytes_ },
+    { "icf-saved", &Size_report::icf_saved_bytes_ },
+    { "gc-removed", &Size_report::gc_removed_bytes_ },
+    { "discarded", &Size_report::discarded_bytes_ },
+  };
+  for (size_t i = 0; i < sizeof totals / sizeof totals[0]; ++i)
+    fprintf(this->file_, "total\t%s\t*\t%llu\t*\t*\t*\t*\n",
+	    totals[i].name,
+	    static_cast<unsigned long long>(this->*totals[i].field));
+}
+
+// Sort the global symbols defined by each input object into the
+// sections that define them, so that printing an input section does
+// not have to look at every global symbol of its object.
+
+void
+Size_report::bucket_section_symbols(const Input_objects* input_objects)
+{
+  for (Input_objects::Relobj_iterator p = input_objects->relobj_begin();
+       p != input_objects->relobj_end();
+       ++p)
+    {
+      Relobj* relobj = *p;
+      const Object::Symbols* symbols = relobj->get_global_symbols();
+      if (symbols == NULL)
+	continue;
+      for (Object::Symbols::const_iterator q = symbols->begin();
+	   q != symbols->end();
+	   ++q)
+	{
+	  const Symbol* sym = *q;
+	  bool is_ordinary;
+	  if (sym == NULL
+	      || sym->source() != Symbol::FROM_OBJECT
+	      || sym->object() != relobj
+	      || !sym->is_defined())
+	    continue;
+	  unsigned int shndx = sym->shndx(&is_ordinary);
+	  if (!is_ordinary)
+	    continue;
+	  this->section_symbols_[Section_id(relobj, shndx)].push_back(sym);
+	}
+    }
+}
+
+// Print the file name and archive member name of RELOBJ.  For an
+// archive member the object name is "archive(member)".
+
+void
+Size_report::print_object_name(const Relobj* relobj)
+{
+  const std::string& name(relobj->name());
+  const Input_file* input_file = relobj->input_file();
+  if (input_file != NULL)
+    {
+      const std::string& filename(input_file->filename());
+      if (name.length() > filename.length() + 2
+	  && name.compare(0, filename.length(), filename) == 0
+	  && name[filename.length()] == '('
+	  && name[name.length() - 1] == ')')
+	{
+	  size_t len = name.length() - filename.length() - 2;
+	  fprintf(this->file_, "%s\t%s", filename.c_str(),
+		  name.substr(filename.length() + 1, len).c_str());
+	  return;
+	}
+    }
+  fprintf(this->file_, "%s\t*", name.c_str());
+}
+
+// Print an output section, the input sections and linker data it
+// contains, and the padding between them.
+
+void
+Size_report::print_output_section(const Output_section* os)
+{
+  uint64_t os_size = os->current_data_size();
+  fprintf(this->file_, "section\t%s\t0x%llx\t%llu\t*\t*\t*\t*\n",
+	  os->name(),
+	  static_cast<unsigned long long>(os->is_address_valid()
+					  ? os->address()
+					  : 0),
+	  static_cast<unsigned long long>(os_size));
+
+  // An output section without a list of input sections is made up
+  // entirely of data generated by the linker, such as the symbol
+  // table.
+  const Output_section::Input_section_list& input_sections(
+      os->input_sections());
+  if (input_sections.empty())
+    {
+      if (os_size > 0)
+	fprintf(this->file_, "linker\t%s\t0x0\t%llu\t*\t*\t*\t*\n",
+		os->name(), static_cast<unsigned long long>(os_size));
+      this->linker_bytes_ += os_size;
+      return;
+    }
+
+  // Walk the input sections in output order, recomputing the offset
+  // of each one the same way that Output_section::set_final_data_size
+  // does, so that we can attribute the alignment padding.
+  uint64_t off = 0;
+  for (Output_section::Input_section_list::const_iterator p =
+	 input_sections.begin();
+       p != input_sections.end();
+       ++p)
+    {
+      uint64_t start = align_address(off, p->addralign());
+      if (p->is_input_section())
+	{
+	  uint64_t o = p->relobj()->output_section_offset(p->shndx());
+	  if (o != -1ULL)
+	    start = o;
+	}
+      uint64_t size = p->current_data_size();
+
+      if (start > off)
+	{
+	  fprintf(this->file_, "padding\t%s\t0x%llx\t%llu\t*\t*\t*\t*\n",
+		  os->name(), static_cast<unsigned long long>(off),
+		  static_cast<unsigned long long>(start - off));
+	  this->padding_bytes_ += start - off;
+	}
+
+      if (p->is_input_section() || p->is_relaxed_input_section())
+	this->print_input_section(os, p->relobj(), p->shndx(), start, size);
+      else if (p->is_merge_section())
+	{
+	  uint64_t input_size = p->output_merge_base()->input_size();
+	  fprintf(this->file_, "merge\t%s\t0x%llx\t%llu\t*\t*\t*\t%llu\n",
+		  os->name(), static_cast<unsigned long long>(start),
+		  static_cast<unsigned long long>(size),
+		  static_cast<unsigned long long>(input_size));
+	  this->input_bytes_ += size;
+	  if (input_size > size)
+	    this->merge_saved_bytes_ += input_size - size;
+	}
+      else
+	{
+	  fprintf(this->file_, "linker\t%s\t0x%llx\t%llu\t*\t*\t*\t*\n",
+		  os->name(), static_cast<unsigned long long>(start),
+		  static_cast<unsigned long long>(size));
+	  this->linker_bytes_ += size;
+	}
+
+      off = start + size;
+    }
+
+  if (os_size > off)
+    {
+      fprintf(this->file_, "padding\t%s\t0x%llx\t%llu\t*\t*\t*\t*\n",
+	      os->name(), static_cast<unsigned long long>(off),
+	      static_cast<unsigned long long>(os_size - off));
+      this->padding_bytes_ += os_size - off;
+    }
+}
+
+// Print an input section included in the output section OS at OFFSET,
+// followed by the global symbols it defines.
+
+void
+Size_report::print_input_section(const Output_section* os, Relobj* relobj,
+				 unsigned int shndx, uint64_t offset,
+				 uint64_t size)
+{
+  fprintf(this->file_, "input\t%s\t0x%llx\t%llu\t", os->name(),
+	  static_cast<unsigned long long>(offset),
+	  static_cast<unsigned long long>(size));
+  this->print_object_name(relobj);
+  fprintf(this->file_, "\t%s\t*\n", relobj->section_name(shndx).c_str());
+  this->input_bytes_ += size;
+
+  switch (parameters->size_and_endianness())
+    {
+#ifdef HAVE_TARGET_32_LITTLE
+    case Parameters::TARGET_32_LITTLE:
+      this->print_input_section_symbols<32>(os, relobj, shndx);
+      break;
+#endif
+#ifdef HAVE_TARGET_32_BIG
+    case Parameters::TARGET_32_BIG:
+      this->print_input_section_symbols<32>(os, relobj, shndx);
+      break;
+#endif
+#ifdef HAVE_TARGET_64_LITTLE
+    case Parameters::TARGET_64_LITTLE:
+      this->print_input_section_symbols<64>(os, relobj, shndx);
+      break;
+#endif
+#ifdef HAVE_TARGET_64_BIG
+    case Parameters::TARGET_64_BIG:
+      this->print_input_section_symbols<64>(os, relobj, shndx);
+      break;
+#endif
+    default:
+      gold_unreachable();
+    }
+}
+
+// Print the global symbols defined in an input section.  This only
+// uses the virtual Relobj interface, since RELOBJ may come from an
+// incremental link rather than be a Sized_relobj_file.
+
+template<int size>
+void
+Size_report::print_input_section_symbols(const Output_section* os,
+					 Relobj* relobj, unsigned int shndx)
+{
+  Section_symbols::const_iterator p =
+    this->section_symbols_.find(Section_id(relobj, shndx));
+  if (p == this->section_symbols_.end())
+    return;
+  for (std::vector<const Symbol*>::const_iterator q = p->second.begin();
+       q != p->second.end();
+       ++q)
+    {
+      const Sized_symbol<size>* ssym =
+	static_cast<const Sized_symbol<size>*>(*q);
+      fprintf(this->file_, "symbol\t%s\t0x%llx\t%llu\t", os->name(),
+	      static_cast<unsigned long long>(ssym->value()),
+	      static_cast<unsigned long long>(ssym->symsize()));
+      this->print_object_name(relobj);
+      fprintf(this->file_, "\t%s\t%s\n",
+	      relobj->section_name(shndx).c_str(), ssym->name());
+    }
+}
+
+// Print the input sections which take up no space in the output
+// file, and record why they were removed.
+
+void
+Size_report::print_removed_sections(const Task* task,
+				    const Input_objects* input_objects,
+				    const Symbol_table* symtab)
+{
+  Garbage_collection* gc = symtab->gc();
+  Icf* icf = symtab->icf();
+
+  for (Input_objects::Relobj_iterator p = input_objects->relobj_begin();
+       p != input_objects->relobj_end();
+       ++p)
+    {
+      Relobj* relobj = *p;
+      Task_lock_obj<Object> tl(task, relobj);
+
+      unsigned int shnum = relobj->shnum();
+      for (unsigned int i = 1; i < shnum; ++i)
+	{
+	  unsigned int sh_type = relobj->section_type(i);
+	  if (sh_type != elfcpp::SHT_PROGBITS
+	      && sh_type != elfcpp::SHT_NOBITS
+	      && sh_type != elfcpp::SHT_NOTE
+	      && sh_type != elfcpp::SHT_INIT_ARRAY
+	      && sh_type != elfcpp::SHT_FINI_ARRAY
+	      && sh_type != elfcpp::SHT_PREINIT_ARRAY)
+	    continue;
+	  if (relobj->is_section_included(i))
+	    continue;
+
+	  section_size_type size;
+	  if (!relobj->section_is_compressed(i, &size))
+	    size = relobj->section_size(i);
+	  if (size == 0)
+	    continue;
+
+	  bool is_alloc = (relobj->section_flags(i) & elfcpp::SHF_ALLOC) != 0;
+	  const char* kind;
+	  if (is_alloc && icf != NULL && icf->is_section_folded(relobj, i))
+	    {
+	      kind = "icf";
+	      this->icf_saved_bytes_ += size;
+	    }
+	  else if (is_alloc && gc != NULL && gc->is_section_garbage(relobj, i))
+	    {
+	      kind = "gc";
+	      this->gc_removed_bytes_ += size;
+	    }
+	  else
+	    {
+	      kind = "discard";
+	      this->discarded_bytes_ += size;
+	    }
+
+	  fprintf(this->file_, "%s\t*\t*\t%llu\t", kind,
+		  static_cast<unsigned long long>(size));
+	  this->print_object_name(relobj);
+	  fprintf(this->file_, "\t%s\t", relobj->section_name(i).c_str());
+	  if (strcmp(kind, "icf") == 0)
+	    {
+	      Section_id kept = icf->get_folded_section(relobj, i);
+	      fprintf(this->file_, "%s:%s\n", kept.first->name().c_str(),
+		      kept.first->section_name(kept.second).c_str());
+	    }
+	  else
+	    fprintf(this->file_, "*\n");
+	}
+    }
+}
+
+} // End namespace gold.
@@ -0,0 +1,125 @@
+// size_report.h -- size attribution report for gold   -*- C++ -*-
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#ifndef GOLD_SIZE_REPORT_H
+#define GOLD_SIZE_REPORT_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "object.h"
+
+namespace gold
+{
+
+class Task;
+class Input_objects;
+class Symbol;
+class Symbol_table;
+class Layout;
+class Output_section;
+
+// This class writes the report requested by --size-report.  The
+// report attributes every byte of the output file to an input object,
+// archive member, input section and symbol, and records the bytes
+// that the linker saved by merging strings and constants, by identical
+// code folding, and by garbage collection.  The report is written in
+// one pass over the output sections after Layout::finalize, when all
+// sizes and offsets are known.
+
+class Size_report
+{
+ public:
+  Size_report();
+
+  ~Size_report();
+
+  // Open the report file.  Return whether the open succeeded.
+  bool
+  open(const char* filename);
+
+  // Close the report file.
+  void
+  close();
+
+  // Write the report.  TASK is used to lock the input objects.
+  void
+  print(const Task*, const Input_objects*, const Symbol_table*,
+	const Layout*);
+
+ private:
+  // The global symbols defined in each input section, in the order
+  // in which they appear in the symbol table of their object.
+  typedef Unordered_map<Section_id, std::vector<const Symbol*>,
+			Section_id_hash> Section_symbols;
+
+  // Sort the global symbols of the input objects by section.
+  void
+  bucket_section_symbols(const Input_objects*);
+
+  // Print an output section and everything in it.
+  void
+  print_output_section(const Output_section*);
+
+  // Print an input section which was included in the link.
+  void
+  print_input_section(const Output_section*, Relobj*, unsigned int shndx,
+		      uint64_t offset, uint64_t size);
+
+  // Print the symbols defined in an input section.
+  template<int size>
+  void
+  print_input_section_symbols(const Output_section*, Relobj*,
+			      unsigned int shndx);
+
+  // Print the input sections which were removed from the link.
+  void
+  print_removed_sections(const Task*, const Input_objects*,
+			 const Symbol_table*);
+
+  // Print the name of RELOBJ as a file and archive member pair.
+  void
+  print_object_name(const Relobj*);
+
+  // Report file to write to.
+  FILE* file_;
+  // The global symbols of each input section.
+  Section_symbols section_symbols_;
+  // Bytes taken up by input sections.
+  uint64_t input_bytes_;
+  // Bytes taken up by linker generated data.
+  uint64_t linker_bytes_;
+  // Bytes of alignment padding between and after input sections.
+  uint64_t padding_bytes_;
+  // Bytes saved by merging SHF_MERGE sections.
+  uint64_t merge_saved_bytes_;
+  // Bytes saved by identical code folding.
+  uint64_t icf_saved_bytes_;
+  // Bytes removed by garbage collection.
+  uint64_t gc_removed_bytes_;
+  // Bytes in other discarded sections, such as duplicate COMDAT groups.
+  uint64_t discarded_bytes_;
+};
+
+} // End namespace gold.
+
+#endif // !defined(GOLD_SIZE_REPORT_H)
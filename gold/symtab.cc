@@ -59,7 +59,9 @@ Symbol::init_fields(const char* name, const char* version,
   this->version_ = version;
   this->symtab_index_ = 0;
   this->dynsym_index_ = 0;
-  this->got_offsets_.init();
+  this->got_offset_ = -1U;
+  this->got_type_ = 0;
+  this->has_more_got_offsets_ = false;
   this->plt_offset_ = -1U;
   this->type_ = type;
   this->binding_ = binding;
@@ -84,6 +86,68 @@ Symbol::init_fields(const char* name, const char* version,
   this->non_zero_localentry_ = false;
 }
 
+// The GOT entries of the symbols which have more than one, or whose
+// GOT type is too large for Symbol::got_type_, other than the one
+// stored in the symbol itself.
+
+typedef Unordered_map<const Symbol*, Got_offset_list> More_got_offsets;
+static More_got_offsets more_got_offsets;
+
+// A lock for more_got_offsets.
+static Lock* more_got_offsets_lock = NULL;
+static Initialize_lock more_got_offsets_initialize_lock(&more_got_offsets_lock);
+
+// Look up a GOT offset in the table of additional GOT entries.
+
+unsigned int
+Symbol::find_more_got_offset(unsigned int got_type) const
+{
+  more_got_offsets_initialize_lock.initialize();
+  Hold_optional_lock hl(more_got_offsets_lock);
+  More_got_offsets::const_iterator p = more_got_offsets.find(this);
+  gold_assert(p != more_got_offsets.end());
+  return p->second.get_offset(got_type);
+}
+
+// Add a GOT offset to the table of additional GOT entries.
+
+void
+Symbol::set_more_got_offset(unsigned int got_type, unsigned int got_offset)
+{
+  more_got_offsets_initialize_lock.initialize();
+  Hold_optional_lock hl(more_got_offsets_lock);
+  more_got_offsets[this].set_offset(got_type, got_offset);
+  this->has_more_got_offsets_ = true;
+}
+
+// Call V for each GOT entry of this symbol.
+
+void
+Symbol::for_all_got_offsets(Got_offset_list::Visitor* v) const
+{
+  if (this->got_offset_ != -1U)
+    v->visit(this->got_type_, this->got_offset_);
+  if (this->has_more_got_offsets_)
+    {
+      more_got_offsets_initialize_lock.initialize();
+      Hold_optional_lock hl(more_got_offsets_lock);
+      More_got_offsets::const_iterator p = more_got_offsets.find(this);
+      gold_assert(p != more_got_offsets.end());
+      p->second.for_all_got_offsets(v);
+    }
+}
+
+// Return the number of symbols with GOT entries in the table of
+// additional GOT entries.
+
+size_t
+Symbol::more_got_offsets_count()
+{
+  more_got_offsets_initialize_lock.initialize();
+  Hold_optional_lock hl(more_got_offsets_lock);
+  return more_got_offsets.size();
+}
+
 // Return the demangled version of the symbol's name, but only
 // if the --demangle flag was set.
 
@@ -3469,6 +3533,42 @@ Symbol_table::print_stats() const
 	  program_name, this->table_.size());
 #endif
   this->namepool_.print_stats("symbol table stringpool");
+
+  // Break down the memory used for the global symbols.  This does not
+  // count the extra fields of target specific symbol classes.
+  size_t symbol_size = 0;
+  switch (parameters->target().get_size())
+    {
+    case 32:
+      symbol_size = sizeof(Sized_symbol<32>);
+      break;
+    case 64:
+      symbol_size = sizeof(Sized_symbol<64>);
+      break;
+    default:
+      gold_unreachable();
+    }
+  size_t symbol_count = this->table_.size();
+  fprintf(stderr, _("%s: symbol table symbol size: %zu; symbol bytes: %llu\n"),
+	  program_name, symbol_size,
+	  static_cast<unsigned long long>(symbol_count) * symbol_size);
+
+  // Each hash table node holds the key and value and a pointer to the
+  // next node.
+  unsigned long long table_bytes =
+    (static_cast<unsigned long long>(symbol_count)
+     * (sizeof(Symbol_table_type::value_type) + sizeof(void*)));
+#if defined(HAVE_TR1_UNORDERED_MAP) || defined(HAVE_EXT_HASH_MAP)
+  table_bytes += (static_cast<unsigned long long>(this->table_.bucket_count())
+		  * sizeof(void*));
+#endif
+  fprintf(stderr, _("%s: symbol table hash table bytes: %llu\n"),
+	  program_name, table_bytes);
+
+  fprintf(stderr, _("%s: symbol table forwarders: %zu; weak aliases: %zu\n"),
+	  program_name, this->forwarders_.size(), this->weak_aliases_.size());
+  fprintf(stderr, _("%s: symbols with additional GOT entries: %zu\n"),
+	  program_name, Symbol::more_got_offsets_count());
 }
 
 // We check for ODR violations by looking for symbols with the same
@@ -429,26 +429,46 @@ class Symbol
   // For a TLS symbol, this GOT entry will hold its tp-relative offset.
   bool
   has_got_offset(unsigned int got_type) const
-  { return this->got_offsets_.get_offset(got_type) != -1U; }
+  { return this->find_got_offset(got_type) != -1U; }
 
   // Return the offset into the GOT section of this symbol.
   unsigned int
   got_offset(unsigned int got_type) const
   {
-    unsigned int got_offset = this->got_offsets_.get_offset(got_type);
+    unsigned int got_offset = this->find_got_offset(got_type);
     gold_assert(got_offset != -1U);
     return got_offset;
   }
 
-  // Set the GOT offset of this symbol.
+  // Set the GOT offset of this symbol.  GOT types too large for
+  // got_type_, such as the MIPS multi-GOT ones, always go to the
+  // table of additional GOT entries.
   void
   set_got_offset(unsigned int got_type, unsigned int got_offset)
-  { this->got_offsets_.set_offset(got_type, got_offset); }
+  {
+    if (got_type <= max_inline_got_type
+	&& (this->got_offset_ == -1U || this->got_type_ == got_type))
+      {
+	this->got_type_ = got_type;
+	this->got_offset_ = got_offset;
+      }
+    else
+      this->set_more_got_offset(got_type, got_offset);
+  }
+
+  // Return whether this symbol has any entries in the GOT section.
+  bool
+  has_got_offsets() const
+  { return this->got_offset_ != -1U || this->has_more_got_offsets_; }
+
+  // Call V for each GOT entry of this symbol.
+  void
+  for_all_got_offsets(Got_offset_list::Visitor* v) const;
 
-  // Return the GOT offset list.
-  const Got_offset_list*
-  got_offset_list() const
-  { return this->got_offsets_.get_list(); }
+  // Return the number of symbols with GOT entries in the table of
+  // additional GOT entries.  This is used for --stats.
+  static size_t
+  more_got_offsets_count();
 
   // Return whether this symbol has an entry in the PLT section.
   bool
@@ -982,6 +1002,32 @@ class Symbol
   Symbol(const Symbol&);
   Symbol& operator=(const Symbol&);
 
+  // The largest GOT type which can be stored in got_type_.
+  static const unsigned int max_inline_got_type = 0xff;
+
+  // Return the GOT offset of type GOT_TYPE, or -1U if there is none.
+  unsigned int
+  find_got_offset(unsigned int got_type) const
+  {
+    if (this->got_offset_ != -1U && this->got_type_ == got_type)
+      return this->got_offset_;
+    if (!this->has_more_got_offsets_)
+      return -1U;
+    return this->find_more_got_offset(got_type);
+  }
+
+  // Look up a GOT offset in the table of additional GOT entries.
+  unsigned int
+  find_more_got_offset(unsigned int got_type) const;
+
+  // Add a GOT offset to the table of additional GOT entries.
+  void
+  set_more_got_offset(unsigned int got_type, unsigned int got_offset);
+
+  // The fields are ordered so that the ones used when resolving
+  // symbols come first, and so that there is no padding between them
+  // on a 64-bit host.
+
   // Symbol name (expected to point into a Stringpool).
   const char* name_;
   // Symbol version (expected to point into a Stringpool).  This may
@@ -1023,28 +1069,6 @@ class Symbol
     Segment_offset_base offset_base;
   } u2_;
 
-  // The index of this symbol in the output file.  If the symbol is
-  // not going into the output file, this value is -1U.  This field
-  // starts as always holding zero.  It is set to a non-zero value by
-  // Symbol_table::finalize.
-  unsigned int symtab_index_;
-
-  // The index of this symbol in the dynamic symbol table.  If the
-  // symbol is not going into the dynamic symbol table, this value is
-  // -1U.  This field starts as always holding zero.  It is set to a
-  // non-zero value during Layout::finalize.
-  unsigned int dynsym_index_;
-
-  // If this symbol has an entry in the PLT section, then this is the
-  // offset from the start of the PLT section.  This is -1U if there
-  // is no PLT entry.
-  unsigned int plt_offset_;
-
-  // The GOT section entries for this symbol.  A symbol may have more
-  // than one GOT offset (e.g., when mixing modules compiled with two
-  // different TLS models), but will usually have at most one.
-  Got_offset_list got_offsets_;
-
   // Symbol type (bits 0 to 3).
   elfcpp::STT type_ : 4;
   // Symbol binding (bits 4 to 7).
@@ -1113,6 +1137,35 @@ class Symbol
   bool is_protected_  : 1;
   // Used by PowerPC64 ELFv2 to track st_other localentry (bit 36).
   bool non_zero_localentry_ : 1;
+  // True if there are GOT entries for this symbol in the table of
+  // additional GOT entries, besides any at got_offset_ (bit 37).
+  bool has_more_got_offsets_ : 1;
+  // The GOT type of the entry at got_offset_ (bits 38 to 45).
+  unsigned int got_type_ : 8;
+
+  // The index of this symbol in the output file.  If the symbol is
+  // not going into the output file, this value is -1U.  This field
+  // starts as always holding zero.  It is set to a non-zero value by
+  // Symbol_table::finalize.
+  unsigned int symtab_index_;
+
+  // The index of this symbol in the dynamic symbol table.  If the
+  // symbol is not going into the dynamic symbol table, this value is
+  // -1U.  This field starts as always holding zero.  It is set to a
+  // non-zero value during Layout::finalize.
+  unsigned int dynsym_index_;
+
+  // If this symbol has an entry in the PLT section, then this is the
+  // offset from the start of the PLT section.  This is -1U if there
+  // is no PLT entry.
+  unsigned int plt_offset_;
+
+  // The offset of the first GOT section entry for this symbol, or -1U
+  // if there is none.  A symbol may have more than one GOT offset
+  // (e.g., when mixing modules compiled with two different TLS
+  // models), but will usually have at most one.  The others are
+  // kept in a separate table, so that they take no space here.
+  unsigned int got_offset_;
 };
 
 // The parts of a symbol which are size specific.  Using a template
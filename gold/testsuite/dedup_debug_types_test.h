@@ -0,0 +1,55 @@
+// dedup_debug_types_test.h -- a test case for gold   -*- C++ -*-
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// The types in this header are defined in both compilation units of
+// the test.
+
+namespace dedup_test
+{
+
+struct Dedup_point
+{
+  int x;
+  int y;
+  Dedup_point* next;
+};
+
+enum Dedup_color
+{
+  DEDUP_RED,
+  DEDUP_GREEN
+};
+
+class Dedup_shape
+{
+ public:
+  Dedup_point origin;
+  Dedup_color color;
+  int area() const;
+};
+
+} // End namespace dedup_test.
+
+int
+dedup_test_1(dedup_test::Dedup_shape*);
+
+int
+dedup_test_2(dedup_test::Dedup_shape*);
@@ -0,0 +1,77 @@
+#!/bin/sh
+
+# dedup_debug_types_test.sh -- test --dedup-debug-types
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The goal of this program is to verify that --dedup-debug-types
+# keeps one definition of each type shared by the two compilation
+# units, and replaces the other with a declaration, leaving .debug_info
+# which readelf reads without complaint.  With DWARF 5, which is not
+# supported, the linker should warn once and keep both definitions.
+# Files dedup_debug_types_test_1.cc and dedup_debug_types_test_2.cc
+# are in this test.
+
+set -e
+
+check_count()
+{
+    count=`grep -A1 "DW_AT_name .*: $2\$" "$1" | grep -c "$3" || true`
+    if test "$count" != "$4"
+    then
+	echo "Expected $4 $2 DIEs with $3 in $1, found $count"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+# Each type is named once in each compilation unit, and exactly one of
+# the two is a declaration.
+for type in Dedup_point Dedup_color Dedup_shape
+do
+    check_count dedup_debug_types_test.stdout $type DW_AT_name 2
+    check_count dedup_debug_types_test.stdout $type DW_AT_declaration 1
+done
+
+if test -s dedup_debug_types_test.err
+then
+    echo "readelf reported problems in the rewritten .debug_info:"
+    cat dedup_debug_types_test.err
+    exit 1
+fi
+
+# The DWARF 5 compilation units are left alone.
+for type in Dedup_point Dedup_color Dedup_shape
+do
+    check_count dedup_debug_types_dwarf5_test.stdout $type DW_AT_name 2
+    check_count dedup_debug_types_dwarf5_test.stdout $type DW_AT_declaration 0
+done
+
+count=`grep -c "not removing duplicate debug types" dedup_debug_types_dwarf5_test.err || true`
+if test "$count" != "1"
+then
+    echo "Expected one warning in dedup_debug_types_dwarf5_test.err, found $count"
+    cat dedup_debug_types_dwarf5_test.err
+    exit 1
+fi
+
+exit 0
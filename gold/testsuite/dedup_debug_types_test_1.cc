@@ -0,0 +1,50 @@
+// dedup_debug_types_test_1.cc -- a test case for gold
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// The goal of this program is to verify that --dedup-debug-types
+// replaces the duplicate definitions of the types in
+// dedup_debug_types_test.h with declarations.  This file is compiled
+// first, so it keeps the definitions.
+
+#include "dedup_debug_types_test.h"
+
+int
+dedup_test::Dedup_shape::area() const
+{
+  return this->origin.x * this->origin.y;
+}
+
+int
+dedup_test_1(dedup_test::Dedup_shape* shape)
+{
+  return shape->origin.next == 0 ? shape->area() : 0;
+}
+
+int
+main()
+{
+  dedup_test::Dedup_shape shape;
+  shape.origin.x = 2;
+  shape.origin.y = 3;
+  shape.origin.next = 0;
+  shape.color = dedup_test::DEDUP_GREEN;
+  return dedup_test_1(&shape) + dedup_test_2(&shape) == 12 ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+// got_offset_unittest.cc -- test the GOT offsets of a Symbol.
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include "symtab.h"
+
+#include "test.h"
+
+namespace gold_testsuite
+{
+
+using namespace gold;
+
+// A Symbol which can be created without a symbol table.
+
+class Got_test_symbol : public Symbol
+{
+ public:
+  Got_test_symbol()
+  {
+    this->init_fields("sym", NULL, elfcpp::STT_OBJECT, elfcpp::STB_GLOBAL,
+		      elfcpp::STV_DEFAULT, 0);
+  }
+};
+
+// Add up the GOT types and offsets of a symbol.
+
+class Got_sum : public Got_offset_list::Visitor
+{
+ public:
+  Got_sum()
+    : count(0), types(0), offsets(0)
+  { }
+
+  void
+  visit(unsigned int got_type, unsigned int got_offset)
+  {
+    ++this->count;
+    this->types += got_type;
+    this->offsets += got_offset;
+  }
+
+  unsigned int count;
+  unsigned int types;
+  unsigned int offsets;
+};
+
+bool
+Got_offset_test(Test_report*)
+{
+  // GOT types which fit in the symbol itself.
+  Got_test_symbol small;
+  CHECK(!small.has_got_offsets());
+  small.set_got_offset(0, 8);
+  small.set_got_offset(3, 16);
+  small.set_got_offset(0, 24);
+  CHECK(small.has_got_offsets());
+  CHECK(small.got_offset(0) == 24);
+  CHECK(small.got_offset(3) == 16);
+  CHECK(!small.has_got_offset(1));
+
+  // The MIPS multi-GOT types are much larger than 255, and may be the
+  // first GOT type a symbol gets.
+  Got_test_symbol large;
+  large.set_got_offset(1027, 32);
+  CHECK(large.has_got_offsets());
+  CHECK(large.has_got_offset(1027));
+  CHECK(!large.has_got_offset(1027 & 0xff));
+  CHECK(large.got_offset(1027) == 32);
+  large.set_got_offset(1, 40);
+  large.set_got_offset(2051, 48);
+  large.set_got_offset(1027, 56);
+  CHECK(large.got_offset(1) == 40);
+  CHECK(large.got_offset(1027) == 56);
+  CHECK(large.got_offset(2051) == 48);
+
+  Got_sum sum;
+  large.for_all_got_offsets(&sum);
+  CHECK(sum.count == 3);
+  CHECK(sum.types == 1 + 1027 + 2051);
+  CHECK(sum.offsets == 40 + 48 + 56);
+
+  return true;
+}
+
+Register_test got_offset_register("Got_offset", Got_offset_test);
+
+} // End namespace gold_testsuite.
@@ -0,0 +1,46 @@
+#!/bin/sh
+
+# prefault_output_test.sh -- test --prefault-output-file
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The goal of this program is to verify that --prefault-output-file
+# does not change the output file, whether the output is mapped from
+# the file or written through an anonymous buffer with
+# --no-mmap-output-file.  File basic_test.cc is in this test.
+
+set -e
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$2 differs from $1"
+	exit 1
+    fi
+}
+
+check_same prefault_output_test prefault_output_test_1
+check_same prefault_output_test prefault_output_test_2
+
+./prefault_output_test_1 > /dev/null
+./prefault_output_test_2 > /dev/null
+
+exit 0
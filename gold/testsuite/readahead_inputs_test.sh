@@ -0,0 +1,60 @@
+#!/bin/sh
+
+# readahead_inputs_test.sh -- test --readahead-inputs
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The goal of this program is to verify that --readahead-inputs does
+# not change the output file when the link reads an archive, and that
+# a missing input file is reported the same way as without the
+# option.  Files two_file_test_main.cc, two_file_test_1.cc,
+# two_file_test_1b.cc and two_file_test_2.cc are in this test.
+
+set -e
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$2 differs from $1"
+	exit 1
+    fi
+}
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected error in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_same readahead_inputs_test readahead_inputs_test_1
+./readahead_inputs_test_1
+
+check readahead_inputs_missing.err "readahead_inputs_missing\.o: .*No such file"
+check readahead_inputs_missing_1.err "readahead_inputs_missing\.o: .*No such file"
+
+exit 0
@@ -0,0 +1,56 @@
+// size_report_test.cc -- a test case for gold
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// The goal of this program is to verify that --size-report accounts
+// for sections folded by --icf, sections removed by --gc-sections and
+// merged strings.  folded_func must be folded into kept_func, and
+// unused_func must be removed.
+
+#include <cstring>
+
+int
+kept_func(int i)
+{
+  return i * 3 + 1;
+}
+
+int
+folded_func(int i)
+{
+  return i * 3 + 1;
+}
+
+int
+unused_func(int i)
+{
+  return i * 7 - 2;
+}
+
+const char* str1 = "size report string";
+const char* str2 = "size report string";
+
+int
+main()
+{
+  if (strcmp(str1, str2) != 0)
+    return 1;
+  return kept_func(1) == folded_func(1) ? 0 : 1;
+}
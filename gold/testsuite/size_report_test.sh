@@ -0,0 +1,51 @@
+#!/bin/sh
+
+# size_report_test.sh -- test --size-report
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The goal of this program is to verify that --size-report attributes
+# the output to input sections and symbols, and records the sections
+# removed by --icf and --gc-sections.  File size_report_test.cc is in
+# this test.
+
+set -e
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected record in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check size_report_test.report "^section	\.text	"
+check size_report_test.report "^input	\.text	.*size_report_test\.o	\*	\.text\._Z9kept_funci	"
+check size_report_test.report "^symbol	\.text	.*size_report_test\.o	\*	\.text\.main	main$"
+check size_report_test.report "^icf	.*	\.text\._Z11folded_funci	.*:\.text\._Z9kept_funci$"
+check size_report_test.report "^gc	.*	\.text\._Z11unused_funci	"
+check size_report_test.report "^merge	\.rodata	"
+check size_report_test.report "^total	icf-saved	\*	[1-9]"
+check size_report_test.report "^total	gc-removed	\*	[1-9]"
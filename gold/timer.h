@@ -29,7 +29,7 @@ namespace gold
 class Timer
 {
  public:
-  // Used to report time statistics. All fields are in milliseconds.
+  // Used to report time statistics.  The times are in milliseconds.
   struct TimeStats
   {
     /* User time in this process.  */
@@ -40,6 +40,12 @@ class Timer
 
     /* Wall clock time.  */
     long wall;
+
+    /* Page faults which did not require I/O.  */
+    long minor_faults;
+
+    /* Page faults which required I/O.  */
+    long major_faults;
   };
 
   Timer();